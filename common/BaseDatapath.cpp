@@ -6,6 +6,8 @@
 #include "BaseDatapath.h"
 #include "ExecNode.h"
 #include "DatabaseDeps.h"
+#include "GraphExporter.h"
+#include "ScheduleSnapshot.h"
 #include "graph_opts/all_graph_opts.h"
 
 using namespace SrcTypes;
@@ -13,10 +15,19 @@ using namespace SrcTypes;
 BaseDatapath::BaseDatapath(std::string& bench,
                            std::string& trace_file_name,
                            std::string& config_file)
-    : benchName(bench), current_trace_off(0) {
+    : benchName(bench), program_key(0), stage_key(0),
+      pending_program(nullptr), profiler(bench), num_snapshots(0),
+      quiet(false), checkpoint_interval(0), num_invocations(0),
+      resume_invocation(0), current_trace_off(0) {
   parse_config(benchName, config_file);
 
   use_db = false;
+  if (trace_file_name.empty()) {
+    // Keep the results of the simulation the snapshot was taken from.
+    trace_file = nullptr;
+    trace_size = 0;
+    return;
+  }
   if (!fileExists(trace_file_name)) {
     std::cerr << "-------------------------------" << std::endl;
     std::cerr << " ERROR: Input Trace Not Found  " << std::endl;
@@ -30,6 +41,9 @@ BaseDatapath::BaseDatapath(std::string& bench,
   /* Remove the old file. */
   if (access(file_name.c_str(), F_OK) != -1 && remove(file_name.c_str()) != 0)
     perror("Failed to delete the old summary file");
+  file_name = benchName + "_estimate";
+  if (access(file_name.c_str(), F_OK) != -1 && remove(file_name.c_str()) != 0)
+    perror("Failed to delete the old estimate file");
 
   struct stat st;
   stat(trace_file_name.c_str(), &st);
@@ -38,10 +52,20 @@ BaseDatapath::BaseDatapath(std::string& bench,
 }
 
 BaseDatapath::~BaseDatapath() {
-  gzclose(trace_file);
+  if (trace_file)
+    gzclose(trace_file);
+}
+
+void BaseDatapath::loadSnapshot(const std::string& file_name) {
+  ScheduleSnapshot snapshot;
+  snapshot.open(file_name);
+  snapshot.restore(program, srcManager);
+  num_cycles = snapshot.getNumCycles();
 }
 
 bool BaseDatapath::buildDddg() {
+  profiler.startInvocation();
+  Profiler::Phase phase(profiler, "buildDddg");
   DDDG* dddg;
   dddg = new DDDG(this, &program, trace_file);
   /* Build initial DDDG. */
@@ -52,8 +76,11 @@ bool BaseDatapath::buildDddg() {
   topLevelFunctionName = dddg->get_top_level_function_name();
   delete dddg;
 
-  if (current_trace_off == DDDG::END_OF_TRACE)
+  if (current_trace_off == DDDG::END_OF_TRACE) {
+    phase.discard();
     return false;
+  }
+  phase.setWork(program.nodes.size(), boost::num_edges(program.graph));
 
   std::cout << "-------------------------------" << std::endl;
   std::cout << "    Initializing BaseDatapath      " << std::endl;
@@ -65,6 +92,12 @@ bool BaseDatapath::buildDddg() {
 
   program.createVertexMap();
 
+  // The trace offset identifies the invocation this program was built from.
+  program_key = boost::hash_value(current_trace_off);
+  stage_key = program_key;
+  pending_program = nullptr;
+
+  num_invocations++;
   num_cycles = 0;
   upsampled = false;
   return true;
@@ -72,6 +105,29 @@ bool BaseDatapath::buildDddg() {
 
 void BaseDatapath::resetTrace() { gzseek(trace_file, 0, SEEK_SET); }
 
+void BaseDatapath::adoptProgram(BaseDatapath& other) {
+  assert(!other.pending_program &&
+         "The program of the other datapath has not been restored yet.");
+  schedule_phase.reset();
+  profiler.startInvocation();
+  program.swap(other.program);
+  // The label maps are only read once per trace, so @other still needs them
+  // for the invocations it builds next.
+  other.program.labelmap = program.labelmap;
+  other.program.inline_labelmap = program.inline_labelmap;
+  user_params = other.user_params;
+  functionNames.swap(other.functionNames);
+  topLevelFunctionName = other.topLevelFunctionName;
+  numTotalNodes = other.numTotalNodes;
+  beginNodeId = other.beginNodeId;
+  endNodeId = other.endNodeId;
+  program_key = other.program_key;
+  stage_key = other.stage_key;
+  pending_program = nullptr;
+  num_cycles = 0;
+  upsampled = false;
+}
+
 void BaseDatapath::updateUnrollingPipeliningWithLabelInfo() {
   // The config file is parsed before the trace, so we don't have line number
   // information yet. After parsing the trace, update the unrolling and
@@ -112,13 +168,50 @@ void BaseDatapath::updateUnrollingPipeliningWithLabelInfo() {
 }
 
 void BaseDatapath::clearDatapath() {
+  schedule_phase.reset();
   program.clear();
   clearFunctionName();
   clearArrayBaseAddress();
   clearRegStats();
 }
 
+void BaseDatapath::reconfigure(const Program& prog,
+                               const UserConfigParams& params,
+                               const ProgramInfo& info) {
+  schedule_phase.reset();
+  Profiler::Phase phase(profiler, "reconfigure");
+  program.copyFrom(prog);
+  user_params = params;
+  program_key = info.key;
+  topLevelFunctionName = info.top_level_function;
+  functionNames = info.function_names;
+  for (auto& base : info.array_base_addresses)
+    addArrayBaseAddress(base.first, base.second);
+  stage_key = program_key;
+  pending_program = nullptr;
+  registers.clear();
+  clearRegStats();
+  executingQueue.clear();
+  readyToExecuteQueue.clear();
+  num_cycles = 0;
+  upsampled_cycles = 0;
+  upsampled = false;
+}
+
+ProgramInfo BaseDatapath::getProgramInfo() const {
+  ProgramInfo info;
+  info.key = program_key;
+  info.top_level_function = topLevelFunctionName;
+  info.function_names = functionNames;
+  for (auto& part : user_params.partition) {
+    if (part.second.base_addr != 0)
+      info.array_base_addresses[part.first] = part.second.base_addr;
+  }
+  return info;
+}
+
 void BaseDatapath::initBaseAddress() {
+  Profiler::Phase phase(profiler, "BaseAddressInit");
   auto opt = getGraphOpt<BaseAddressInit>();
   opt->run();
 #if 0
@@ -131,90 +224,346 @@ void BaseDatapath::initBaseAddress() {
 }
 
 void BaseDatapath::initDmaBaseAddress() {
+  Profiler::Phase phase(profiler, "DmaBaseAddressInit");
   auto opt = getGraphOpt<DmaBaseAddressInit>();
   opt->run();
 }
 
 void BaseDatapath::memoryAmbiguation() {
-  auto opt = getGraphOpt<MemoryAmbiguationOpt>();
-  opt->run();
+  runGraphOpt<MemoryAmbiguationOpt>("MemoryAmbiguationOpt");
 }
 
-void BaseDatapath::removePhiNodes() {
-  auto opt = getGraphOpt<PhiNodeRemoval>();
-  opt->run();
+void BaseDatapath::removeDeadNodes() {
+  runGraphOpt<DeadNodeRemoval>("DeadNodeRemoval");
 }
 
 void BaseDatapath::loopFlatten() {
-  auto opt = getGraphOpt<LoopFlattening>();
-  opt->run();
-}
-
-void BaseDatapath::removeInductionDependence() {
-  auto opt = getGraphOpt<InductionDependenceRemoval>();
-  opt->run();
+  runGraphOpt<LoopFlattening>("LoopFlattening");
 }
 
 void BaseDatapath::loopPipelining() {
-  auto opt = getGraphOpt<GlobalLoopPipelining>();
-  opt->run();
+  runGraphOpt<GlobalLoopPipelining>("GlobalLoopPipelining");
 }
 
 void BaseDatapath::perLoopPipelining() {
-  auto opt = getGraphOpt<PerLoopPipelining>();
-  opt->run();
+  runGraphOpt<PerLoopPipelining>("PerLoopPipelining");
 }
 
 void BaseDatapath::loopUnrolling() {
   auto opt = getGraphOpt<LoopUnrolling>();
-  opt->run();
-  // Loop unrolling pass has identified and stored all loop boundaries in a flat
-  // list. Based on that, now we build a tree to represent the hierarchical loop
-  // structure. This tree will be used later by loop pipelining and loop
-  // sampling.
-  program.loop_info.buildLoopTree();
+  runCachedStage("LoopUnrolling", opt->getConfigFields(), [this, &opt]() {
+    opt->run();
+    // Loop unrolling pass has identified and stored all loop boundaries in a
+    // flat list. Based on that, now we build a tree to represent the
+    // hierarchical loop structure. This tree will be used later by loop
+    // pipelining and loop sampling.
+    program.loop_info.buildLoopTree();
+  });
+}
+
+void BaseDatapath::runCachedStage(const std::string& name,
+                                  unsigned config_fields,
+                                  const std::function<void()>& stage) {
+  Profiler::Phase phase(profiler, name);
+  if (!graph_cache.isEnabled()) {
+    stage();
+    phase.setWork(program.nodes.size(), boost::num_edges(program.graph));
+    return;
+  }
+  boost::hash_combine(stage_key, name);
+  boost::hash_combine(stage_key, user_params.hash(config_fields));
+  const Program* cached = graph_cache.find(stage_key);
+  if (cached) {
+    pending_program = cached;
+    return;
+  }
+  restoreCachedProgram();
+  stage();
+  phase.setWork(program.nodes.size(), boost::num_edges(program.graph));
+  graph_cache.insert(stage_key, program);
+}
+
+void BaseDatapath::restoreCachedProgram() {
+  if (!pending_program)
+    return;
+  Profiler::Phase phase(profiler, "restoreCachedProgram");
+  program.copyFrom(*pending_program);
+  pending_program = nullptr;
 }
 
 void BaseDatapath::fuseRegLoadStores() {
-  auto opt = getGraphOpt<RegLoadStoreFusion>();
-  opt->run();
+  runGraphOpt<RegLoadStoreFusion>("RegLoadStoreFusion");
 }
 
 void BaseDatapath::fuseConsecutiveBranches() {
-  auto opt = getGraphOpt<ConsecutiveBranchFusion>();
-  opt->run();
+  runGraphOpt<ConsecutiveBranchFusion>("ConsecutiveBranchFusion");
 }
 
 void BaseDatapath::removeSharedLoads() {
-  auto opt = getGraphOpt<LoadBuffering>();
-  opt->run();
+  runGraphOpt<LoadBuffering>("LoadBuffering");
 }
 
 void BaseDatapath::storeBuffer() {
-  auto opt = getGraphOpt<StoreBuffering>();
-  opt->run();
+  runGraphOpt<StoreBuffering>("StoreBuffering");
 }
 
 void BaseDatapath::removeRepeatedStores() {
-  auto opt = getGraphOpt<RepeatedStoreRemoval>();
-  opt->run();
+  runGraphOpt<RepeatedStoreRemoval>("RepeatedStoreRemoval");
 }
 
 void BaseDatapath::treeHeightReduction() {
-  auto opt = getGraphOpt<TreeHeightReduction>();
-  opt->run();
+  runGraphOpt<TreeHeightReduction>("TreeHeightReduction");
 }
 
 // called in the end of the whole flow
 void BaseDatapath::dumpStats() {
-  rescheduleNodesWhenNeeded();
-  upsampleLoops();
-  computeRegStats();
-  writePerCycleActivity();
-  writeOtherStats();
+  Profiler::Phase phase(profiler, "dumpStats");
+  {
+    Profiler::Phase phase(profiler, "rescheduleNodesWhenNeeded");
+    rescheduleNodesWhenNeeded();
+  }
+  {
+    Profiler::Phase phase(profiler, "upsampleLoops");
+    upsampleLoops();
+  }
+  {
+    Profiler::Phase phase(profiler, "computeRegStats");
+    computeRegStats();
+    phase.setWork(0, 0, num_cycles);
+  }
+  {
+    Profiler::Phase phase(profiler, "writePerCycleActivity");
+    writePerCycleActivity();
+    phase.setWork(0, 0, num_cycles);
+  }
+  if (!quiet) {
+    Profiler::Phase phase(profiler, "writeOtherStats");
+    writeOtherStats();
+  }
+  if (!snapshot_file.empty()) {
+    Profiler::Phase phase(profiler, "writeSnapshot");
+    std::string file_name = snapshot_file;
+    if (num_snapshots > 0)
+      file_name += "." + std::to_string(num_snapshots);
+    ScheduleSnapshot::write(program, num_cycles, file_name);
+    num_snapshots++;
+    phase.setWork(program.nodes.size(), program.getNumEdges());
+  }
 #ifdef DEBUG
-  dumpGraph(benchName);
+  {
+    Profiler::Phase phase(profiler, "dumpGraph");
+    dumpGraph(benchName);
+  }
 #endif
+  phase.setWork(0, 0, num_cycles);
+}
+
+int BaseDatapath::computeCriticalPathCycles() {
+  const float cycleTime = user_params.cycle_time;
+  // Round a time in ns up to the next cycle boundary.
+  auto toCycleBoundary = [cycleTime](float time) {
+    return ceil(time / cycleTime - 1e-4) * cycleTime;
+  };
+
+  std::vector<Vertex> topo_nodes = program.getReverseTopologicalOrder();
+  // Earliest completion time of each node in ns, indexed by vertex.
+  std::vector<float> finish_time(boost::num_vertices(program.graph), 0);
+  float critical_path = 0;
+  for (auto vi = topo_nodes.rbegin(); vi != topo_nodes.rend(); ++vi) {
+    ExecNode* node = program.nodeAtVertex(*vi);
+    if (node->is_isolated())
+      continue;
+    float start_time = 0;
+    in_edge_iter in_i, in_end;
+    for (boost::tie(in_i, in_end) = in_edges(*vi, program.graph);
+         in_i != in_end;
+         ++in_i) {
+      float parent_finish = finish_time[source(*in_i, program.graph)];
+      // Control dependences are resolved at the end of a cycle.
+      if (edgeToParid[*in_i] == CONTROL_EDGE)
+        parent_finish = toCycleBoundary(parent_finish);
+      start_time = std::max(start_time, parent_finish);
+    }
+    program.barriers.forEachParent(node->get_node_id(), [&](unsigned parent_id) {
+      // Implicit edges are control dependences too.
+      Vertex parent_vertex = program.nodes.at(parent_id)->get_vertex();
+      float parent_finish = toCycleBoundary(finish_time[parent_vertex]);
+      start_time = std::max(start_time, parent_finish);
+    });
+
+    // Memory and multicycle operations start at a cycle boundary and occupy
+    // whole cycles. Everything else can be chained with its parents as long
+    // as it does not cross into the next cycle.
+    float latency;
+    if (node->is_memory_op()) {
+      start_time = toCycleBoundary(start_time);
+      latency = cycleTime;
+    } else if (node->is_multicycle_op()) {
+      start_time = toCycleBoundary(start_time);
+      latency = node->get_multicycle_latency() * cycleTime;
+    } else {
+      latency = node->fu_node_latency(cycleTime);
+      if (toCycleBoundary(start_time + latency) >
+          toCycleBoundary(start_time) + cycleTime / 2)
+        start_time = toCycleBoundary(start_time);
+    }
+    finish_time[*vi] = start_time + latency;
+    critical_path = std::max(critical_path, finish_time[*vi]);
+  }
+  return (int)(toCycleBoundary(critical_path) / cycleTime + 0.5);
+}
+
+void BaseDatapath::estimateStats() {
+  // The estimate replaces the step() loop.
+  if (schedule_phase)
+    schedule_phase->discard();
+  schedule_phase.reset();
+  Profiler::Phase phase(profiler, "estimateStats");
+  int critical_path_cycles = computeCriticalPathCycles();
+  int memory_bound_cycles = computeMemoryBoundCycles();
+  int est_cycles =
+      std::max(1, std::max(critical_path_cycles, memory_bound_cycles));
+
+  // Total busy cycles of each type of functional unit.
+  FunctionActivity busy_cycles;
+  // Reads and writes of the registers inferred between functional units. Every
+  // value that is consumed by another node is assumed to be written to and read
+  // from one 32-bit register.
+  unsigned reg_accesses = 0;
+  for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
+       ++node_it) {
+    ExecNode* node = node_it->second;
+    if (node->is_isolated())
+      continue;
+    if (!node->is_control_op() && !node->is_index_op() &&
+        program.getOutDegree(node) != 0)
+      reg_accesses += 2;
+    if (node->is_multicycle_op()) {
+      unsigned stages = node->get_multicycle_latency();
+      if (node->is_fp_add_op()) {
+        if (node->is_double_precision())
+          busy_cycles.fp_dp_add += stages;
+        else
+          busy_cycles.fp_sp_add += stages;
+      } else if (node->is_fp_mul_op()) {
+        if (node->is_double_precision())
+          busy_cycles.fp_dp_mul += stages;
+        else
+          busy_cycles.fp_sp_mul += stages;
+      } else if (node->is_special_math_op()) {
+        busy_cycles.trig += stages;
+      }
+    } else if (node->is_int_mul_op()) {
+      busy_cycles.mul++;
+    } else if (node->is_int_add_op()) {
+      busy_cycles.add++;
+    } else if (node->is_shifter_op()) {
+      busy_cycles.shifter++;
+    } else if (node->is_bit_op()) {
+      busy_cycles.bit++;
+    }
+  }
+
+  float cycleTime = user_params.cycle_time;
+  float int_power, switch_power, leak_power, area;
+  float fu_dynamic_energy = 0;
+  float fu_leakage_power = registers.getTotalLeakagePower();
+  float fu_area = registers.getTotalArea();
+  // Accumulate the power and area of one type of functional unit, assuming the
+  // fewest units that can absorb its busy cycles within the estimated cycle
+  // count. Returns the number of units.
+  auto addUnitPower = [&](unsigned busy) {
+    unsigned num_units = (busy + est_cycles - 1) / est_cycles;
+    fu_dynamic_energy += (int_power + switch_power) * busy * cycleTime;
+    fu_leakage_power += leak_power * num_units;
+    fu_area += area * num_units;
+    return (int)num_units;
+  };
+  summary_data_t summary = summary_data_t();
+  getAdderPowerArea(cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_add = addUnitPower(busy_cycles.add);
+  getMultiplierPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_mul = addUnitPower(busy_cycles.mul);
+  getBitPowerArea(cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_bit = addUnitPower(busy_cycles.bit);
+  getShifterPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_shifter = addUnitPower(busy_cycles.shifter);
+  getSinglePrecisionFloatingPointMultiplierPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_fp_sp_mul = addUnitPower(busy_cycles.fp_sp_mul);
+  getDoublePrecisionFloatingPointMultiplierPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_fp_dp_mul = addUnitPower(busy_cycles.fp_dp_mul);
+  getSinglePrecisionFloatingPointAdderPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_fp_sp_add = addUnitPower(busy_cycles.fp_sp_add);
+  getDoublePrecisionFloatingPointAdderPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_fp_dp_add = addUnitPower(busy_cycles.fp_dp_add);
+  getTrigonometricFunctionPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  summary.max_trig = addUnitPower(busy_cycles.trig);
+  getRegisterPowerArea(
+      cycleTime, &int_power, &switch_power, &leak_power, &area);
+  int_power *= 32;
+  switch_power *= 32;
+  leak_power *= 32;
+  area *= 32;
+  summary.max_reg = addUnitPower(reg_accesses);
+
+  float avg_fu_dynamic_power = fu_dynamic_energy / (cycleTime * est_cycles);
+  float avg_fu_power = avg_fu_dynamic_power + fu_leakage_power;
+  // Only the leakage of the memory is read from its stats; the accesses were
+  // never issued.
+  float avg_mem_power = 0, avg_mem_dynamic_power = 0, mem_leakage_power = 0;
+  getAverageMemPower(
+      est_cycles, &avg_mem_power, &avg_mem_dynamic_power, &mem_leakage_power);
+  avg_mem_dynamic_power =
+      computeMemoryDynamicEnergy() / (cycleTime * est_cycles);
+  avg_mem_power = avg_mem_dynamic_power + mem_leakage_power;
+  float avg_power = avg_fu_power + avg_mem_power;
+  float mem_area = getTotalMemArea();
+
+  summary.benchName = benchName;
+  summary.topLevelFunctionName = topLevelFunctionName;
+  summary.num_cycles = est_cycles;
+  summary.avg_power = avg_power;
+  summary.avg_fu_power = avg_fu_power;
+  summary.avg_fu_dynamic_power = avg_fu_dynamic_power;
+  summary.fu_leakage_power = fu_leakage_power;
+  summary.avg_mem_power = avg_mem_power;
+  summary.avg_mem_dynamic_power = avg_mem_dynamic_power;
+  summary.mem_leakage_power = mem_leakage_power;
+  summary.total_area = fu_area + mem_area;
+  summary.fu_area = fu_area;
+  summary.mem_area = mem_area;
+  last_summary = summary;
+  if (quiet)
+    return;
+
+  std::ofstream estimate_file;
+  std::string file_name = benchName + "_estimate";
+  estimate_file.open(file_name.c_str(), std::ofstream::out | std::ofstream::app);
+  for (std::ostream* out : { (std::ostream*)&std::cout,
+                             (std::ostream*)&estimate_file }) {
+    *out << "===============================" << std::endl;
+    *out << "        Aladdin Estimate       " << std::endl;
+    *out << "===============================" << std::endl;
+    *out << "Running : " << benchName << std::endl;
+    *out << "Top level function: " << topLevelFunctionName << std::endl;
+    *out << "Critical Path : " << critical_path_cycles << " cycles"
+         << std::endl;
+    *out << "Memory Bound : " << memory_bound_cycles << " cycles" << std::endl;
+    *out << "Cycle : " << est_cycles << " cycles" << std::endl;
+    *out << "Avg Power: " << avg_power << " mW" << std::endl;
+    *out << "Avg FU Power: " << avg_fu_power << " mW" << std::endl;
+    *out << "Avg MEM Power: " << avg_mem_power << " mW" << std::endl;
+    *out << "Total Area: " << summary.total_area << " uM^2" << std::endl;
+    *out << "===============================" << std::endl;
+  }
+  estimate_file.close();
 }
 
 void BaseDatapath::upsampleLoops() {
@@ -297,7 +646,7 @@ void BaseDatapath::updatePerCycleActivity(
    * reuse for adders. This way of modeling is consistent with our observation
    * of accelerators generated with Vivado. */
   unsigned num_adds_so_far = 0, num_bits_so_far = 0, num_shifters_so_far = 0;
-  auto bound_it = program.loop_bounds.begin();
+  const LoopRegions& regions = program.getLoopRegions();
   for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
        ++node_it) {
     ExecNode* node = node_it->second;
@@ -306,8 +655,7 @@ void BaseDatapath::updatePerCycleActivity(
     auto max_it = func_max_activity.find(func_id);
     assert(max_it != func_max_activity.end());
 
-    if (bound_it != program.loop_bounds.end() &&
-        node->get_node_id() == bound_it->node_id) {
+    if (regions.isBound(node->get_node_id())) {
       if (max_it->second.add < num_adds_so_far)
         max_it->second.add = num_adds_so_far;
       if (max_it->second.bit < num_bits_so_far)
@@ -317,7 +665,6 @@ void BaseDatapath::updatePerCycleActivity(
       num_adds_so_far = 0;
       num_bits_so_far = 0;
       num_shifters_so_far = 0;
-      bound_it++;
     }
     if (node->is_isolated())
       continue;
@@ -741,6 +1088,9 @@ void BaseDatapath::outputPerCycleActivity(
   summary.max_fp_sp_add = max_fp_sp_add;
   summary.max_fp_dp_add = max_fp_dp_add;
   summary.max_trig = max_trig;
+  last_summary = summary;
+  if (quiet)
+    return;
 
   writeSummary(std::cout, summary);
   std::ofstream summary_file;
@@ -838,24 +1188,26 @@ void BaseDatapath::writeOtherStats() {}
 // stepFunctions
 // multiple function, each function is a separate graph
 void BaseDatapath::prepareForScheduling() {
+  schedule_phase.reset();
+  Profiler::Phase phase(profiler, "prepareForScheduling");
   std::cout << "=============================================" << std::endl;
   std::cout << "      Scheduling...            " << benchName << std::endl;
   std::cout << "=============================================" << std::endl;
 
   edgeToParid = get(boost::edge_name, program.graph);
 
-  numTotalEdges = boost::num_edges(program.graph);
+  numTotalEdges = program.getNumEdges();
   executedNodes = 0;
   totalConnectedNodes = 0;
   for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
        ++node_it) {
     ExecNode* node = node_it->second;
+    node->cache_fu_node_latency(user_params.cycle_time);
     if (!node->has_vertex())
       continue;
-    Vertex node_vertex = node->get_vertex();
-    if (boost::degree(node_vertex, program.graph) != 0 || node->is_dma_load() ||
+    if (program.getDegree(node) != 0 || node->is_dma_load() ||
         node->is_dma_store() || node->is_dma_fence()) {
-      node->set_num_parents(boost::in_degree(node_vertex, program.graph));
+      node->set_num_parents(program.getInDegree(node));
       node->set_isolated(false);
       totalConnectedNodes++;
     }
@@ -867,18 +1219,134 @@ void BaseDatapath::prepareForScheduling() {
   executingQueue.clear();
   readyToExecuteQueue.clear();
   initExecutingQueue();
+  if (resume_checkpoint && num_invocations - 1 == resume_invocation)
+    restoreCheckpoint();
+  phase.setWork(totalConnectedNodes, numTotalEdges);
+  phase.end();
+  schedule_phase.reset(new Profiler::Phase(profiler, "schedule"));
 }
 
 void BaseDatapath::dumpGraph(std::string graph_name) {
-  std::unordered_map<Vertex, ExecNode*> vertexToMicroop;
-  BGL_FORALL_VERTICES(v, program.graph, Graph) {
-    ExecNode* node = program.nodes.at(get(boost::vertex_node_id, program.graph, v));
-    vertexToMicroop[v] = node;
+  GraphExporter exporter(program);
+  exporter.write(graph_name + "_graph.dot", GraphExporter::Graphviz, true);
+}
+
+void BaseDatapath::getStatsFiles(std::vector<std::string>& file_names) {
+  file_names.push_back(benchName + "_summary");
+}
+
+void BaseDatapath::checkpointIfDue() {
+  if (checkpoint_file.empty() || checkpoint_interval == 0 ||
+      num_cycles % checkpoint_interval != 0)
+    return;
+  Profiler::Phase phase(profiler, "writeCheckpoint");
+  writeCheckpoint();
+}
+
+void BaseDatapath::writeCheckpoint() {
+  CheckpointWriter out;
+  out.put<uint32_t>(num_invocations - 1);
+  out.put<uint32_t>(num_snapshots);
+  std::vector<std::string> stats_files;
+  getStatsFiles(stats_files);
+  out.put<uint32_t>(stats_files.size());
+  for (auto& file_name : stats_files) {
+    out.putString(file_name);
+    bool exists = fileExists(file_name);
+    out.put<uint8_t>(exists);
+    if (exists) {
+      std::ifstream stats_file(file_name, std::ios::binary);
+      out.putString(std::string(std::istreambuf_iterator<char>(stats_file),
+                                std::istreambuf_iterator<char>()));
+    }
+  }
+
+  // Enough of the program to tell whether it is the one being resumed.
+  out.put<uint64_t>(current_trace_off);
+  out.put<uint32_t>(program.nodes.size());
+  out.put<uint32_t>(numTotalEdges);
+  out.put<uint32_t>(totalConnectedNodes);
+
+  out.put(num_cycles);
+  out.put(executedNodes);
+  for (auto* queue : { &executingQueue, &readyToExecuteQueue }) {
+    std::vector<uint32_t> node_ids;
+    for (ExecNode* node : *queue)
+      node_ids.push_back(node->get_node_id());
+    out.putVector(node_ids);
+  }
+  for (auto& node_pair : program.nodes) {
+    const ExecNode* node = node_pair.second;
+    out.put<int32_t>(node->started() ? node->get_start_execution_cycle() : -1);
+    out.put<int32_t>(node->completed() ? node->get_complete_execution_cycle()
+                                       : -1);
+    out.put<int32_t>(node->get_num_parents());
+    out.put(node->get_time_before_execution());
+  }
+  registers.saveState(out);
+  saveSchedulerState(out);
+  out.write(checkpoint_file);
+}
+
+bool BaseDatapath::resumeFromCheckpoint() {
+  if (!fileExists(checkpoint_file)) {
+    std::cout << "No checkpoint found in " << checkpoint_file
+              << ", starting from the beginning.\n";
+    return false;
+  }
+  resume_checkpoint.reset(new CheckpointReader());
+  CheckpointReader& in = *resume_checkpoint;
+  in.open(checkpoint_file);
+  resume_invocation = in.get<uint32_t>();
+  num_snapshots = in.get<uint32_t>();
+
+  // Put the stats files back the way they were, dropping anything written
+  // after the checkpoint.
+  uint32_t num_stats_files = in.get<uint32_t>();
+  for (uint32_t i = 0; i < num_stats_files; i++) {
+    std::string file_name = in.getString();
+    bool exists = in.get<uint8_t>();
+    if (exists) {
+      std::string contents = in.getString();
+      std::ofstream stats_file(file_name, std::ios::binary);
+      stats_file.write(contents.data(), contents.size());
+    } else if (fileExists(file_name) && remove(file_name.c_str()) != 0) {
+      perror("Failed to delete a stats file written after the checkpoint");
+    }
+  }
+  std::cout << "Resuming invocation " << resume_invocation << " from "
+            << checkpoint_file << ".\n";
+  return true;
+}
+
+void BaseDatapath::restoreCheckpoint() {
+  CheckpointReader& in = *resume_checkpoint;
+  in.check(in.get<uint64_t>() == current_trace_off, "the trace offset");
+  in.check(in.get<uint32_t>() == program.nodes.size(), "the number of nodes");
+  in.check(in.get<uint32_t>() == numTotalEdges, "the number of edges");
+  in.check(in.get<uint32_t>() == totalConnectedNodes,
+           "the number of connected nodes");
+
+  num_cycles = in.get<int>();
+  executedNodes = in.get<unsigned>();
+  for (auto* queue : { &executingQueue, &readyToExecuteQueue }) {
+    queue->clear();
+    for (uint32_t node_id : in.getVector<uint32_t>()) {
+      in.check(program.nodeExists(node_id), "the nodes");
+      queue->push_back(program.nodes.at(node_id));
+    }
+  }
+  for (auto& node_pair : program.nodes) {
+    ExecNode* node = node_pair.second;
+    node->set_start_execution_cycle(in.get<int32_t>());
+    node->set_complete_execution_cycle(in.get<int32_t>());
+    node->set_num_parents(in.get<int32_t>());
+    node->set_time_before_execution(in.get<float>());
   }
-  std::ofstream out(
-      graph_name + "_graph.dot", std::ofstream::out | std::ofstream::app);
-  write_graphviz(out, program.graph,
-                 make_microop_label_writer(vertexToMicroop, program.graph));
+  registers.restoreState(in);
+  restoreSchedulerState(in);
+  resume_checkpoint.reset();
+  std::cout << "  Resumed at cycle " << num_cycles << ".\n";
 }
 
 /*As Late As Possible (ALAP) rescheduling for non-memory, non-control nodes.
@@ -889,8 +1357,7 @@ void BaseDatapath::dumpGraph(std::string graph_name) {
   changing the critical path and memory nodes, but produce a more balanced
   design.*/
 int BaseDatapath::rescheduleNodesWhenNeeded() {
-  std::vector<Vertex> topo_nodes;
-  boost::topological_sort(program.graph, std::back_inserter(topo_nodes));
+  std::vector<Vertex> topo_nodes = program.getReverseTopologicalOrder();
   // bottom nodes first
   std::map<unsigned, int> earliest_child;
   for (auto node_id_pair : program.nodes) {
@@ -921,6 +1388,10 @@ int BaseDatapath::rescheduleNodesWhenNeeded() {
       if (earliest_child.at(parent_id) > node->get_start_execution_cycle())
         earliest_child.at(parent_id) = node->get_start_execution_cycle();
     }
+    program.barriers.forEachParent(node_id, [&](unsigned parent_id) {
+      if (earliest_child.at(parent_id) > node->get_start_execution_cycle())
+        earliest_child.at(parent_id) = node->get_start_execution_cycle();
+    });
   }
   return num_cycles;
 }
@@ -979,8 +1450,13 @@ bool BaseDatapath::step() {
   stepExecutingQueue();
   copyToExecutingQueue();
   num_cycles++;
-  if (executedNodes == totalConnectedNodes)
+  if (executedNodes == totalConnectedNodes) {
+    if (schedule_phase) {
+      schedule_phase->setWork(totalConnectedNodes, numTotalEdges, num_cycles);
+      schedule_phase.reset();
+    }
     return true;
+  }
   return false;
 }
 
@@ -1003,25 +1479,14 @@ void BaseDatapath::markNodeCompleted(
 void BaseDatapath::updateChildren(ExecNode* node) {
   if (!node->has_vertex())
     return;
-  Vertex node_vertex = node->get_vertex();
-  out_edge_iter out_edge_it, out_edge_end;
-  for (boost::tie(out_edge_it, out_edge_end) = out_edges(node_vertex, program.graph);
-       out_edge_it != out_edge_end;
-       ++out_edge_it) {
-    Vertex child_vertex = target(*out_edge_it, program.graph);
-    ExecNode* child_node = program.nodeAtVertex(child_vertex);
-    int edge_parid = edgeToParid[*out_edge_it];
+  bool curr_zero_latency =
+      !node->is_memory_op() && node->get_fu_node_latency() == 0;
+  auto update_child = [&](ExecNode* child_node, int edge_parid) {
     if (child_node->get_num_parents() > 0) {
       child_node->decr_num_parents();
       if (child_node->get_num_parents() == 0) {
-        bool child_zero_latency =
-            (child_node->is_memory_op())
-                ? false
-                : (child_node->fu_node_latency(user_params.cycle_time) == 0);
-        bool curr_zero_latency =
-            (node->is_memory_op())
-                ? false
-                : (node->fu_node_latency(user_params.cycle_time) == 0);
+        bool child_zero_latency = !child_node->is_memory_op() &&
+                                  child_node->get_fu_node_latency() == 0;
         if (edge_parid == REGISTER_EDGE || edge_parid == FUSED_BRANCH_EDGE ||
             ((child_zero_latency || curr_zero_latency) &&
              edge_parid != CONTROL_EDGE)) {
@@ -1035,7 +1500,19 @@ void BaseDatapath::updateChildren(ExecNode* node) {
         child_node->set_num_parents(-1);
       }
     }
+  };
+  Vertex node_vertex = node->get_vertex();
+  out_edge_iter out_edge_it, out_edge_end;
+  for (boost::tie(out_edge_it, out_edge_end) = out_edges(node_vertex, program.graph);
+       out_edge_it != out_edge_end;
+       ++out_edge_it) {
+    Vertex child_vertex = target(*out_edge_it, program.graph);
+    update_child(program.nodeAtVertex(child_vertex),
+                 edgeToParid[*out_edge_it]);
   }
+  program.barriers.forEachChild(node->get_node_id(), [&](unsigned child_id) {
+    update_child(program.nodes.at(child_id), CONTROL_EDGE);
+  });
 }
 
 void BaseDatapath::initExecutingQueue() {
@@ -1156,8 +1633,14 @@ void BaseDatapath::parse_config(std::string& bench,
       user_params.cycle_time = stof(rest_line);
     } else if (!type.compare("ready_mode")) {
       user_params.ready_mode = atoi(rest_line.c_str());
+    } else if (!type.compare("parse_threads")) {
+      user_params.parse_threads = std::max(1, atoi(rest_line.c_str()));
+    } else if (!type.compare("timing_only")) {
+      user_params.timing_only = atoi(rest_line.c_str());
     } else if (!type.compare("scratchpad_ports")) {
       user_params.scratchpad_ports = atoi(rest_line.c_str());
+    } else if (user_params.mem_system.set(type, atoi(rest_line.c_str()))) {
+      // A memory system parameter.
     } else {
       std::cerr << "Invalid config type: " << wholeline << std::endl;
       exit(1);
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
 #include <list>
@@ -25,12 +26,15 @@
 #include "DatabaseDeps.h"
 
 #include "AladdinExceptions.h"
+#include "Checkpoint.h"
 #include "ExecNode.h"
 #include "typedefs.h"
 #include "DDDG.h"
 #include "file_func.h"
+#include "GraphCache.h"
 #include "opcode_func.h"
 #include "MemoryType.h"
+#include "Profiler.h"
 #include "Program.h"
 #include "Registers.h"
 #include "Scratchpad.h"
@@ -109,38 +113,23 @@ struct summary_data_t {
   int max_reg;
 };
 
-/* Custom graphviz label writer that outputs the node id and microop of the vertex.
- *
- * Create a map from Vertex to the ExecNode object and call
- * make_microop_label_writer() with this map. This lets us output as much
- * information about each node as we want in the graph.
- */
-template <class Map, class Graph>
-class microop_label_writer {
- public:
-  microop_label_writer(Map _vertexToNode, Graph& _graph)
-      : vertexToNode(_vertexToNode), graph(_graph) {}
-  void operator()(std::ostream& out, const Vertex& v) {
-    const ExecNode* node = vertexToNode[v];
-    out << "[label=\"" << node->get_node_id() << "\\n("
-        << node->get_microop_name() << ")\"]";
-  }
-
- private:
-  Map vertexToNode;
-  Graph graph;
+// Describes a program built by a datapath, for BaseDatapath::reconfigure().
+struct ProgramInfo {
+  // Identifies the program in the graph cache.
+  size_t key;
+  std::string top_level_function;
+  std::unordered_set<std::string> function_names;
+  // Base addresses of the arrays, as found in the trace.
+  std::map<std::string, Addr> array_base_addresses;
 };
 
-template <class Map, class Graph>
-inline microop_label_writer<Map, Graph> make_microop_label_writer(Map map, Graph graph) {
-  return microop_label_writer<Map, Graph>(map, graph);
-}
-
 class BaseDatapath {
  protected:
    typedef SrcTypes::DynamicVariable DynamicVariable;
 
  public:
+  // An empty @trace_file_name creates a datapath without a trace, whose
+  // program can only be loaded from a snapshot.
   BaseDatapath(std::string& bench,
                std::string& trace_file_name,
                std::string& _config_file);
@@ -157,6 +146,14 @@ class BaseDatapath {
   // Reset the dynamic trace to the beginning.
   virtual void resetTrace();
 
+  // Take over the program that @other has built and optimized, along with the
+  // configuration it was built under, so that this datapath can schedule it
+  // while @other builds the next invocation. @other is left with an empty
+  // program and should be cleared with clearDatapath() before building again.
+  // The nodes still refer to the source manager of @other, so @other must
+  // outlive the program.
+  virtual void adoptProgram(BaseDatapath& other);
+
   // Add a function to the list of functions.
   void addFunctionName(std::string func_name) {
     functionNames.insert(func_name);
@@ -190,8 +187,7 @@ class BaseDatapath {
   }
 
   // Graph optimizations.
-  void removeInductionDependence();
-  void removePhiNodes();
+  void removeDeadNodes();
   void memoryAmbiguation();
   void removeAddressCalculation();
   void nodeStrengthReduction();
@@ -222,6 +218,9 @@ class BaseDatapath {
   //=----------- User configuration functions ------------=//
 
   bool isReadyMode() const { return user_params.ready_mode; }
+  bool isTimingOnly() const { return user_params.timing_only; }
+  unsigned getNumParseThreads() const { return user_params.parse_threads; }
+  const UserConfigParams& getUserParams() const { return user_params; }
 
   //=----------- Simulation/scheduling functions --------=//
 
@@ -231,6 +230,110 @@ class BaseDatapath {
   void dumpGraph(std::string graph_name);
   void dumpStats();
 
+  //=----------- Analytical estimation --------------=//
+
+  // Estimate the cycle count and power of the optimized graph without running
+  // the cycle-level scheduler.
+  //
+  // The estimate is the larger of the latency-weighted critical path and the
+  // memory bandwidth bound. Call this after prepareForScheduling() instead of
+  // the step() loop and dumpStats().
+  void estimateStats();
+
+  // Length of the latency-weighted critical path through the graph, in cycles.
+  int computeCriticalPathCycles();
+
+  // Lower bound on cycles imposed by the bandwidth of the memory system.
+  virtual int computeMemoryBoundCycles() { return 0; }
+
+  // Dynamic energy of every memory access in the program, so that the power of
+  // the memory can be estimated without scheduling.
+  //
+  // Neither of these changes the stats of the memory system.
+  virtual float computeMemoryDynamicEnergy() { return 0; }
+
+  // Results of the most recent call to dumpStats() or estimateStats().
+  const summary_data_t& getSummary() const { return last_summary; }
+
+  // Keep the results of dumpStats() and estimateStats() in getSummary() only,
+  // without printing them or writing the stats files.
+  void setQuiet(bool _quiet) { quiet = _quiet; }
+
+  //=----------- Design space exploration -----------=//
+
+  // Replace the program with a copy of @prog and the configuration with
+  // @params, and reset all optimization and scheduling state, so that the
+  // datapath can be optimized and scheduled again as if it had just been
+  // built. @prog must have been built by this datapath, since its nodes refer
+  // to this datapath's source manager. @info is what getProgramInfo()
+  // returned after @prog was built.
+  virtual void reconfigure(const Program& prog,
+                           const UserConfigParams& params,
+                           const ProgramInfo& info);
+
+  // What the datapath knows about the program last built by buildDddg(),
+  // besides the program itself.
+  ProgramInfo getProgramInfo() const;
+
+  // Cache the program after each stage of graph optimizations, keeping at
+  // most @capacity programs; 0 (the default) disables caching. This only pays
+  // off when the same program is optimized again through reconfigure().
+  void setGraphCacheCapacity(unsigned capacity) {
+    graph_cache.setCapacity(capacity);
+  }
+  const GraphCache& getGraphCache() const { return graph_cache; }
+
+  //=----------- Profiling -----------=//
+
+  // Records the time spent in trace parsing, each graph optimization,
+  // prepareForScheduling(), the step() loop and dumpStats(). Disabled until
+  // setEnabled(true) is called on it.
+  Profiler& getProfiler() { return profiler; }
+
+  //=----------- Schedule snapshots -----------=//
+
+  // Write a ScheduleSnapshot of the scheduled program to @file_name at the end
+  // of every dumpStats(). The snapshot of the nth invocation after the first
+  // one is written to @file_name.n.
+  void setSnapshotFile(const std::string& file_name) {
+    snapshot_file = file_name;
+  }
+
+  // Replace the program with the one saved in the snapshot @file_name, as it
+  // was after scheduling.
+  void loadSnapshot(const std::string& file_name);
+
+  //=----------- Checkpoints -----------=//
+
+  // Write a checkpoint to @file_name every @interval cycles of scheduling. A
+  // checkpoint holds the state of the scheduler, the scratchpad and the memory
+  // system in the current invocation, and the stats files as written by the
+  // invocations before it.
+  void setCheckpointFile(const std::string& file_name, unsigned interval) {
+    checkpoint_file = file_name;
+    checkpoint_interval = interval;
+  }
+
+  // Resume from the checkpoint in the file set by setCheckpointFile(). Return
+  // false if there is no checkpoint yet, in which case the simulation simply
+  // starts from the beginning.
+  //
+  // The programs are not part of the checkpoint; they are built again from the
+  // trace. Every invocation before the checkpointed one is built and optimized
+  // but not scheduled (see isReplayingInvocation()), which moves the trace
+  // forward and sets up the scratchpad as before. prepareForScheduling() then
+  // restores the scheduler state of the checkpointed invocation, and stepping
+  // continues from the cycle the checkpoint was taken at with the same results
+  // as if the simulation had never stopped.
+  bool resumeFromCheckpoint();
+
+  // True if the current invocation was completed before the checkpoint being
+  // resumed was taken, so it must be cleared after it is optimized instead of
+  // being scheduled.
+  bool isReplayingInvocation() const {
+    return resume_checkpoint && num_invocations - 1 < resume_invocation;
+  }
+
   //=------------ Clean up functions -----------=//
 
   virtual void clearDatapath();
@@ -257,6 +360,22 @@ class BaseDatapath {
   // Execute all nodes in the current cycle.
   virtual void stepExecutingQueue() = 0;
 
+  //=------------ Checkpoints -------------=//
+
+  // Write a checkpoint if one is due in the current cycle. Must be called at
+  // the end of step(), after all the state of the cycle has been updated.
+  void checkpointIfDue();
+  void writeCheckpoint();
+  void restoreCheckpoint();
+
+  // Save or restore the scheduler state that a derived datapath adds.
+  virtual void saveSchedulerState(CheckpointWriter& out) const {}
+  virtual void restoreSchedulerState(CheckpointReader& in) {}
+
+  // Add the names of the stats files that dumpStats() appends to, which are
+  // saved in checkpoints.
+  virtual void getStatsFiles(std::vector<std::string>& file_names);
+
   // Run all the graph optimizations in the required order.
   virtual void globalOptimizationPass() = 0;
 
@@ -280,6 +399,28 @@ class BaseDatapath {
     return std::unique_ptr<T>(new T(program, srcManager, user_params));
   }
 
+  // Run the graph optimization T as a stage of its own.
+  template <typename T>
+  void runGraphOpt(const std::string& name) {
+    auto opt = getGraphOpt<T>();
+    runCachedStage(name, opt->getConfigFields(), [&opt]() { opt->run(); });
+  }
+
+  // Run a stage of graph optimizations that reads the configuration fields
+  // @config_fields (a bitmask of UserConfigParams::Field).
+  //
+  // If the graph cache is enabled and already holds the program this stage
+  // would produce, the stage is skipped. The cached program is only copied
+  // back when a later stage misses or restoreCachedProgram() is called, so a
+  // run of skipped stages costs a single copy.
+  void runCachedStage(const std::string& name,
+                      unsigned config_fields,
+                      const std::function<void()>& stage);
+
+  // Restore the program of the last skipped stage, if any. This must be called
+  // after the last stage, before the program is read.
+  void restoreCachedProgram();
+
   //=------------- User configuration routines -------------=//
 
   // Configuration parsing and handling.
@@ -385,6 +526,42 @@ class BaseDatapath {
    * into databases, this is required. */
   std::string experiment_name;
 
+  // Summary of the last simulation or estimate.
+  summary_data_t last_summary;
+
+  // Optimized programs, keyed by the stages applied to the unoptimized program
+  // of this invocation and the configuration they read.
+  GraphCache graph_cache;
+  // Key of the unoptimized program, and of the program after the stages run
+  // so far.
+  size_t program_key;
+  size_t stage_key;
+  // The cached program of the last skipped stage, if it has not been restored
+  // yet.
+  const Program* pending_program;
+
+  Profiler profiler;
+
+  // Where dumpStats() writes the snapshot, if anywhere, and how many it has
+  // written so far.
+  std::string snapshot_file;
+  unsigned num_snapshots;
+  // Set by setQuiet().
+  bool quiet;
+
+  // Where and how often checkpoints are written, if at all.
+  std::string checkpoint_file;
+  unsigned checkpoint_interval;
+  // Number of invocations built so far.
+  unsigned num_invocations;
+  // The checkpoint being resumed, positioned after the stats files, until it
+  // is restored by prepareForScheduling() of invocation resume_invocation.
+  std::unique_ptr<CheckpointReader> resume_checkpoint;
+  unsigned resume_invocation;
+  // Spans the step() loop, from the end of prepareForScheduling() to the last
+  // step().
+  std::unique_ptr<Profiler::Phase> schedule_phase;
+
   // The final set of edge weights after all graph optimizations have been run.
   EdgeNameMap edgeToParid;
 
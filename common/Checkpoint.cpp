@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Checkpoint.h"
+
+namespace {
+
+const char kMagic[8] = { 'A', 'L', 'A', 'D', 'C', 'K', 'P', 'T' };
+const uint32_t kVersion = 1;
+
+}  // namespace
+
+void CheckpointWriter::write(const std::string& file_name) const {
+  std::string temp_file_name = file_name + ".tmp";
+  FILE* out = fopen(temp_file_name.c_str(), "wb");
+  if (!out) {
+    perror("Failed to open the checkpoint file");
+    exit(1);
+  }
+  bool written = fwrite(kMagic, sizeof(kMagic), 1, out) == 1 &&
+                 fwrite(&kVersion, sizeof(kVersion), 1, out) == 1 &&
+                 fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+  // The checkpoint has to be on disk before it replaces the last one, or a
+  // crash could leave neither.
+  written = written && fflush(out) == 0 && fsync(fileno(out)) == 0;
+  if (fclose(out) != 0 || !written) {
+    std::cerr << "[ERROR]: Failed to write the checkpoint file "
+              << temp_file_name << ".\n";
+    exit(1);
+  }
+  if (rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+    perror("Failed to replace the checkpoint file");
+    exit(1);
+  }
+  // Make the rename itself durable.
+  size_t slash = file_name.find_last_of('/');
+  std::string dir_name =
+      slash == std::string::npos ? "." : file_name.substr(0, slash + 1);
+  int dir_fd = open(dir_name.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd < 0 || fsync(dir_fd) != 0) {
+    perror("Failed to sync the directory of the checkpoint file");
+    exit(1);
+  }
+  close(dir_fd);
+}
+
+void CheckpointReader::open(const std::string& _file_name) {
+  file_name = _file_name;
+  std::ifstream in(file_name, std::ios::binary);
+  if (!in) {
+    std::cerr << "[ERROR]: Failed to open the checkpoint file " << file_name
+              << ".\n";
+    exit(1);
+  }
+  buffer.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  pos = 0;
+
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  bool valid = buffer.size() >= sizeof(magic) + sizeof(version);
+  if (valid) {
+    read(magic, sizeof(magic));
+    read(&version, sizeof(version));
+    valid = memcmp(magic, kMagic, sizeof(kMagic)) == 0 && version == kVersion;
+  }
+  if (!valid) {
+    std::cerr << "[ERROR]: " << file_name << " is not a checkpoint of version "
+              << kVersion << ".\n";
+    exit(1);
+  }
+}
+
+void CheckpointReader::check(bool condition, const std::string& what) const {
+  if (condition)
+    return;
+  std::cerr << "[ERROR]: The checkpoint " << file_name
+            << " was not taken from this simulation: " << what
+            << " does not match.\n";
+  exit(1);
+}
+
+void CheckpointReader::read(void* dest, size_t size) {
+  if (size > buffer.size() - pos) {
+    std::cerr << "[ERROR]: The checkpoint " << file_name
+              << " is truncated.\n";
+    exit(1);
+  }
+  memcpy(dest, buffer.data() + pos, size);
+  pos += size;
+}
@@ -0,0 +1,97 @@
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* Serialization of the scheduler state for checkpoints.
+ *
+ * A checkpoint is a flat sequence of values in host byte order, preceded by a
+ * magic number and a version. There is no self description: the classes that
+ * save their state with a CheckpointWriter read it back in the same order
+ * with a CheckpointReader, and check whatever they need to make sure the
+ * state belongs to them.
+ *
+ * A checkpoint is only meant to be resumed by the same build of Aladdin, with
+ * the same trace and configuration, on the same machine.
+ */
+class CheckpointWriter {
+ public:
+  template <typename T>
+  void put(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only plain values can be written directly.");
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  void putString(const std::string& str) {
+    put<uint64_t>(str.size());
+    buffer.insert(buffer.end(), str.begin(), str.end());
+  }
+
+  template <typename T>
+  void putVector(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only plain values can be written directly.");
+    put<uint64_t>(values.size());
+    const char* bytes = reinterpret_cast<const char*>(values.data());
+    buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+  }
+
+  // Write the checkpoint to @file_name. It is first written and synced to a
+  // temporary file and then renamed, so neither an interrupted write nor a
+  // crash of the machine destroys the last checkpoint.
+  void write(const std::string& file_name) const;
+
+ private:
+  std::vector<char> buffer;
+};
+
+class CheckpointReader {
+ public:
+  CheckpointReader() : pos(0) {}
+
+  // Read all of @file_name. Exits if it is not a checkpoint of this version.
+  void open(const std::string& file_name);
+
+  template <typename T>
+  T get() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only plain values can be read directly.");
+    T value;
+    read(&value, sizeof(T));
+    return value;
+  }
+
+  std::string getString() {
+    std::string str(get<uint64_t>(), '\0');
+    read(&str[0], str.size());
+    return str;
+  }
+
+  template <typename T>
+  std::vector<T> getVector() {
+    std::vector<T> values(get<uint64_t>());
+    read(values.data(), values.size() * sizeof(T));
+    return values;
+  }
+
+  // Exit with an error about @what unless @condition holds. Used to reject
+  // checkpoints of a different trace or configuration.
+  void check(bool condition, const std::string& what) const;
+
+  const std::string& getFileName() const { return file_name; }
+
+ private:
+  void read(void* dest, size_t size);
+
+  std::string file_name;
+  std::vector<char> buffer;
+  size_t pos;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cassert>
+
+#include "ControlBarriers.h"
+
+const unsigned ControlBarriers::NONE;
+
+void ControlBarriers::clear() {
+  entries.clear();
+  exits.clear();
+  entry_of.clear();
+  exit_of.clear();
+  num_edges = 0;
+}
+
+void ControlBarriers::swap(ControlBarriers& other) {
+  entries.swap(other.entries);
+  exits.swap(other.exits);
+  entry_of.swap(other.entry_of);
+  exit_of.swap(other.exit_of);
+  std::swap(num_edges, other.num_edges);
+}
+
+void ControlBarriers::addEntryEdge(unsigned branch, unsigned node) {
+  addMember(entries, entry_of, branch, node);
+}
+
+void ControlBarriers::addExitEdge(unsigned node, unsigned branch) {
+  addMember(exits, exit_of, branch, node);
+}
+
+bool ControlBarriers::hasEdge(unsigned from, unsigned to) const {
+  unsigned entry = barrierOf(entry_of, to);
+  if (entry != NONE && entries[entry].branch == from)
+    return true;
+  unsigned exit = barrierOf(exit_of, from);
+  return exit != NONE && exits[exit].branch == to;
+}
+
+void ControlBarriers::removeEdge(unsigned from, unsigned to) {
+  unsigned entry = barrierOf(entry_of, to);
+  if (entry != NONE && entries[entry].branch == from) {
+    removeMember(entries, entry_of, to);
+    return;
+  }
+  unsigned exit = barrierOf(exit_of, from);
+  if (exit != NONE && exits[exit].branch == to)
+    removeMember(exits, exit_of, from);
+}
+
+void ControlBarriers::removeNode(unsigned node_id) {
+  removeMember(entries, entry_of, node_id);
+  removeMember(exits, exit_of, node_id);
+  unsigned entry = findBarrier(entries, node_id);
+  if (entry != NONE)
+    removeAllMembers(entries, entry_of, entry);
+  unsigned exit = findBarrier(exits, node_id);
+  if (exit != NONE)
+    removeAllMembers(exits, exit_of, exit);
+}
+
+unsigned ControlBarriers::numParents(unsigned node_id) const {
+  unsigned num_parents = barrierOf(entry_of, node_id) != NONE ? 1 : 0;
+  unsigned exit = findBarrier(exits, node_id);
+  if (exit != NONE)
+    num_parents += exits[exit].num_members;
+  return num_parents;
+}
+
+unsigned ControlBarriers::numChildren(unsigned node_id) const {
+  unsigned num_children = barrierOf(exit_of, node_id) != NONE ? 1 : 0;
+  unsigned entry = findBarrier(entries, node_id);
+  if (entry != NONE)
+    num_children += entries[entry].num_members;
+  return num_children;
+}
+
+unsigned ControlBarriers::findBarrier(const std::vector<Barrier>& barriers,
+                                      unsigned branch) {
+  auto it = std::lower_bound(
+      barriers.begin(), barriers.end(), branch,
+      [](const Barrier& barrier, unsigned id) { return barrier.branch < id; });
+  if (it == barriers.end() || it->branch != branch)
+    return NONE;
+  return it - barriers.begin();
+}
+
+void ControlBarriers::addMember(std::vector<Barrier>& barriers,
+                                std::vector<unsigned>& member_of,
+                                unsigned branch,
+                                unsigned node) {
+  if (barriers.empty() || barriers.back().branch != branch) {
+    assert((barriers.empty() || barriers.back().branch < branch) &&
+           "Barriers must be added in node id order.");
+    barriers.emplace_back(branch, node);
+  }
+  if (member_of.size() <= node)
+    member_of.resize(node + 1, NONE);
+  assert(member_of[node] == NONE && "A node can only join one barrier.");
+  Barrier& barrier = barriers.back();
+  member_of[node] = barriers.size() - 1;
+  barrier.first = std::min(barrier.first, node);
+  barrier.last = std::max(barrier.last, node);
+  barrier.num_members++;
+  num_edges++;
+}
+
+void ControlBarriers::removeMember(std::vector<Barrier>& barriers,
+                                   std::vector<unsigned>& member_of,
+                                   unsigned node) {
+  unsigned index = barrierOf(member_of, node);
+  if (index == NONE)
+    return;
+  member_of[node] = NONE;
+  barriers[index].num_members--;
+  num_edges--;
+}
+
+void ControlBarriers::removeAllMembers(std::vector<Barrier>& barriers,
+                                       std::vector<unsigned>& member_of,
+                                       unsigned index) {
+  Barrier& barrier = barriers[index];
+  forEachMember(barrier, member_of, index,
+                [&](unsigned id) { member_of[id] = NONE; });
+  num_edges -= barrier.num_members;
+  barrier.num_members = 0;
+}
@@ -0,0 +1,126 @@
+#ifndef _CONTROL_BARRIERS_H_
+#define _CONTROL_BARRIERS_H_
+
+#include <vector>
+
+// Control dependences between a branch node and a range of node ids.
+//
+// Loop unrolling makes every node of an unrolled iteration depend on the
+// branch that starts the iteration, and the branch that ends it depend on
+// every node of the iteration. Stored as graph edges, these would be most of
+// the edges of the graph. Instead, a barrier records the branch and the range
+// of node ids that it orders, and each node records the barriers it belongs
+// to:
+//
+//   - An entry barrier is a branch that all of its members depend on.
+//   - An exit barrier is a branch that depends on all of its members.
+//
+// A node is a member of at most one entry and one exit barrier. Every member
+// implies one control edge to or from the branch, which behaves exactly like
+// a CONTROL_EDGE in the graph: it can be queried and removed on its own, and
+// removing a node from the graph also removes all of its implicit edges.
+class ControlBarriers {
+ public:
+  ControlBarriers() : num_edges(0) {}
+
+  void clear();
+  void swap(ControlBarriers& other);
+
+  // Add an implicit control edge from @branch to @node.
+  //
+  // Branches must be added in node id order, and all the members of one
+  // branch before those of the next.
+  void addEntryEdge(unsigned branch, unsigned node);
+  // Add an implicit control edge from @node to @branch. Same rules as above.
+  void addExitEdge(unsigned node, unsigned branch);
+
+  bool hasEdge(unsigned from, unsigned to) const;
+  void removeEdge(unsigned from, unsigned to);
+  // Remove all the implicit edges to and from @node_id.
+  void removeNode(unsigned node_id);
+
+  unsigned numParents(unsigned node_id) const;
+  unsigned numChildren(unsigned node_id) const;
+  unsigned numEdges() const { return num_edges; }
+
+  // Call @func with the id of every node that @node_id has an implicit edge
+  // to. The members of an entry barrier are visited in node id order.
+  template <typename Func>
+  void forEachChild(unsigned node_id, Func func) const {
+    unsigned entry = findBarrier(entries, node_id);
+    if (entry != NONE)
+      forEachMember(entries[entry], entry_of, entry, func);
+    unsigned exit = barrierOf(exit_of, node_id);
+    if (exit != NONE)
+      func(exits[exit].branch);
+  }
+
+  // Call @func with the id of every node that has an implicit edge to
+  // @node_id.
+  template <typename Func>
+  void forEachParent(unsigned node_id, Func func) const {
+    unsigned entry = barrierOf(entry_of, node_id);
+    if (entry != NONE)
+      func(entries[entry].branch);
+    unsigned exit = findBarrier(exits, node_id);
+    if (exit != NONE)
+      forEachMember(exits[exit], exit_of, exit, func);
+  }
+
+ private:
+  static const unsigned NONE = -1;
+
+  struct Barrier {
+    Barrier(unsigned _branch, unsigned member)
+        : branch(_branch), first(member), last(member), num_members(0) {}
+
+    unsigned branch;
+    // All members lie in [first, last], but not every node in it is one.
+    unsigned first;
+    unsigned last;
+    unsigned num_members;
+  };
+
+  static unsigned barrierOf(const std::vector<unsigned>& member_of,
+                            unsigned node_id) {
+    return node_id < member_of.size() ? member_of[node_id] : NONE;
+  }
+
+  // Return the index of the barrier of @branch, or NONE.
+  static unsigned findBarrier(const std::vector<Barrier>& barriers,
+                              unsigned branch);
+
+  template <typename Func>
+  static void forEachMember(const Barrier& barrier,
+                            const std::vector<unsigned>& member_of,
+                            unsigned index,
+                            Func func) {
+    if (barrier.num_members == 0)
+      return;
+    for (unsigned id = barrier.first; id <= barrier.last; id++) {
+      if (member_of[id] == index)
+        func(id);
+    }
+  }
+
+  void addMember(std::vector<Barrier>& barriers,
+                 std::vector<unsigned>& member_of,
+                 unsigned branch,
+                 unsigned node);
+  void removeMember(std::vector<Barrier>& barriers,
+                    std::vector<unsigned>& member_of,
+                    unsigned node);
+  void removeAllMembers(std::vector<Barrier>& barriers,
+                        std::vector<unsigned>& member_of,
+                        unsigned index);
+
+  // Sorted by branch node id.
+  std::vector<Barrier> entries;
+  std::vector<Barrier> exits;
+  // For each node id, the index of its entry and exit barrier, or NONE.
+  std::vector<unsigned> entry_of;
+  std::vector<unsigned> exit_of;
+  unsigned num_edges;
+};
+
+#endif
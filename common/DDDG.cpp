@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <cstring>
 #include <stdio.h>
 #include <sys/stat.h>
+#include <thread>
 
 #include <boost/tokenizer.hpp>
 
@@ -80,6 +82,11 @@ char* bytesToHexStr(uint8_t* data, int size, bool separate32) {
   return str_buf;
 }
 
+const unsigned RegisterRenamer::NO_WRITER;
+
+// Number of lines that are split in parallel at a time.
+static const size_t kLinesPerBatch = 1 << 16;
+
 // TODO: Eventual goal is to remove datapath as an argument entirely and rely
 // only on Program.
 DDDG::DDDG(BaseDatapath* _datapath, Program* _program, gzFile& _trace_file)
@@ -92,11 +99,16 @@ DDDG::DDDG(BaseDatapath* _datapath, Program* _program, gzFile& _trace_file)
   current_node_id = -1;
   last_parameter = 0;
   last_dma_fence = -1;
+  split_microop = 0;
+  timing_only = datapath->isTimingOnly();
   prev_bblock = "-1";
   curr_bblock = "-1";
   current_loop_depth = 0;
   callee_function = nullptr;
   last_ret = nullptr;
+  curr_node = nullptr;
+  curr_node_elided = false;
+  returned_function = false;
 }
 
 int DDDG::num_edges() {
@@ -109,9 +121,12 @@ int DDDG::num_of_memory_dependency() { return num_of_mem_dep; }
 int DDDG::num_of_control_dependency() { return num_of_ctrl_dep; }
 
 void DDDG::output_dddg() {
-  for (auto it = register_edge_table.begin(); it != register_edge_table.end();
+  // Walk the edges newest first, so that when an operand is read through
+  // several parameters of the same node, the last one parsed labels the edge.
+  for (auto it = register_edge_table.rbegin();
+       it != register_edge_table.rend();
        ++it) {
-    program->addEdge(it->first, it->second.sink_node, it->second.par_id);
+    program->addEdge(it->source_node, it->sink_node, it->par_id);
   }
 
   for (auto source_it = memory_edge_table.begin();
@@ -131,6 +146,9 @@ void DDDG::output_dddg() {
     for (unsigned sink_node : sink_list)
       program->addEdge(source, sink_node, CONTROL_EDGE);
   }
+
+  for (auto& edge : forwarded_edge_table)
+    program->addEdge(edge.source_node, edge.sink_node, edge.par_id);
 }
 
 void DDDG::handle_ready_bit_dependency(Addr start_addr,
@@ -153,8 +171,10 @@ void DDDG::handle_ready_bit_dependency(Addr start_addr,
       memory_edge_table[source_inst] = std::set<unsigned>();
     std::set<unsigned>& sink_list = memory_edge_table[source_inst];
     auto result = sink_list.insert(sink_node);
-    if (result.second)
+    if (result.second) {
       num_of_mem_dep++;
+      curr_parents.push_back(source_inst);
+    }
   }
 }
 
@@ -184,8 +204,10 @@ void DDDG::handle_post_write_dependency(Addr start_addr,
         // insertion will not happen, and insertion would require searching for
         // the place to place the new entry anyways.
         auto result = sink_list.insert(sink_node);
-        if (result.second)
+        if (result.second) {
           num_of_mem_dep++;
+          curr_parents.push_back(source_inst);
+        }
       }
     }
     addr++;
@@ -199,6 +221,8 @@ void DDDG::insert_control_dependence(unsigned source_node, unsigned dest_node) {
   auto result = dest_nodes.insert(dest_node);
   if (result.second)
     num_of_ctrl_dep++;
+  if (dest_node == (unsigned)current_node_id)
+    curr_control_parents.push_back(source_node);
 }
 
 // Find the original array corresponding to this array in the current function.
@@ -222,6 +246,8 @@ Variable* DDDG::get_array_real_var(Variable* var) {
 }
 
 MemAccess* DDDG::create_mem_access(Value& value) {
+  if (timing_only)
+    return new TimingMemAccess(value.getSize());
   if (value.getType() == Value::Vector) {
     VectorMemAccess* mem_access = new VectorMemAccess();
     mem_access->set_value(value.getVector());
@@ -269,19 +295,149 @@ void DDDG::parse_labelmap_line(const std::string& line) {
   }
 }
 
-void DDDG::parse_instruction_line(const std::string& line) {
-  char curr_static_function[256];
-  char instid[256], bblockid[256], bblockname[256];
-  int line_num;
-  int microop;
-  sscanf(line.c_str(),
-         "%d,%[^,],%[^,],%[^,],%d,%lu\n",
-         &line_num,
-         curr_static_function,
-         bblockid,
-         instid,
-         &microop,
-         &current_node_id);
+void DDDG::split_line(const std::string& tag,
+                      const std::string& line,
+                      uint8_t& microop,
+                      TraceLine& out,
+                      bool timing_only) {
+  char function[256] = "", bblockid[256] = "", bblockname[256] = "";
+  char instid[256] = "", value[256] = "", label[256] = "", prev_bbid[256] = "";
+  out.size = 0;
+  out.is_reg = 0;
+  if (tag.compare("0") == 0) {
+    out.type = TraceLine::Instruction;
+    out.microop = 0;
+    sscanf(line.c_str(),
+           "%d,%[^,],%[^,],%[^,],%d,%lu\n",
+           &out.line_num,
+           function,
+           bblockid,
+           instid,
+           &out.microop,
+           &out.node_id);
+    out.has_loop_depth =
+        sscanf(bblockid, "%[^:]:%u", bblockname, &out.loop_depth) == 2;
+    out.function = function;
+    out.bblock_id = bblockid;
+    out.bblock_name = bblockname;
+    out.instid = instid;
+    microop = out.microop;
+  } else if (tag.compare("r") == 0) {
+    out.type = TraceLine::Result;
+    sscanf(line.c_str(), "%d,%[^,],%d,%[^,],\n", &out.size, value,
+           &out.is_reg, label);
+    out.label = label;
+    out.value = Value(value, out.size, false, !timing_only);
+  } else if (tag.compare("f") == 0) {
+    out.type = TraceLine::Forward;
+    sscanf(line.c_str(), "%d,%*[^,],%d,%[^,],\n", &out.size, &out.is_reg,
+           label);
+    out.label = label;
+  } else if (tag.compare("entry") == 0) {
+    out.type = TraceLine::EntryDecl;
+    out.num_params = 0;
+    sscanf(line.c_str(), "%[^,],%d\n", function, &out.num_params);
+    out.function = function;
+    microop = LLVM_IR_EntryDecl;
+  } else {
+    out.type = TraceLine::Parameter;
+    out.param_tag = atoi(tag.c_str());
+    if (microop == LLVM_IR_PHI) {
+      sscanf(line.c_str(),
+             "%d,%[^,],%d,%[^,],%[^,],\n",
+             &out.size,
+             value,
+             &out.is_reg,
+             label,
+             prev_bbid);
+    } else {
+      sscanf(line.c_str(),
+             "%d,%[^,],%d,%[^,],\n",
+             &out.size,
+             value,
+             &out.is_reg,
+             label);
+    }
+    out.label = label;
+    out.prev_bbid = prev_bbid;
+    out.value = Value(
+        value,
+        out.size,
+        // Only the first argument of the setSamplingFactor function is a
+        // string.
+        out.param_tag == 1 && microop == LLVM_IR_SetSamplingFactor,
+        !timing_only);
+  }
+}
+
+void DDDG::apply_line(TraceLine& line) {
+  switch (line.type) {
+    case TraceLine::Instruction:
+      parse_instruction_line(line);
+      break;
+    case TraceLine::Parameter:
+      parse_parameter(line);
+      break;
+    case TraceLine::Result:
+      parse_result(line);
+      break;
+    case TraceLine::Forward:
+      parse_forward(line);
+      break;
+    case TraceLine::EntryDecl:
+      parse_entry_declaration(line);
+      break;
+  }
+}
+
+void DDDG::apply_lines(const std::vector<RawLine>& lines,
+                       unsigned num_threads) {
+  std::vector<TraceLine> split(lines.size());
+  // Every chunk but the first starts at an instruction or entry declaration,
+  // which sets the microop that the rest of the chunk is split against, so the
+  // chunks can be split independently.
+  std::vector<size_t> chunk_starts = { 0 };
+  size_t chunk_size = lines.size() / num_threads + 1;
+  for (size_t i = chunk_size; i < lines.size(); i++) {
+    const std::string& tag = lines[i].tag;
+    if (tag.compare("0") != 0 && tag.compare("entry") != 0)
+      continue;
+    if (i >= chunk_starts.back() + chunk_size)
+      chunk_starts.push_back(i);
+  }
+  chunk_starts.push_back(lines.size());
+
+  std::vector<uint8_t> end_microops(chunk_starts.size() - 1, split_microop);
+  auto split_chunk = [&](size_t chunk) {
+    uint8_t& microop = end_microops[chunk];
+    for (size_t i = chunk_starts[chunk]; i < chunk_starts[chunk + 1]; i++)
+      split_line(lines[i].tag, lines[i].line, microop, split[i], timing_only);
+  };
+  std::vector<std::thread> workers;
+  for (size_t chunk = 1; chunk < end_microops.size(); chunk++)
+    workers.push_back(std::thread(split_chunk, chunk));
+  split_chunk(0);
+  for (auto& worker : workers)
+    worker.join();
+  split_microop = end_microops.back();
+
+  for (auto& line : split)
+    apply_line(line);
+}
+
+void DDDG::parse_instruction_line(const TraceLine& line) {
+  const char* curr_static_function = line.function.c_str();
+  const std::string& instid = line.instid;
+  int microop = line.microop;
+  finish_node();
+  current_node_id = line.node_id;
+
+  // The previous instruction returned from a function, so nothing can refer to
+  // that invocation's registers anymore.
+  if (returned_function) {
+    register_renamer.pop_frame();
+    returned_function = false;
+  }
 
   num_of_instructions++;
   prev_microop = curr_microop;
@@ -289,7 +445,8 @@ void DDDG::parse_instruction_line(const std::string& line) {
   curr_instid = instid;
 
   // Update the current loop depth.
-  sscanf(bblockid, "%[^:]:%u", bblockname, &current_loop_depth);
+  if (line.has_loop_depth)
+    current_loop_depth = line.loop_depth;
   // If the loop depth is greater than 1000 within this function, we've
   // probably done something wrong.
   assert(current_loop_depth < 1000 &&
@@ -298,9 +455,17 @@ void DDDG::parse_instruction_line(const std::string& line) {
   Function* curr_function =
       srcManager.insert<Function>(curr_static_function);
   Instruction* curr_inst = srcManager.insert<Instruction>(curr_instid);
-  BasicBlock* basicblock = srcManager.insert<BasicBlock>(bblockname);
-  curr_node = program->insertNode(current_node_id, microop);
-  curr_node->set_line_num(line_num);
+  BasicBlock* basicblock = srcManager.insert<BasicBlock>(line.bblock_name);
+  ExecNode* node = new ExecNode(current_node_id, microop);
+  curr_node_elided = node->is_phi_op() || node->is_convert_op();
+  if (curr_node_elided) {
+    elided_node.reset(node);
+    forwarded_writer[current_node_id] = RegisterRenamer::NO_WRITER;
+    curr_node = node;
+  } else {
+    curr_node = program->insertNode(node);
+  }
+  curr_node->set_line_num(line.line_num);
   curr_node->set_static_inst(curr_inst);
   curr_node->set_static_function(curr_function);
   curr_node->set_basic_block(basicblock);
@@ -320,9 +485,19 @@ void DDDG::parse_instruction_line(const std::string& line) {
     for (auto node_id : nodes_since_last_ret)
       insert_control_dependence(node_id, current_node_id);
     nodes_since_last_ret.clear();
+    for (unsigned elided_id : elided_since_last_ret) {
+      unsigned writer = forwarded_writer.at(elided_id);
+      if (writer != RegisterRenamer::NO_WRITER) {
+        curr_forwarded_edges.push_back(
+            { writer, (unsigned)current_node_id, CONTROL_EDGE, elided_id });
+      }
+    }
+    elided_since_last_ret.clear();
     if (last_ret && last_ret != curr_node)
       insert_control_dependence(last_ret->get_node_id(), current_node_id);
     last_ret = curr_node;
+  } else if (curr_node_elided) {
+    elided_since_last_ret.push_back(current_node_id);
   } else if (!curr_node->is_dma_op()) {
     nodes_since_last_ret.push_back(current_node_id);
   }
@@ -336,6 +511,7 @@ void DDDG::parse_instruction_line(const std::string& line) {
         curr_function->increment_invocations();
         func_invocation_count = curr_function->get_invocations();
         active_method.push(DynamicFunction(curr_function));
+        register_renamer.push_frame();
         curr_dynamic_function = active_method.top();
       } else {
         func_invocation_count = prev_counts;
@@ -343,16 +519,21 @@ void DDDG::parse_instruction_line(const std::string& line) {
       }
       curr_func_found = true;
     }
-    if (microop == LLVM_IR_Ret)
+    if (microop == LLVM_IR_Ret) {
+      returned_function = true;
       active_method.pop();
+    }
   }
   if (!curr_func_found) {
     // This would only be true on a call.
     curr_function->increment_invocations();
     func_invocation_count = curr_function->get_invocations();
     active_method.push(DynamicFunction(curr_function));
+    register_renamer.push_frame();
     curr_dynamic_function = active_method.top();
   }
+  if (microop == LLVM_IR_Call)
+    register_renamer.begin_call();
   if (microop == LLVM_IR_PHI && prev_microop != LLVM_IR_PHI)
     prev_bblock = curr_bblock;
   if (microop == LLVM_IR_DMAFence) {
@@ -367,7 +548,7 @@ void DDDG::parse_instruction_line(const std::string& line) {
       insert_control_dependence(last_dma_fence, current_node_id);
     last_dma_nodes.push_back(current_node_id);
   }
-  curr_bblock = bblockid;
+  curr_bblock = line.bblock_id;
   curr_node->set_dynamic_invocation(func_invocation_count);
   last_parameter = false;
   parameter_value_per_inst.clear();
@@ -376,34 +557,14 @@ void DDDG::parse_instruction_line(const std::string& line) {
   func_caller_args.clear();
 }
 
-void DDDG::parse_parameter(const std::string& line, int param_tag) {
-  int size, is_reg;
-  char char_value[256];
-  char label[256], prev_bbid[256];
-  if (curr_microop == LLVM_IR_PHI) {
-    sscanf(line.c_str(),
-           "%d,%[^,],%d,%[^,],%[^,],\n",
-           &size,
-           char_value,
-           &is_reg,
-           label,
-           prev_bbid);
-    if (prev_bblock.compare(prev_bbid) != 0) {
-      return;
-    }
-  } else {
-    sscanf(line.c_str(),
-           "%d,%[^,],%d,%[^,],\n",
-           &size,
-           char_value,
-           &is_reg,
-           label);
-  }
-  Value value(
-      char_value,
-      size,
-      // Only the first argument of the setSamplingFactor function is a string.
-      param_tag == 1 && curr_microop == LLVM_IR_SetSamplingFactor);
+void DDDG::parse_parameter(TraceLine& line) {
+  if (curr_microop == LLVM_IR_PHI && prev_bblock.compare(line.prev_bbid) != 0)
+    return;
+  int param_tag = line.param_tag;
+  int size = line.size;
+  int is_reg = line.is_reg;
+  const char* label = line.label.c_str();
+  Value& value = line.value;
   if (curr_microop == LLVM_IR_EntryDecl) {
     if (value.getType() == Value::Ptr)
       datapath->addEntryArrayDecl(std::string(label), value);
@@ -425,8 +586,8 @@ void DDDG::parse_parameter(const std::string& line, int param_tag) {
   if (is_reg) {
     Variable* variable = srcManager.insert<Variable>(label);
     DynamicVariable unique_reg_ref(curr_dynamic_function, variable);
-    auto reg_it = register_last_written.find(unique_reg_ref);
-    bool found_reg_entry = reg_it != register_last_written.end();
+    unsigned& last_writer = register_renamer.last_writer(variable);
+    bool found_reg_entry = last_writer != RegisterRenamer::NO_WRITER;
     if (curr_microop == LLVM_IR_Call && param_tag != num_of_parameters) {
       // The first parameter on a call function block is the name of the
       // function itself, not an argument to the function.
@@ -435,21 +596,34 @@ void DDDG::parse_parameter(const std::string& line, int param_tag) {
       // argument.  The second element in the pair is the id of the last node
       // to write to this register, if such a node exists.
       unsigned last_node_to_modify =
-          found_reg_entry ? reg_it->second : current_node_id;
+          found_reg_entry ? last_writer : current_node_id;
       func_caller_args.push_back(
           FunctionCallerArg(param_tag, unique_reg_ref, last_node_to_modify, true));
     }
     // Find the instruction that writes the register
     if (found_reg_entry) {
       /*Find the last instruction that writes to the register*/
-      reg_edge_t tmp_edge = { (unsigned)current_node_id, param_tag };
-      register_edge_table.insert(std::make_pair(reg_it->second, tmp_edge));
-      num_of_reg_dep++;
+      auto elided_it = forwarded_writer.find(last_writer);
+      if (curr_node_elided) {
+        forwarded_writer[current_node_id] =
+            elided_it == forwarded_writer.end() ? last_writer
+                                                : elided_it->second;
+      } else if (elided_it == forwarded_writer.end()) {
+        register_edge_table.push_back(
+            { last_writer, (unsigned)current_node_id, param_tag });
+        curr_parents.push_back(last_writer);
+        num_of_reg_dep++;
+      } else if (elided_it->second != RegisterRenamer::NO_WRITER) {
+        curr_forwarded_edges.push_back({ elided_it->second,
+                                         (unsigned)current_node_id,
+                                         param_tag,
+                                         last_writer });
+      }
     } else if ((curr_microop == LLVM_IR_Store && param_tag == 2) ||
                (curr_microop == LLVM_IR_Load && param_tag == 1)) {
       /*For the load/store op without a gep instruction before, assuming the
        *load/store op performs a gep which writes to the label register*/
-      register_last_written[unique_reg_ref] = current_node_id;
+      last_writer = current_node_id;
     }
   } else {
     if (curr_microop == LLVM_IR_Call && param_tag != num_of_parameters) {
@@ -529,21 +703,17 @@ void DDDG::parse_parameter(const std::string& line, int param_tag) {
   }
 }
 
-void DDDG::parse_result(const std::string& line) {
-  int size, is_reg;
-  char char_value[256];
-  char label[256];
-
-  sscanf(line.c_str(), "%d,%[^,],%d,%[^,],\n", &size, char_value, &is_reg, label);
-  Value value(char_value, size);
-  std::string label_str(label);
+void DDDG::parse_result(TraceLine& line) {
+  int size = line.size;
+  int is_reg = line.is_reg;
+  Value& value = line.value;
+  const std::string& label_str = line.label;
 
   if (curr_node->is_fp_op() && (size == 64))
     curr_node->set_double_precision(true);
   assert(is_reg);
   Variable* var = srcManager.insert<Variable>(label_str);
-  DynamicVariable unique_reg_ref(curr_dynamic_function, var);
-  register_last_written[unique_reg_ref] = current_node_id;
+  register_renamer.last_writer(var) = current_node_id;
 
   if (curr_microop == LLVM_IR_Alloca) {
     curr_node->set_variable(srcManager.get<Variable>(label_str));
@@ -659,21 +829,17 @@ void DDDG::parse_result(const std::string& line) {
   }
 }
 
-void DDDG::parse_forward(const std::string& line) {
-  int size, is_reg;
-  char label_buf[256];
-
+void DDDG::parse_forward(const TraceLine& line) {
   // DMA and trig operations are not actually treated as called functions by
   // Aladdin, so there is no need to add any register name mappings.
   if (curr_node->is_host_mem_op() || curr_node->is_special_math_op() ||
       curr_node->is_set_sampling_factor())
     return;
 
-  sscanf(line.c_str(), "%d,%*[^,],%d,%[^,],\n", &size, &is_reg, label_buf);
-  assert(is_reg);
+  assert(line.is_reg);
 
   assert(curr_node->is_call_op());
-  Variable* var = srcManager.insert<Variable>(label_buf);
+  Variable* var = srcManager.insert<Variable>(line.label);
   DynamicVariable unique_reg_ref(callee_dynamic_function, var);
   // Create a mapping between registers in caller and callee functions.
   FunctionCallerArg arg;
@@ -689,20 +855,87 @@ void DDDG::parse_forward(const std::string& line) {
         << curr_node->get_node_id() << "!\n";
   }
   if (arg.is_reg) {
+    unsigned& last_writer = register_renamer.callee_last_writer(var);
     if (arg.dynvar) {
-      register_last_written[unique_reg_ref] = arg.last_node_to_modify;
+      last_writer = arg.last_node_to_modify;
     } else {
-      register_last_written[unique_reg_ref] = current_node_id;
+      last_writer = current_node_id;
     }
   }
 }
 
-void DDDG::parse_entry_declaration(const std::string& line) {
+void DDDG::resolve_forwarded_edges() {
+  // Removing an elided node would have replaced each of its edges with one
+  // from its forwarded writer, unless the writer already had an edge to the
+  // child. Elided nodes were removed latest first, and the type of an edge
+  // from one of them was that of its last register edge, if any.
+  std::vector<forwarded_edge_t> edges(curr_forwarded_edges.rbegin(),
+                                      curr_forwarded_edges.rend());
+  std::stable_sort(edges.begin(), edges.end(),
+                   [](const forwarded_edge_t& a, const forwarded_edge_t& b) {
+                     if (a.elided_node != b.elided_node)
+                       return a.elided_node > b.elided_node;
+                     return a.par_id != CONTROL_EDGE &&
+                            b.par_id == CONTROL_EDGE;
+                   });
+  std::vector<unsigned> sources(curr_parents);
+  sources.insert(sources.end(), curr_control_parents.begin(),
+                 curr_control_parents.end());
+  for (auto& edge : edges) {
+    if (edge.source_node == edge.sink_node ||
+        std::find(sources.begin(), sources.end(), edge.source_node) !=
+            sources.end())
+      continue;
+    sources.push_back(edge.source_node);
+    forwarded_edge_table.push_back(edge);
+    if (edge.par_id == CONTROL_EDGE) {
+      num_of_ctrl_dep++;
+    } else {
+      curr_parents.push_back(edge.source_node);
+      num_of_reg_dep++;
+    }
+  }
+  curr_forwarded_edges.clear();
+}
+
+void DDDG::finish_node() {
+  if (!curr_forwarded_edges.empty())
+    resolve_forwarded_edges();
+  ExecNode* node = curr_node_elided ? nullptr : curr_node;
+  if (node && !node->is_memory_op()) {
+    // A node is inductive if it updates an induction variable or if all of its
+    // parents are inductive. Inductive adds only compute indices, and
+    // multiplications by an inductive value can be done by a shifter.
+    bool all_inductive = true;
+    bool any_inductive = false;
+    if (!node->get_static_inst()->is_inductive()) {
+      for (unsigned parent_id : curr_parents) {
+        if (parent_id == node->get_node_id())
+          continue;
+        if (program->nodes.at(parent_id)->is_inductive())
+          any_inductive = true;
+        else
+          all_inductive = false;
+      }
+    }
+    if (all_inductive) {
+      node->set_inductive(true);
+      if (node->is_int_add_op())
+        node->set_microop(LLVM_IR_IndexAdd);
+      else if (node->is_int_mul_op())
+        node->set_microop(LLVM_IR_Shl);
+    } else if (any_inductive && node->is_int_mul_op()) {
+      node->set_microop(LLVM_IR_Shl);
+    }
+  }
+  curr_parents.clear();
+  curr_control_parents.clear();
+}
+
+void DDDG::parse_entry_declaration(const TraceLine& line) {
   curr_microop = LLVM_IR_EntryDecl;
-  char curr_static_function[256];
-  num_of_parameters = 0;
-  sscanf(line.c_str(), "%[^,],%d\n", curr_static_function, &num_of_parameters);
-  top_level_function_name = std::string(curr_static_function);
+  num_of_parameters = line.num_params;
+  top_level_function_name = line.function;
 }
 
 std::string DDDG::parse_function_name(const std::string& line) {
@@ -757,6 +990,13 @@ size_t DDDG::build_initial_dddg(size_t trace_off, size_t trace_size) {
   trace_progress.add_stat("nodes", &num_of_instructions);
   trace_progress.add_stat("bytes", &current_trace_off);
 
+  // Splitting lines into fields can be spread over several threads, but the
+  // split lines are always applied to the graph in trace order, so the result
+  // does not depend on the number of threads.
+  unsigned num_threads = datapath->getNumParseThreads();
+  TraceLine split;
+  std::vector<RawLine> pending;
+
   char buffer[256];
   std::string first_function;
   bool seen_first_line = false;
@@ -801,25 +1041,33 @@ size_t DDDG::build_initial_dddg(size_t trace_off, size_t trace_size) {
     labelmap_parsed_or_not_present = true;
     std::string tag = wholeline.substr(0, pos_end_tag);
     std::string line_left = wholeline.substr(pos_end_tag + 1);
-    if (tag.compare("0") == 0) {
+    bool starts_instruction = tag.compare("0") == 0;
+    if (starts_instruction) {
       if (!seen_first_line) {
         seen_first_line = true;
         first_function = parse_function_name(line_left);
       }
       first_function_returned = is_function_returned(line_left, first_function);
-      parse_instruction_line(line_left);
-    } else if (tag.compare("r") == 0) {
-      parse_result(line_left);
-    } else if (tag.compare("f") == 0) {
-      parse_forward(line_left);
-    } else if (tag.compare("entry") == 0) {
-      parse_entry_declaration(line_left);
-    } else {
-      parse_parameter(line_left, atoi(tag.c_str()));
     }
+    if (num_threads <= 1) {
+      split_line(tag, line_left, split_microop, split, timing_only);
+      apply_line(split);
+      continue;
+    }
+    // Hand the lines read so far to the worker threads, so that the next batch
+    // starts at an instruction.
+    if ((starts_instruction || tag.compare("entry") == 0) &&
+        pending.size() >= kLinesPerBatch) {
+      apply_lines(pending, num_threads);
+      pending.clear();
+    }
+    pending.push_back({ std::move(tag), std::move(line_left) });
   }
+  if (!pending.empty())
+    apply_lines(pending, num_threads);
 
   if (seen_first_line) {
+    finish_node();
     output_dddg();
 
     std::cout << "-------------------------------" << std::endl;
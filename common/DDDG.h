@@ -2,6 +2,7 @@
 #define __DDDG_H__
 
 #include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -10,7 +11,9 @@
 #include <zlib.h>
 #include <stdlib.h>
 #include <sstream>
+#include <vector>
 
+#include "DynamicEntity.h"
 #include "ExecNode.h"
 #include "file_func.h"
 #include "Program.h"
@@ -24,17 +27,125 @@
 #define PIPE_EDGE 12
 
 struct reg_edge_t {
+  unsigned source_node;
   unsigned sink_node;
   int par_id;
 };
 
+// An edge that replaces one from an elided PHI or convert node to its child.
+// It leaves the node whose register the elided node forwards.
+struct forwarded_edge_t {
+  unsigned source_node;
+  unsigned sink_node;
+  int par_id;
+  unsigned elided_node;
+};
+
 // data structure used to track dependency
 typedef std::unordered_map<std::string, unsigned int> string_to_uint;
 typedef std::unordered_map<Addr, unsigned int> uint_to_uint;
-typedef std::unordered_multimap<unsigned int, reg_edge_t>
-    multi_uint_to_reg_edge;
+typedef std::vector<reg_edge_t> reg_edge_list;
 typedef std::map<unsigned int, std::set<unsigned int>> map_uint_to_set;
 
+// Tracks the last node to write each register of the invocations that have
+// not returned yet, without hashing dynamic variables.
+//
+// Every variable gets a dense index the first time it is seen. Each
+// invocation has a frame that holds the last writer of each variable, indexed
+// by variable, and the frames form a stack that follows calls and returns.
+// A call prepares the frame of its callee so that its arguments can be
+// forwarded into it, the first instruction of the callee pushes that frame,
+// and the callee's return pops it. Frames are reused by later invocations at
+// the same depth, so stale entries are told apart by their generation rather
+// than cleared.
+class RegisterRenamer {
+ public:
+  // Last writer of a register that has not been written yet.
+  static const unsigned NO_WRITER = std::numeric_limits<unsigned>::max();
+
+  RegisterRenamer() : depth(0), callee_prepared(false) {}
+
+  // The id of the last node to write @var in the current invocation.
+  unsigned& last_writer(SrcTypes::Variable* var) {
+    assert(depth > 0 && "No function invocation is active!");
+    return last_writer(frames[depth - 1], var);
+  }
+
+  // The id of the last node to write @var in the invocation that the current
+  // call starts.
+  unsigned& callee_last_writer(SrcTypes::Variable* var) {
+    return last_writer(callee_frame(), var);
+  }
+
+  // Start a call with an empty frame for its callee.
+  void begin_call() {
+    callee_frame().generation++;
+    callee_prepared = true;
+  }
+
+  // Enter a new invocation. Its frame is the one prepared by the last call,
+  // if any.
+  void push_frame() {
+    Frame& frame = callee_frame();
+    if (!callee_prepared)
+      frame.generation++;
+    callee_prepared = false;
+    depth++;
+  }
+
+  // Leave the current invocation. None of its registers can be referenced
+  // again.
+  void pop_frame() {
+    assert(depth > 0 && "No function invocation is active!");
+    depth--;
+  }
+
+  // Number of distinct variables seen so far.
+  size_t num_variables() const { return var_index.size(); }
+
+ private:
+  struct Entry {
+    unsigned writer;
+    unsigned generation;
+  };
+
+  struct Frame {
+    Frame() : generation(0) {}
+    std::vector<Entry> entries;
+    // Entries from an earlier generation belong to an invocation that has
+    // returned.
+    unsigned generation;
+  };
+
+  Frame& callee_frame() {
+    if (frames.size() <= depth)
+      frames.resize(depth + 1);
+    return frames[depth];
+  }
+
+  unsigned& last_writer(Frame& frame, SrcTypes::Variable* var) {
+    unsigned index = var_index.insert({ var, var_index.size() }).first->second;
+    if (index >= frame.entries.size())
+      frame.entries.resize(index + 1, { NO_WRITER, 0 });
+    Entry& entry = frame.entries[index];
+    if (entry.generation != frame.generation) {
+      entry.writer = NO_WRITER;
+      entry.generation = frame.generation;
+    }
+    return entry.writer;
+  }
+
+  // Dense index of every variable seen so far.
+  std::unordered_map<SrcTypes::Variable*, unsigned> var_index;
+  // Frames of the active invocations, bottom first. frames[depth], if it
+  // exists, is the frame of the next invocation.
+  std::vector<Frame> frames;
+  unsigned depth;
+  // Whether the last call prepared frames[depth] and no invocation has
+  // started since.
+  bool callee_prepared;
+};
+
 class BaseDatapath;
 
 class FP2BitsConverter {
@@ -142,20 +253,38 @@ class Value {
       : vector_buf(std::move(other.vector_buf)), data_str(other.data_str),
         data(other.data), type(other.type), size(other.size) {}
 
-  Value(char* value_buf, unsigned _size, bool is_string = false) : size(_size / 8), vector_buf() {
-    createValue(value_buf, is_string);
+  // If @materialize is false, a vector value only records its size, since
+  // its bytes are only needed to model the data of memory accesses.
+  Value(char* value_buf,
+        unsigned _size,
+        bool is_string = false,
+        bool materialize = true)
+      : size(_size / 8), vector_buf() {
+    createValue(value_buf, is_string, materialize);
+  }
+
+  Value() : vector_buf(), type(Integer), size(0) { data.bits = 0; }
+
+  Value& operator=(Value&& other) {
+    vector_buf = std::move(other.vector_buf);
+    data_str = std::move(other.data_str);
+    data = other.data;
+    type = other.type;
+    size = other.size;
+    return *this;
   }
 
   ~Value() {}
 
-  void createValue(char* value_buf, bool is_string) {
+  void createValue(char* value_buf, bool is_string, bool materialize = true) {
     const std::string value_str(value_buf);
     if (is_string) {
       type = String;
       data_str = value_str;
     } else if (size > 8) {
       type = Vector;
-      vector_buf = std::unique_ptr<uint8_t>(hexStrToBytes(value_buf, size));
+      if (materialize)
+        vector_buf = std::unique_ptr<uint8_t>(hexStrToBytes(value_buf, size));
     } else if (value_str.find('.') != std::string::npos) {
       type = Float;
       if (size == 4) {
@@ -248,6 +377,44 @@ class Value {
   unsigned size;  // In bytes.
 };
 
+// A line of the trace, split into its fields.
+//
+// How a line is split depends only on the instruction it belongs to, not on
+// anything the DDDG has built so far, so lines can be split ahead of time on
+// other threads and applied to the DDDG in trace order afterwards.
+struct TraceLine {
+  enum Type { Instruction, Parameter, Result, Forward, EntryDecl };
+
+  TraceLine()
+      : type(Instruction), line_num(0), microop(0), node_id(0), loop_depth(0),
+        has_loop_depth(false), num_params(0), param_tag(0), size(0),
+        is_reg(0) {}
+
+  Type type;
+
+  // Instructions and entry declarations.
+  std::string function;
+  int line_num;
+  std::string bblock_id;
+  std::string bblock_name;
+  std::string instid;
+  int microop;
+  long node_id;
+  unsigned loop_depth;
+  // False if the basic block id does not encode a loop depth.
+  bool has_loop_depth;
+  int num_params;
+
+  // Parameters, results and forwarded arguments.
+  int param_tag;
+  int size;
+  int is_reg;
+  std::string label;
+  // For parameters of PHI nodes: the basic block the value comes from.
+  std::string prev_bbid;
+  Value value;
+};
+
 class DDDG {
  public:
   // Indicates that we have reached the end of the trace.
@@ -265,14 +432,40 @@ class DDDG {
     return top_level_function_name;
   }
 
+  // Split @line, whose tag (the first field) is @tag, into @out.
+  //
+  // @microop is the microop of the instruction that the line belongs to. It
+  // is updated when @line starts a new instruction or entry declaration. If
+  // @timing_only is true, vector values are not decoded.
+  static void split_line(const std::string& tag,
+                         const std::string& line,
+                         uint8_t& microop,
+                         TraceLine& out,
+                         bool timing_only = false);
+
  private:
-  void parse_instruction_line(const std::string& line);
-  void parse_parameter(const std::string& line, int param_tag);
-  void parse_result(const std::string& line);
-  void parse_forward(const std::string& line);
-  void parse_call_parameter(const std::string& line, int param_tag);
+  // A line read from the trace that has not been split yet.
+  struct RawLine {
+    std::string tag;
+    std::string line;
+  };
+
+  void apply_line(TraceLine& line);
+  // Split the lines in @lines on up to @num_threads threads, then apply them
+  // in order.
+  void apply_lines(const std::vector<RawLine>& lines, unsigned num_threads);
+
+  void parse_instruction_line(const TraceLine& line);
+  void parse_parameter(TraceLine& line);
+  void parse_result(TraceLine& line);
+  void parse_forward(const TraceLine& line);
   void parse_labelmap_line(const std::string& line);
-  void parse_entry_declaration(const std::string& line);
+  void parse_entry_declaration(const TraceLine& line);
+  // Called once every line of the current node has been parsed.
+  void finish_node();
+  // Keep the edges of curr_forwarded_edges that the current node would have
+  // had if the elided nodes had been added and removed afterwards.
+  void resolve_forwarded_edges();
   std::string parse_function_name(const std::string& line);
   bool is_function_returned(const std::string& line, std::string target_function);
 
@@ -298,9 +491,31 @@ class DDDG {
 
   uint8_t curr_microop;
   uint8_t prev_microop;
+  // The microop that the next line will be split against.
+  uint8_t split_microop;
+  // Whether the values of memory accesses are dropped (see
+  // UserConfigParams::timing_only).
+  bool timing_only;
   std::string prev_bblock;
   std::string curr_bblock;
   ExecNode* curr_node;
+  // PHI and convert nodes only forward a register to their children, so they
+  // are never added to the program. While one is parsed, curr_node points to
+  // this node instead.
+  std::unique_ptr<ExecNode> elided_node;
+  bool curr_node_elided;
+  // The first node that is not elided up the chain of each elided node, or
+  // NO_WRITER if there is none. Elided nodes remain the last writers of the
+  // registers they write, and their readers are redirected through this map.
+  std::unordered_map<unsigned, unsigned> forwarded_writer;
+  // Elided nodes since the last call or return.
+  std::vector<unsigned> elided_since_last_ret;
+  // Register and memory parents of the current node.
+  std::vector<unsigned> curr_parents;
+  // Sources of the control edges to the current node.
+  std::vector<unsigned> curr_control_parents;
+  // Edges to the current node from the writers its elided parents forward.
+  std::vector<forwarded_edge_t> curr_forwarded_edges;
 
   SrcTypes::Function* callee_function;
   SrcTypes::DynamicFunction callee_dynamic_function;
@@ -348,17 +563,23 @@ class DDDG {
   std::string trace_file_name;
   gzFile& trace_file;
 
-  // Register dependency tracking table.
-  multi_uint_to_reg_edge register_edge_table;
+  // Register dependency tracking table, in the order edges were found.
+  reg_edge_list register_edge_table;
   // Memory dependence tracking table.
   map_uint_to_set memory_edge_table;
   // Control edge tracking table.
   map_uint_to_set control_edge_table;
+  // Edges that replace those of elided nodes. They are added after all the
+  // others, so they never override the type of an edge that already exists.
+  std::vector<forwarded_edge_t> forwarded_edge_table;
 
   // keep track of currently executed methods
   std::stack<SrcTypes::DynamicFunction> active_method;
+  // Whether the last instruction was a return. Its invocation's registers are
+  // released once the Ret instruction has been fully parsed.
+  bool returned_function;
   // manage methods
-  std::unordered_map<SrcTypes::DynamicVariable, unsigned> register_last_written;
+  RegisterRenamer register_renamer;
   uint_to_uint address_last_written;
   uint_to_uint ready_bits_last_changed;
   // DMA nodes that have been seen since the last DMA fence.
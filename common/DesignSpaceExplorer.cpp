@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "DesignSpaceExplorer.h"
+
+using namespace SrcTypes;
+
+// True if a point with execution time @time_a and power @power_a dominates
+// one with @time_b and @power_b: it is at least (1 + slack) times better in
+// both, and strictly better in at least one of them.
+static bool dominates(
+    float time_a, float power_a, float time_b, float power_b, float slack) {
+  float scale = 1 + slack;
+  if (time_a * scale > time_b || power_a * scale > power_b)
+    return false;
+  return time_a < time_b || power_a < power_b;
+}
+
+std::string SweepDimension::name() const {
+  switch (kind) {
+    case Unrolling:
+      return "unrolling:" + function->get_name() + "/" + label->get_name();
+    case Partition:
+      return "partition:" + array;
+    case Pipelining:
+      return "pipelining";
+    case CycleTime:
+      return "cycle_time";
+  }
+  return "";
+}
+
+void DesignSpaceExplorer::explore() {
+  // Keep a pristine copy of every program and the configuration; every design
+  // point starts from these.
+  while (acc->buildDddg()) {
+    invocations.emplace_back();
+    invocations.back().program.copyFrom(acc->getProgram());
+    invocations.back().info = acc->getProgramInfo();
+    acc->clearDatapath();
+  }
+  if (invocations.empty()) {
+    std::cerr << "[ERROR]: The trace is empty, there is nothing to explore.\n";
+    exit(1);
+  }
+  base_params = acc->getUserParams();
+  parseSweep();
+  acc->setGraphCacheCapacity(graph_cache_capacity);
+  // Only the report is written.
+  acc->setQuiet(true);
+
+  unsigned max_values = 0;
+  for (auto& dim : dimensions)
+    max_values = std::max(max_values, (unsigned)dim.values.size());
+  unsigned stride = 1;
+  while (stride * 2 < max_values)
+    stride *= 2;
+
+  // Phase 1: coarse-to-fine search over the analytical estimates.
+  estimateGrid(stride);
+  while (true) {
+    refineEstimates(stride);
+    if (stride == 1)
+      break;
+    stride /= 2;
+  }
+
+  // Phase 2: schedule the surviving points, from fastest to slowest.
+  std::vector<DesignPoint*> frontier;
+  for (DesignPoint* point : getEstimatedFrontier()) {
+    float time_limit = 0;
+    for (DesignPoint* other : frontier) {
+      if (other->result.avg_power <= point->estimate.avg_power &&
+          (time_limit == 0 || other->getTime() < time_limit))
+        time_limit = other->getTime();
+    }
+    if (!schedule(*point, time_limit))
+      continue;
+    auto point_dominates = [](DesignPoint* a, DesignPoint* b) {
+      return dominates(a->getTime(), a->result.avg_power, b->getTime(),
+                       b->result.avg_power, 0);
+    };
+    bool dominated = false;
+    for (DesignPoint* other : frontier) {
+      if (point_dominates(other, point)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (dominated)
+      continue;
+    frontier.erase(std::remove_if(frontier.begin(),
+                                  frontier.end(),
+                                  [&](DesignPoint* other) {
+                                    return point_dominates(point, other);
+                                  }),
+                   frontier.end());
+    frontier.push_back(point);
+  }
+  for (DesignPoint* point : frontier)
+    point->on_frontier = true;
+  acc->setQuiet(false);
+
+  writeReport(std::cout);
+  std::ofstream report_file;
+  std::string file_name = acc->getBenchName() + "_frontier";
+  report_file.open(file_name.c_str(), std::ofstream::out);
+  writeReport(report_file);
+  report_file.close();
+}
+
+void DesignSpaceExplorer::parseSweep() {
+  std::ifstream sweep;
+  sweep.open(sweep_file, std::ifstream::in);
+  if (sweep.fail()) {
+    std::cerr << "[ERROR]: Failed to open the sweep file " << sweep_file
+              << ". Please verify the file exists and permissions are "
+                 "correct.\n";
+    exit(1);
+  }
+  SourceManager& srcManager = acc->get_source_manager();
+  std::string wholeline;
+  while (std::getline(sweep, wholeline)) {
+    if (wholeline.size() == 0 || wholeline[0] == '#')
+      continue;
+    std::vector<std::string> fields;
+    std::stringstream line_stream(wholeline);
+    std::string field;
+    while (std::getline(line_stream, field, ','))
+      fields.push_back(field);
+
+    const std::string& type = fields[0];
+    if (type == "prune_slack" && fields.size() == 2) {
+      prune_slack = stof(fields[1]);
+      continue;
+    }
+    if (type == "graph_cache" && fields.size() == 2) {
+      graph_cache_capacity = stoi(fields[1]);
+      continue;
+    }
+
+    SweepDimension dim;
+    unsigned first_value;
+    if (type == "unrolling" && fields.size() > 3) {
+      dim.kind = SweepDimension::Unrolling;
+      dim.function = srcManager.insert<Function>(fields[1]);
+      dim.label = srcManager.insert<Label>(fields[2]);
+      bool found = false;
+      for (auto& unroll : base_params.unrolling) {
+        if (unroll.first.get_function() == dim.function &&
+            unroll.first.get_label() == dim.label)
+          found = true;
+      }
+      if (!found) {
+        std::cerr << "[ERROR]: Loop " << fields[1] << "/" << fields[2]
+                  << " is swept but not unrolled by the base "
+                     "configuration.\n";
+        exit(1);
+      }
+      first_value = 3;
+    } else if (type == "partition" && fields.size() > 2) {
+      dim.kind = SweepDimension::Partition;
+      dim.array = fields[1];
+      auto part_it = base_params.partition.find(dim.array);
+      if (part_it == base_params.partition.end() ||
+          part_it->second.memory_type != spad ||
+          part_it->second.partition_type == complete) {
+        std::cerr << "[ERROR]: Array " << dim.array
+                  << " is swept but is not a cyclic or block partitioned "
+                     "scratchpad in the base configuration.\n";
+        exit(1);
+      }
+      first_value = 2;
+    } else if (type == "pipelining" && fields.size() > 1) {
+      dim.kind = SweepDimension::Pipelining;
+      first_value = 1;
+    } else if (type == "cycle_time" && fields.size() > 1) {
+      dim.kind = SweepDimension::CycleTime;
+      first_value = 1;
+    } else {
+      std::cerr << "[ERROR]: Invalid sweep line: " << wholeline << std::endl;
+      exit(1);
+    }
+    for (unsigned i = first_value; i < fields.size(); i++)
+      dim.values.push_back(stof(fields[i]));
+    dimensions.push_back(dim);
+  }
+  sweep.close();
+
+  if (dimensions.empty()) {
+    std::cerr << "[ERROR]: The sweep file " << sweep_file
+              << " does not sweep any parameters.\n";
+    exit(1);
+  }
+}
+
+UserConfigParams DesignSpaceExplorer::getConfig(
+    const point_index_t& index) const {
+  UserConfigParams params = base_params;
+  for (unsigned i = 0; i < dimensions.size(); i++) {
+    const SweepDimension& dim = dimensions[i];
+    float value = dim.values[index[i]];
+    switch (dim.kind) {
+      case SweepDimension::Unrolling:
+        for (auto& unroll : params.unrolling) {
+          if (unroll.first.get_function() == dim.function &&
+              unroll.first.get_label() == dim.label)
+            unroll.second = value;
+        }
+        // Inlined copies of the loop have their own entries.
+        for (auto& invocation : invocations) {
+          for (auto& inlined : invocation.program.inline_labelmap) {
+            const UniqueLabel& orig_label = inlined.second;
+            if (orig_label.get_function() == dim.function &&
+                orig_label.get_label() == dim.label &&
+                params.unrolling.find(inlined.first) !=
+                    params.unrolling.end())
+              params.unrolling[inlined.first] = value;
+          }
+        }
+        break;
+      case SweepDimension::Partition:
+        params.partition.at(dim.array).part_factor = value;
+        break;
+      case SweepDimension::Pipelining:
+        params.global_pipelining = (value != 0);
+        break;
+      case SweepDimension::CycleTime:
+        params.cycle_time = value;
+        break;
+    }
+  }
+  return params;
+}
+
+void DesignSpaceExplorer::accumulate(summary_data_t& total,
+                                     const summary_data_t& summary) {
+  int cycles = total.num_cycles + summary.num_cycles;
+  if (cycles > 0) {
+    total.avg_power = (total.avg_power * total.num_cycles +
+                       summary.avg_power * summary.num_cycles) /
+                      cycles;
+  }
+  total.num_cycles = cycles;
+  // The same hardware runs every invocation.
+  total.total_area = std::max(total.total_area, summary.total_area);
+}
+
+void DesignSpaceExplorer::estimate(DesignPoint& point) {
+  UserConfigParams params = getConfig(point.index);
+  point.cycle_time = params.cycle_time;
+  point.estimate = summary_data_t();
+  for (auto& invocation : invocations) {
+    acc->reconfigure(invocation.program, params, invocation.info);
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    acc->estimateStats();
+    accumulate(point.estimate, acc->getSummary());
+  }
+}
+
+bool DesignSpaceExplorer::schedule(DesignPoint& point, float time_limit) {
+  UserConfigParams params = getConfig(point.index);
+  point.result = summary_data_t();
+  for (auto& invocation : invocations) {
+    acc->reconfigure(invocation.program, params, invocation.info);
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {
+      float time =
+          (point.result.num_cycles + acc->getCurrentCycle()) * point.cycle_time;
+      if (time_limit != 0 && time > time_limit) {
+        std::cout << "Abandoned a design point dominated after " << time_limit
+                  << " ns." << std::endl;
+        point.status = DesignPoint::Abandoned;
+        return false;
+      }
+    }
+    acc->dumpStats();
+    accumulate(point.result, acc->getSummary());
+  }
+  point.status = DesignPoint::Scheduled;
+  return true;
+}
+
+void DesignSpaceExplorer::estimateGrid(unsigned stride) {
+  // Enumerate the grid like an odometer.
+  point_index_t index(dimensions.size(), 0);
+  while (true) {
+    if (points.find(index) == points.end()) {
+      DesignPoint& point = points[index];
+      point.index = index;
+      estimate(point);
+    }
+    unsigned i = 0;
+    for (; i < dimensions.size(); i++) {
+      unsigned last = dimensions[i].values.size() - 1;
+      if (index[i] < last) {
+        index[i] = std::min(index[i] + stride, last);
+        break;
+      }
+      index[i] = 0;
+    }
+    if (i == dimensions.size())
+      break;
+  }
+}
+
+void DesignSpaceExplorer::refineEstimates(unsigned stride) {
+  bool added = true;
+  while (added) {
+    added = false;
+    for (DesignPoint* point : getEstimatedFrontier()) {
+      for (unsigned i = 0; i < dimensions.size(); i++) {
+        for (int delta : { -(int)stride, (int)stride }) {
+          int neighbor_value = (int)point->index[i] + delta;
+          if (neighbor_value < 0 ||
+              neighbor_value >= (int)dimensions[i].values.size())
+            continue;
+          point_index_t neighbor = point->index;
+          neighbor[i] = neighbor_value;
+          if (points.find(neighbor) != points.end())
+            continue;
+          DesignPoint& new_point = points[neighbor];
+          new_point.index = neighbor;
+          estimate(new_point);
+          added = true;
+        }
+      }
+    }
+  }
+}
+
+std::vector<DesignPoint*> DesignSpaceExplorer::getEstimatedFrontier() {
+  std::vector<DesignPoint*> frontier;
+  for (auto& point : points) {
+    bool dominated = false;
+    for (auto& other : points) {
+      if (dominates(other.second.getEstimatedTime(),
+                    other.second.estimate.avg_power,
+                    point.second.getEstimatedTime(),
+                    point.second.estimate.avg_power,
+                    prune_slack)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (!dominated)
+      frontier.push_back(&point.second);
+  }
+  std::stable_sort(frontier.begin(), frontier.end(),
+                   [](const DesignPoint* a, const DesignPoint* b) {
+                     return a->getEstimatedTime() < b->getEstimatedTime();
+                   });
+  return frontier;
+}
+
+void DesignSpaceExplorer::writeReport(std::ostream& out) {
+  unsigned total_points = 1;
+  for (auto& dim : dimensions)
+    total_points *= dim.values.size();
+  unsigned num_scheduled = 0, num_abandoned = 0;
+  std::vector<const DesignPoint*> frontier, others;
+  for (auto& point : points) {
+    if (point.second.status == DesignPoint::Scheduled)
+      num_scheduled++;
+    else if (point.second.status == DesignPoint::Abandoned)
+      num_abandoned++;
+    if (point.second.on_frontier)
+      frontier.push_back(&point.second);
+    else
+      others.push_back(&point.second);
+  }
+  std::sort(frontier.begin(), frontier.end(),
+            [](const DesignPoint* a, const DesignPoint* b) {
+              return a->getTime() < b->getTime();
+            });
+
+  out << "===============================" << std::endl;
+  out << "     Aladdin Design Space      " << std::endl;
+  out << "===============================" << std::endl;
+  out << "Running : " << acc->getBenchName() << std::endl;
+  out << "Design points : " << total_points << std::endl;
+  out << "Estimated : " << points.size() << std::endl;
+  out << "Scheduled : " << num_scheduled << std::endl;
+  out << "Abandoned : " << num_abandoned << std::endl;
+  out << "Frontier : " << frontier.size() << std::endl;
+  const GraphCache& graph_cache = acc->getGraphCache();
+  out << "Graph cache hits : " << graph_cache.getHits() << " of "
+      << graph_cache.getHits() + graph_cache.getMisses() << " stages"
+      << std::endl;
+  out << "===============================" << std::endl;
+  out << "status";
+  for (auto& dim : dimensions)
+    out << "," << dim.name();
+  out << ",est_cycles,est_power,cycles,time,power,area" << std::endl;
+  for (auto& list : { frontier, others }) {
+    for (const DesignPoint* point : list) {
+      if (point->on_frontier)
+        out << "frontier";
+      else if (point->status == DesignPoint::Scheduled)
+        out << "dominated";
+      else if (point->status == DesignPoint::Abandoned)
+        out << "abandoned";
+      else
+        out << "pruned";
+      for (unsigned i = 0; i < dimensions.size(); i++)
+        out << "," << dimensions[i].values[point->index[i]];
+      out << "," << point->estimate.num_cycles << ","
+          << point->estimate.avg_power;
+      if (point->status == DesignPoint::Scheduled) {
+        out << "," << point->result.num_cycles << "," << point->getTime()
+            << "," << point->result.avg_power << ","
+            << point->result.total_area;
+      } else {
+        out << ",,,,";
+      }
+      out << std::endl;
+    }
+  }
+  out << "===============================" << std::endl;
+}
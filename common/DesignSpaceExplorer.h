@@ -0,0 +1,181 @@
+#ifndef __DESIGN_SPACE_EXPLORER__
+#define __DESIGN_SPACE_EXPLORER__
+
+/* An in-process design space explorer.
+ *
+ * Starting from the base configuration of a datapath, the explorer varies the
+ * parameters listed in a sweep file and searches for the Pareto frontier of
+ * execution time (cycles times the cycle time) and average power. The trace is
+ * parsed only once; every design point is optimized and scheduled from copies
+ * of the unoptimized programs of all the invocations in the trace. The cycles
+ * of a point are the sum over the invocations, its power is averaged over
+ * their cycles, and its area is the largest area of any invocation.
+ *
+ * The sweep file uses the same comma separated format as the configuration
+ * file, with one line per parameter followed by the values to try:
+ *
+ *   unrolling,<function>,<loop label>,<factor>,<factor>,...
+ *   partition,<array>,<factor>,<factor>,...
+ *   pipelining,0,1
+ *   cycle_time,<ns>,<ns>,...
+ *   prune_slack,<fraction>
+ *   graph_cache,<programs>
+ *
+ * Loops and arrays must already be declared in the base configuration; the
+ * sweep only changes their factors. Partitioned arrays keep the partition type
+ * of the base configuration.
+ *
+ * The search has two phases:
+ *
+ * 1. Every point on a coarse grid of the space is estimated analytically (see
+ *    BaseDatapath::estimateStats()). The grid is then refined around the
+ *    points whose estimates are not dominated by any other estimate, halving
+ *    the stride of each dimension until every neighbor of the estimated
+ *    frontier has been visited.
+ * 2. The points that survived the estimate are scheduled, in order of
+ *    increasing estimated execution time. A point is abandoned as soon as its
+ *    execution time passes that of an already scheduled frontier point whose
+ *    power is no higher than this point's estimated power.
+ *
+ * A point is dominated by another if it is no better in either time or power
+ * and worse in at least one. prune_slack (default 0) keeps points whose
+ * estimates are within the given fraction of the estimated frontier, to
+ * absorb the error of the estimate.
+ *
+ * Optimized programs are cached after every stage of graph optimizations (see
+ * BaseDatapath::runCachedStage()), so points that differ only in parameters
+ * that an optimization does not read share its result. graph_cache sets how
+ * many programs are kept (default 32, 0 disables the cache).
+ *
+ * The frontier and every evaluated point are written to <bench>_frontier.
+ */
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BaseDatapath.h"
+#include "Program.h"
+#include "ScratchpadDatapath.h"
+#include "SourceEntity.h"
+#include "user_config.h"
+
+// One configuration parameter to sweep and the values it takes.
+struct SweepDimension {
+  enum Kind { Unrolling, Partition, Pipelining, CycleTime };
+
+  Kind kind;
+  // The loop to unroll.
+  SrcTypes::Function* function;
+  SrcTypes::Label* label;
+  // The array to partition.
+  std::string array;
+  std::vector<float> values;
+
+  // A short name for reports, e.g. "unrolling:triad/loop".
+  std::string name() const;
+};
+
+// A design point is identified by the index of its value in each dimension.
+typedef std::vector<unsigned> point_index_t;
+
+struct DesignPoint {
+  enum Status {
+    // Only the analytical estimate is available.
+    Estimated,
+    // Scheduling was abandoned because the point was dominated.
+    Abandoned,
+    // Fully scheduled.
+    Scheduled,
+  };
+
+  DesignPoint() : status(Estimated), on_frontier(false), cycle_time(1) {}
+
+  // Execution time in ns.
+  float getEstimatedTime() const { return estimate.num_cycles * cycle_time; }
+  float getTime() const { return result.num_cycles * cycle_time; }
+
+  point_index_t index;
+  Status status;
+  bool on_frontier;
+  float cycle_time;
+  summary_data_t estimate;
+  summary_data_t result;
+};
+
+class DesignSpaceExplorer {
+ public:
+  DesignSpaceExplorer(ScratchpadDatapath* _acc, std::string _sweep_file)
+      : acc(_acc), sweep_file(_sweep_file), prune_slack(0),
+        graph_cache_capacity(32) {}
+  ~DesignSpaceExplorer() {
+    for (auto& invocation : invocations)
+      invocation.program.clear();
+  }
+
+  // Build the programs, search the design space and write the frontier
+  // report.
+  void explore();
+
+  // Access the results after explore().
+  const std::vector<SweepDimension>& getDimensions() const {
+    return dimensions;
+  }
+  const std::map<point_index_t, DesignPoint>& getDesignPoints() const {
+    return points;
+  }
+
+ protected:
+  // Parse the sweep file. Must be called after the program is built, so that
+  // the base configuration contains the line numbers of the loop labels.
+  void parseSweep();
+
+  // The base configuration with the values of @index applied.
+  UserConfigParams getConfig(const point_index_t& index) const;
+
+  // Optimize a copy of every program under the configuration of @point and
+  // estimate its cycles and power.
+  void estimate(DesignPoint& point);
+
+  // Optimize and schedule every invocation of @point. Scheduling stops early
+  // if the total execution time exceeds @time_limit ns (if nonzero). Returns
+  // true if scheduling completed.
+  bool schedule(DesignPoint& point, float time_limit);
+
+  // Add the results of one invocation, @summary, to @total.
+  static void accumulate(summary_data_t& total, const summary_data_t& summary);
+
+  // Estimate every point whose index in each dimension is a multiple of
+  // @stride or the last index.
+  void estimateGrid(unsigned stride);
+
+  // Estimate the neighbors at distance @stride of the points on the estimated
+  // frontier, until no new point is added.
+  void refineEstimates(unsigned stride);
+
+  // Points whose estimates are not dominated by another estimate by more than
+  // prune_slack, sorted by estimated execution time.
+  std::vector<DesignPoint*> getEstimatedFrontier();
+
+  void writeReport(std::ostream& out);
+
+  ScratchpadDatapath* acc;
+  std::string sweep_file;
+  std::vector<SweepDimension> dimensions;
+  float prune_slack;
+  unsigned graph_cache_capacity;
+
+  // The unoptimized program of each invocation.
+  struct Invocation {
+    Program program;
+    ProgramInfo info;
+  };
+  std::list<Invocation> invocations;
+  // The configuration the programs were built with.
+  UserConfigParams base_params;
+
+  std::map<point_index_t, DesignPoint> points;
+};
+
+#endif
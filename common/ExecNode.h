@@ -6,6 +6,7 @@
 #include <string>
 
 #include "MemoryType.h"
+#include "SpadAccessDescriptor.h"
 #include "opcode_func.h"
 #include "typedefs.h"
 #include "SourceEntity.h"
@@ -32,6 +33,9 @@ class MemAccess {
     // Obtain a pointer to the first byte of data.
     virtual uint8_t* data() = 0;
 
+    // Return a deep copy of this memory access.
+    virtual MemAccess* clone() const = 0;
+
     // Address read from the trace.
     Addr vaddr;
     // Size of the memory access in bytes.
@@ -49,6 +53,8 @@ class ScalarMemAccess : public MemAccess {
 
     virtual uint8_t* data() { return &value[0]; }
 
+    virtual MemAccess* clone() const { return new ScalarMemAccess(*this); }
+
     // Is this value a floating point value?
     bool is_float;
 
@@ -73,12 +79,35 @@ class VectorMemAccess : public MemAccess {
 
     virtual uint8_t* data() { return value; }
 
+    virtual MemAccess* clone() const {
+      VectorMemAccess* copy = new VectorMemAccess(*this);
+      if (value) {
+        copy->value = new uint8_t[size];
+        memcpy(copy->value, value, size);
+      }
+      return copy;
+    }
+
   protected:
     // A pointer to a dynamically allocated buffer. This mem access object is
     // responsible for cleaning it up.
     uint8_t* value;
 };
 
+// A memory access that does not keep its value, for timing only simulations.
+class TimingMemAccess : public MemAccess {
+  public:
+    TimingMemAccess(size_t _size) : MemAccess(0, _size) {}
+
+    virtual uint8_t* data() {
+      assert(false && "The values of memory accesses are not kept in "
+                      "timing_only mode!");
+      return nullptr;
+    }
+
+    virtual MemAccess* clone() const { return new TimingMemAccess(*this); }
+};
+
 class HostMemAccess : public MemAccess {
   protected:
    typedef SrcTypes::Variable Variable;
@@ -103,6 +132,12 @@ class HostMemAccess : public MemAccess {
      return nullptr;
    }
 
+   // dst_addr is a reference to vaddr, so the copy constructor cannot be used.
+   virtual MemAccess* clone() const {
+     return new HostMemAccess(
+         memory_type, dst_addr, src_addr, size, src_var, dst_var);
+   }
+
    MemoryType memory_type;
    Addr src_addr;
    Addr& dst_addr = MemAccess::vaddr;
@@ -122,6 +157,8 @@ class ReadyBitAccess : public MemAccess {
 
   virtual uint8_t* data() { return &value; }
 
+  virtual MemAccess* clone() const { return new ReadyBitAccess(*this); }
+
   // The array for the ready bits.
   Variable* array;
   // The value the ready bits will be set to: either 0 or 1.
@@ -134,18 +171,29 @@ class ExecNode {
 
  public:
   ExecNode(unsigned int _node_id, uint8_t _microop)
-      : node_id(_node_id), microop(_microop), dynamic_invocation(0),
+      : node_id(_node_id), microop(_microop),
+        traits(opcode_traits(_microop)), fu_latency(0), dynamic_invocation(0),
         line_num(-1), start_execution_cycle(-1), complete_execution_cycle(-1),
         dma_scheduling_delay_cycle(0), num_parents(0), isolated(true),
         inductive(false), dynamic_mem_op(false), double_precision(false),
-        array_label(""), partition_index(0), time_before_execution(0.0),
+        array_label(""), memory_op_type(MemoryOpType::NumMemoryOpTypes),
+        time_before_execution(0.0),
         mem_access(nullptr), static_inst(nullptr), static_function(nullptr),
-        variable(nullptr), vertex_assigned(false) {}
+        variable(nullptr), basic_block(nullptr), vertex_assigned(false) {}
 
   ~ExecNode() {
     if (mem_access)
       delete mem_access;
   }
+
+  // Return a deep copy of this node. The copy refers to the same vertex, so it
+  // is only meaningful within a copy of the graph this node belongs to.
+  ExecNode* clone() const {
+    ExecNode* copy = new ExecNode(*this);
+    if (mem_access)
+      copy->mem_access = mem_access->clone();
+    return copy;
+  }
   /* Compare two nodes based only on their node ids. */
   bool operator<(const ExecNode& other) const {
     return (node_id < other.get_node_id());
@@ -186,7 +234,9 @@ class ExecNode {
   bool is_double_precision() const { return double_precision; }
   bool has_vertex() const { return vertex_assigned; }
   const std::string& get_array_label() const { return array_label; }
-  unsigned get_partition_index() const { return partition_index; }
+  unsigned get_partition_index() const { return spad_access.part_index; }
+  const SpadAccessDescriptor& get_spad_access() const { return spad_access; }
+  MemoryOpType get_memory_op_type() const { return memory_op_type; }
   bool has_array_label() const { return (array_label.compare("") != 0); }
   MemAccess* get_mem_access() const { return mem_access; }
   ScalarMemAccess* get_scalar_mem_access() const {
@@ -206,7 +256,10 @@ class ExecNode {
   float get_time_before_execution() const { return time_before_execution; }
 
   /* Setters. */
-  void set_microop(uint8_t microop) { this->microop = microop; }
+  void set_microop(uint8_t microop) {
+    this->microop = microop;
+    traits = opcode_traits(microop);
+  }
   void set_variable(SrcTypes::Variable* var) { variable = var; }
   void set_static_function(SrcTypes::Function* func) {
     static_function = func;
@@ -238,7 +291,11 @@ class ExecNode {
     this->double_precision = double_precision;
   }
   void set_array_label(const std::string& label) { array_label = label; }
-  void set_partition_index(unsigned index) { partition_index = index; }
+  void set_partition_index(unsigned index) { spad_access.part_index = index; }
+  void set_spad_access(const SpadAccessDescriptor& access) {
+    spad_access = access;
+  }
+  void set_memory_op_type(MemoryOpType type) { memory_op_type = type; }
   void set_mem_access(MemAccess* mem_access) { this->mem_access = mem_access; }
   void set_host_mem_access(HostMemAccess* host_mem_access) {
     mem_access = host_mem_access;
@@ -265,11 +322,7 @@ class ExecNode {
   void decr_num_parents() { num_parents--; }
 
   /* Opcode functions. */
-  bool is_associative() const {
-    if (is_int_add_op() || is_fp_add_op())
-      return true;
-    return false;
-  }
+  bool is_associative() const { return traits & OPCODE_ASSOCIATIVE; }
 
   bool is_intrinsic_op() const { return microop == LLVM_IR_Intrinsic; }
 
@@ -277,84 +330,23 @@ class ExecNode {
     return microop == LLVM_IR_GetElementPtr;
   }
 
-  bool is_memory_op() const {
-    if (microop == LLVM_IR_Load || microop == LLVM_IR_Store)
-      return true;
-    return false;
-  }
+  bool is_memory_op() const { return traits & OPCODE_MEMORY; }
 
-  bool is_compute_op() const {
-    switch (microop) {
-      case LLVM_IR_Add:
-      case LLVM_IR_FAdd:
-      case LLVM_IR_Sub:
-      case LLVM_IR_FSub:
-      case LLVM_IR_Mul:
-      case LLVM_IR_FMul:
-      case LLVM_IR_UDiv:
-      case LLVM_IR_SDiv:
-      case LLVM_IR_FDiv:
-      case LLVM_IR_URem:
-      case LLVM_IR_SRem:
-      case LLVM_IR_FRem:
-      case LLVM_IR_Shl:
-      case LLVM_IR_LShr:
-      case LLVM_IR_AShr:
-      case LLVM_IR_And:
-      case LLVM_IR_Or:
-      case LLVM_IR_Xor:
-      case LLVM_IR_IndexAdd:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_compute_op() const { return traits & OPCODE_COMPUTE; }
 
-  bool is_store_op() const {
-    if (microop == LLVM_IR_Store)
-      return true;
-    return false;
-  }
+  bool is_store_op() const { return traits & OPCODE_STORE; }
 
-  bool is_load_op() const {
-    if (microop == LLVM_IR_Load)
-      return true;
-    return false;
-  }
+  bool is_load_op() const { return traits & OPCODE_LOAD; }
 
-  bool is_shifter_op() const {
-    if (microop == LLVM_IR_Shl || microop == LLVM_IR_LShr ||
-        microop == LLVM_IR_AShr)
-      return true;
-    return false;
-  }
+  bool is_shifter_op() const { return traits & OPCODE_SHIFTER; }
 
-  bool is_bit_op() const {
-    switch (microop) {
-      case LLVM_IR_And:
-      case LLVM_IR_Or:
-      case LLVM_IR_Xor:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_bit_op() const { return traits & OPCODE_BIT; }
 
-  bool is_control_op() const {
-    if (microop == LLVM_IR_PHI)
-      return true;
-    return is_branch_op();
-  }
+  bool is_control_op() const { return traits & OPCODE_CONTROL; }
 
-  bool is_branch_op() const {
-    if (microop == LLVM_IR_Br || microop == LLVM_IR_Switch)
-      return true;
-    return is_call_op();
-  }
+  bool is_branch_op() const { return traits & OPCODE_BRANCH; }
 
-  bool is_call_op() const {
-    return (microop == LLVM_IR_Call);
-  }
+  bool is_call_op() const { return traits & OPCODE_CALL; }
 
   bool is_ret_op() const {
     return (microop == LLVM_IR_Ret);
@@ -370,26 +362,7 @@ class ExecNode {
       return microop == LLVM_IR_PHI;
   }
 
-  bool is_convert_op() const {
-    switch (microop) {
-      case LLVM_IR_Trunc:
-      case LLVM_IR_ZExt:
-      case LLVM_IR_SExt:
-      case LLVM_IR_FPToUI:
-      case LLVM_IR_FPToSI:
-      case LLVM_IR_UIToFP:
-      case LLVM_IR_SIToFP:
-      case LLVM_IR_FPTrunc:
-      case LLVM_IR_FPExt:
-      case LLVM_IR_PtrToInt:
-      case LLVM_IR_IntToPtr:
-      case LLVM_IR_BitCast:
-      case LLVM_IR_AddrSpaceCast:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_convert_op() const { return traits & OPCODE_CONVERT; }
 
   bool is_dma_load() const {
     if (microop == LLVM_IR_DMALoad)
@@ -417,36 +390,16 @@ class ExecNode {
   bool is_host_store() const {
     return microop == LLVM_IR_DMAStore || microop == LLVM_IR_HostStore;
   }
-  bool is_host_mem_op() const {
-    return is_dma_op() || is_host_load() || is_host_store();
-  }
+  bool is_host_mem_op() const { return traits & OPCODE_HOST_MEMORY; }
 
   bool is_set_sampling_factor() const {
     return microop == LLVM_IR_SetSamplingFactor;
   }
 
-  bool is_int_mul_op() const {
-    switch (microop) {
-      case LLVM_IR_Mul:
-      case LLVM_IR_UDiv:  // TODO: Divides need special treatment.
-      case LLVM_IR_SDiv:
-      case LLVM_IR_URem:
-      case LLVM_IR_SRem:
-        return true;
-      default:
-        return false;
-    }
-  }
+  // TODO: Divides need special treatment.
+  bool is_int_mul_op() const { return traits & OPCODE_INT_MUL; }
 
-  bool is_int_add_op() const {
-    switch (microop) {
-      case LLVM_IR_Add:
-      case LLVM_IR_Sub:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_int_add_op() const { return traits & OPCODE_INT_ADD; }
 
   /* Node latency for functional units. Should only be called for non-memory
    * operations.
@@ -541,59 +494,27 @@ class ExecNode {
     }
   }
 
-  bool is_multicycle_op() const { return is_fp_op() || is_special_math_op(); }
-
-  bool is_fp_op() const {
-    switch (microop) {
-      case LLVM_IR_FAdd:
-      case LLVM_IR_FSub:
-      case LLVM_IR_FMul:
-      case LLVM_IR_FDiv:
-      case LLVM_IR_FRem:
-        return true;
-      default:
-        return false;
-    }
+  /* Remember fu_node_latency(@cycle_time) for get_fu_node_latency(). Called
+   * for every node by prepareForScheduling(), so that the scheduler does not
+   * evaluate it for every edge. */
+  void cache_fu_node_latency(float cycle_time) {
+    fu_latency = fu_node_latency(cycle_time);
   }
+  /* The latency cached by the last cache_fu_node_latency(). */
+  float get_fu_node_latency() const { return fu_latency; }
 
-  bool is_fp_mul_op() const {
-    switch (microop) {
-      case LLVM_IR_FMul:
-      case LLVM_IR_FDiv:  // TODO: Remove once we have a divider model.
-      case LLVM_IR_FRem:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_multicycle_op() const { return traits & OPCODE_MULTICYCLE; }
 
-  bool is_fp_div_op() const {
-    switch (microop) {
-      case LLVM_IR_FDiv:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_fp_op() const { return traits & OPCODE_FP; }
 
-  bool is_fp_add_op() const {
-    switch (microop) {
-      case LLVM_IR_FAdd:
-      case LLVM_IR_FSub:
-        return true;
-      default:
-        return false;
-    }
-  }
+  // TODO: Remove FDiv once we have a divider model.
+  bool is_fp_mul_op() const { return traits & OPCODE_FP_MUL; }
 
-  bool is_special_math_op() const {
-    switch (microop) {
-      case LLVM_IR_SpecialMathOp:
-        return true;
-      default:
-        return false;
-    }
-  }
+  bool is_fp_div_op() const { return traits & OPCODE_FP_DIV; }
+
+  bool is_fp_add_op() const { return traits & OPCODE_FP_ADD; }
+
+  bool is_special_math_op() const { return traits & OPCODE_SPECIAL_MATH; }
 
   unsigned get_multicycle_latency() const {
     if (is_fp_op())
@@ -634,6 +555,10 @@ class ExecNode {
   unsigned int node_id;
   /* Micro opcode. */
   uint8_t microop;
+  /* The OpcodeTrait bits of the microop. */
+  uint32_t traits;
+  /* Functional unit latency at the cycle time being scheduled. */
+  float fu_latency;
   /* This node came from the ith invocation of the parent function. */
   unsigned int dynamic_invocation;
   /* Corresponding line number from source code. */
@@ -657,7 +582,7 @@ class ExecNode {
    *
    * NOTE: This property is NOT safe to check before calling
    * prepareForScheduling(), because it is initialized to true for all nodes.
-   * Instead, use boost::degree(node->get_vertex, graph_).
+   * Instead, use Program::getDegree(node).
    */
   bool isolated;
   /* True if this node is inductive or has only inductive parents. */
@@ -668,8 +593,12 @@ class ExecNode {
   bool double_precision;
   /* Name of the array being accessed if this is a memory operation. */
   std::string array_label;
-  /* Index of the partitioned scratchpad being accessed. */
-  unsigned partition_index;
+  /* The partitioned scratchpad being accessed, including the partition
+   * index. */
+  SpadAccessDescriptor spad_access;
+  /* Which memory services this node, resolved by the datapath along with
+   * spad_access. NumMemoryOpTypes if the datapath does not model it. */
+  MemoryOpType memory_op_type;
   /* Elapsed time before this node executes. Can be a fraction of a cycle.
    * TODO: Maybe refactor this so it's only part of ScratchpadDatapath
    * specifically. Something like a member class that can be extended.
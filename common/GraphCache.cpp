@@ -0,0 +1,41 @@
+#include "GraphCache.h"
+
+void GraphCache::setCapacity(unsigned _capacity) {
+  capacity = _capacity;
+  while (entries.size() > capacity) {
+    index.erase(entries.back().first);
+    entries.back().second->clear();
+    delete entries.back().second;
+    entries.pop_back();
+  }
+}
+
+const Program* GraphCache::find(size_t key) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    misses++;
+    return nullptr;
+  }
+  hits++;
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->second;
+}
+
+void GraphCache::insert(size_t key, const Program& program) {
+  if (capacity == 0 || index.find(key) != index.end())
+    return;
+  Program* copy = new Program();
+  copy->copyFrom(program);
+  entries.emplace_front(key, copy);
+  index[key] = entries.begin();
+  setCapacity(capacity);
+}
+
+void GraphCache::clear() {
+  for (auto& entry : entries) {
+    entry.second->clear();
+    delete entry.second;
+  }
+  entries.clear();
+  index.clear();
+}
@@ -0,0 +1,48 @@
+#ifndef __GRAPH_CACHE_H__
+#define __GRAPH_CACHE_H__
+
+#include <list>
+#include <unordered_map>
+
+#include "Program.h"
+
+// A least recently used cache of programs.
+//
+// The datapath stores the program after each graph optimization under a key
+// that combines the key of the program it started from and the configuration
+// fields the optimization read. When the same optimizations are applied to the
+// same program under a configuration that differs only in fields they do not
+// read, the stored programs are restored instead of optimizing again.
+class GraphCache {
+ public:
+  GraphCache() : capacity(0), hits(0), misses(0) {}
+  ~GraphCache() { clear(); }
+
+  // Keep at most @capacity programs. 0 disables the cache.
+  void setCapacity(unsigned _capacity);
+  bool isEnabled() const { return capacity > 0; }
+
+  // Return the program stored under @key, or nullptr if there is none.
+  const Program* find(size_t key);
+
+  // Store a copy of @program under @key, evicting the least recently used
+  // program if the cache is full.
+  void insert(size_t key, const Program& program);
+
+  void clear();
+
+  unsigned getHits() const { return hits; }
+  unsigned getMisses() const { return misses; }
+
+ private:
+  typedef std::list<std::pair<size_t, Program*>> entry_list_t;
+
+  unsigned capacity;
+  unsigned hits;
+  unsigned misses;
+  // Most recently used first.
+  entry_list_t entries;
+  std::unordered_map<size_t, entry_list_t::iterator> index;
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <unordered_map>
+
+#include "DDDG.h"
+#include "GraphExporter.h"
+
+using namespace SrcTypes;
+
+static const char kBinaryMagic[8] = { 'A', 'L', 'A', 'D', 'G', 'R', 'P', 'H' };
+
+void GraphExporter::selectNodes(unsigned first, unsigned last) {
+  has_selection = true;
+  for (auto it = program.nodes.lower_bound(first);
+       it != program.nodes.end() && it->first <= last;
+       ++it) {
+    selected.push_back(it->first);
+  }
+}
+
+bool GraphExporter::selectLoop(const UniqueLabel& label, int iteration) {
+  std::list<cnode_pair_t> bounds = program.findLoopBoundaries(label);
+  int i = 0;
+  bool found = false;
+  for (auto& bound : bounds) {
+    if (iteration == -1 || iteration == i) {
+      selectNodes(bound.first->get_node_id(), bound.second->get_node_id());
+      found = true;
+    }
+    i++;
+  }
+  return found;
+}
+
+bool GraphExporter::selectFunction(Function* func, int invocation) {
+  std::list<cnode_pair_t> bounds = program.findFunctionBoundaries(func);
+  int i = 0;
+  bool found = false;
+  for (auto& bound : bounds) {
+    if (invocation == -1 || invocation == i) {
+      selectNodes(bound.first->get_node_id(), bound.second->get_node_id());
+      found = true;
+    }
+    i++;
+  }
+  return found;
+}
+
+void GraphExporter::selectNeighborhood(unsigned root,
+                                       unsigned radius,
+                                       unsigned max_nodes,
+                                       int max_node_id,
+                                       bool follow_branches) {
+  has_selection = true;
+  if (max_nodes == 0 || !program.nodeExists(root))
+    return;
+
+  // Node id -> distance from the root, for every node visited so far.
+  std::unordered_map<unsigned, unsigned> distance;
+  std::deque<unsigned> queue;
+  distance[root] = 0;
+  queue.push_back(root);
+  selected.push_back(root);
+  unsigned num_selected = 1;
+
+  auto visit = [&](unsigned child_id, unsigned child_distance) {
+    if (num_selected >= max_nodes)
+      return;
+    if (max_node_id != -1 && child_id > (unsigned)max_node_id)
+      return;
+    if (!distance.insert(std::make_pair(child_id, child_distance)).second)
+      return;
+    selected.push_back(child_id);
+    num_selected++;
+    queue.push_back(child_id);
+  };
+
+  while (!queue.empty() && num_selected < max_nodes) {
+    unsigned node_id = queue.front();
+    queue.pop_front();
+    unsigned node_distance = distance[node_id];
+    if (node_distance >= radius)
+      continue;
+    const ExecNode* node = program.nodes.at(node_id);
+    if (node_id != root && !follow_branches &&
+        (node->is_branch_op() || node->is_call_op()))
+      continue;
+
+    out_edge_iter out_edge_it, out_edge_end;
+    for (boost::tie(out_edge_it, out_edge_end) =
+             out_edges(node->get_vertex(), program.graph);
+         out_edge_it != out_edge_end;
+         ++out_edge_it) {
+      visit(program.atVertex(target(*out_edge_it, program.graph)),
+            node_distance + 1);
+    }
+    program.barriers.forEachChild(node_id, [&](unsigned child_id) {
+      visit(child_id, node_distance + 1);
+    });
+  }
+}
+
+void GraphExporter::finalizeSelection() {
+  std::sort(selected.begin(), selected.end());
+  selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+}
+
+bool GraphExporter::isSelected(unsigned node_id) const {
+  if (!has_selection)
+    return true;
+  return std::binary_search(selected.begin(), selected.end(), node_id);
+}
+
+template <typename Func> void GraphExporter::forEachNode(Func func) const {
+  if (!has_selection) {
+    for (auto& node_pair : program.nodes)
+      func(node_pair.second);
+  } else {
+    for (unsigned node_id : selected)
+      func(program.nodes.at(node_id));
+  }
+}
+
+template <typename Func>
+void GraphExporter::forEachEdge(const ExecNode* node, Func func) const {
+  unsigned node_id = node->get_node_id();
+  auto edge_to_parid = get(boost::edge_name, program.graph);
+  out_edge_iter out_edge_it, out_edge_end;
+  for (boost::tie(out_edge_it, out_edge_end) =
+           out_edges(node->get_vertex(), program.graph);
+       out_edge_it != out_edge_end;
+       ++out_edge_it) {
+    unsigned child_id = program.atVertex(target(*out_edge_it, program.graph));
+    if (isSelected(child_id))
+      func(node_id, child_id, (int)edge_to_parid[*out_edge_it]);
+  }
+  program.barriers.forEachChild(node_id, [&](unsigned child_id) {
+    if (isSelected(child_id))
+      func(node_id, child_id, CONTROL_EDGE);
+  });
+}
+
+unsigned GraphExporter::write(std::ostream& out, Format format) {
+  finalizeSelection();
+  switch (format) {
+    case Graphviz:
+      writeGraphviz(out);
+      break;
+    case Csv:
+      writeCsv(out);
+      break;
+    case Binary:
+      writeBinary(out);
+      break;
+  }
+  return has_selection ? selected.size() : program.nodes.size();
+}
+
+unsigned GraphExporter::write(const std::string& file_name,
+                              Format format,
+                              bool append) {
+  std::ios_base::openmode mode = std::ofstream::out;
+  if (append)
+    mode |= std::ofstream::app;
+  if (format == Binary)
+    mode |= std::ofstream::binary;
+  std::ofstream out(file_name, mode);
+  if (!out.is_open()) {
+    std::cerr << "[ERROR]: Cannot open " << file_name << " for writing.\n";
+    exit(1);
+  }
+  return write(out, format);
+}
+
+void GraphExporter::writeGraphviz(std::ostream& out) {
+  out << "digraph G {\n";
+  forEachNode([&](const ExecNode* node) {
+    out << "  " << node->get_node_id() << " [label=\"" << node->get_node_id()
+        << "\\n(" << node->get_microop_name() << ")\"];\n";
+  });
+  forEachNode([&](const ExecNode* node) {
+    forEachEdge(node, [&](unsigned from, unsigned to, int parid) {
+      out << "  " << from << "->" << to;
+      if (parid == CONTROL_EDGE)
+        out << " [style=dashed]";
+      out << ";\n";
+    });
+  });
+  out << "}\n";
+}
+
+void GraphExporter::writeCsv(std::ostream& out) {
+  out << "from,to,parid\n";
+  forEachNode([&](const ExecNode* node) {
+    forEachEdge(node, [&](unsigned from, unsigned to, int parid) {
+      out << from << "," << to << "," << parid << "\n";
+    });
+  });
+}
+
+void GraphExporter::writeBinary(std::ostream& out) {
+  auto put = [&](int32_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  uint32_t num_nodes = 0;
+  uint32_t num_edges = 0;
+  forEachNode([&](const ExecNode* node) {
+    num_nodes++;
+    forEachEdge(node, [&](unsigned, unsigned, int) { num_edges++; });
+  });
+
+  out.write(kBinaryMagic, sizeof(kBinaryMagic));
+  put(num_nodes);
+  put(num_edges);
+  forEachNode([&](const ExecNode* node) {
+    put(node->get_node_id());
+    put(node->get_microop());
+    put(node->get_start_execution_cycle());
+    put(node->get_complete_execution_cycle());
+  });
+  forEachNode([&](const ExecNode* node) {
+    forEachEdge(node, [&](unsigned from, unsigned to, int parid) {
+      put(from);
+      put(to);
+      put(parid);
+    });
+  });
+}
+
+bool GraphExporter::parseFormat(const std::string& name, Format& format) {
+  if (name == "dot") {
+    format = Graphviz;
+  } else if (name == "csv") {
+    format = Csv;
+  } else if (name == "bin") {
+    format = Binary;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string GraphExporter::getExtension(Format format) {
+  switch (format) {
+    case Graphviz:
+      return ".dot";
+    case Csv:
+      return ".csv";
+    case Binary:
+      return ".bin";
+  }
+  return "";
+}
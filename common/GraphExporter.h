@@ -0,0 +1,97 @@
+#ifndef _GRAPH_EXPORTER_H_
+#define _GRAPH_EXPORTER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Program.h"
+#include "SourceEntity.h"
+
+/* Writes a region of a program's graph to a file.
+ *
+ * The region is the union of everything selected with the select*() methods:
+ * ranges of node ids, iterations of a loop, invocations of a function, or the
+ * nodes reachable from a root within some number of edges. If nothing is
+ * selected, the whole graph is written. Every edge between two selected nodes
+ * is written, including the implicit control edges of the barriers.
+ *
+ * The nodes and edges are written straight from the program as they are
+ * visited, so the cost of an export is proportional to the size of the
+ * region, not of the graph.
+ *
+ * Formats:
+ *   Graphviz: a dot digraph whose vertices are named by node id and labeled
+ *             with the node id and microop. Control edges are dashed.
+ *   Csv:      an edge list, with the header "from,to,parid".
+ *   Binary:   the magic "ALADGRPH", the number of nodes and of edges, then
+ *             for each node its id, microop, start and complete cycle, and
+ *             for each edge its source, target and parid. All numbers are
+ *             int32 in host byte order.
+ */
+class GraphExporter {
+ public:
+  enum Format { Graphviz, Csv, Binary };
+
+  GraphExporter(const Program& _program)
+      : program(_program), has_selection(false) {}
+
+  // Select the nodes with ids in [first, last].
+  void selectNodes(unsigned first, unsigned last);
+
+  // Select the @iteration-th iteration of the loop @label, or all of them if
+  // @iteration is -1. Return false if there is no such iteration.
+  bool selectLoop(const SrcTypes::UniqueLabel& label, int iteration = -1);
+
+  // Select the @invocation-th invocation of @func, or all of them if
+  // @invocation is -1. Return false if there is no such invocation.
+  bool selectFunction(SrcTypes::Function* func, int invocation = -1);
+
+  // Select @root and the nodes reachable from it over at most @radius edges,
+  // visited breadth first, until @max_nodes nodes are selected. Nodes with ids
+  // above @max_node_id are not visited, unless it is -1. The children of
+  // branches and calls other than @root are only visited if
+  // @follow_branches is set, as they tend to have very many.
+  void selectNeighborhood(unsigned root,
+                          unsigned radius,
+                          unsigned max_nodes,
+                          int max_node_id,
+                          bool follow_branches);
+
+  // Write the selected region to @out and return the number of nodes
+  // written.
+  unsigned write(std::ostream& out, Format format);
+  // Write the selected region to @file_name, appending if @append is set.
+  unsigned write(const std::string& file_name,
+                 Format format,
+                 bool append = false);
+
+  // Parse the name of a format ("dot", "csv" or "bin"). Return false if it is
+  // not one.
+  static bool parseFormat(const std::string& name, Format& format);
+  // The file extension of @format, including the dot.
+  static std::string getExtension(Format format);
+
+ private:
+  // Sort and deduplicate the selection.
+  void finalizeSelection();
+  bool isSelected(unsigned node_id) const;
+
+  template <typename Func> void forEachNode(Func func) const;
+  // Call @func(from, to, parid) for every edge from @node to a selected node.
+  template <typename Func>
+  void forEachEdge(const ExecNode* node, Func func) const;
+
+  void writeGraphviz(std::ostream& out);
+  void writeCsv(std::ostream& out);
+  void writeBinary(std::ostream& out);
+
+  const Program& program;
+  // The ids of the selected nodes. Sorted and unique after
+  // finalizeSelection().
+  std::vector<unsigned> selected;
+  // False until something is selected, which means the whole graph.
+  bool has_selection;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include <thread>
+
+#include "InvocationPipeline.h"
+#include "Profiler.h"
+
+InvocationPipeline::InvocationPipeline(ScratchpadDatapath* _acc,
+                                       const std::string& bench,
+                                       const std::string& trace_file,
+                                       const std::string& config_file)
+    : acc(_acc),
+      front(new ScratchpadDatapath(bench, trace_file, config_file)),
+      overlapped(std::thread::hardware_concurrency() != 1) {}
+
+void InvocationPipeline::run(bool estimate_only) {
+  Profiler& profiler = acc->getProfiler();
+  front->getProfiler().setEnabled(profiler.isEnabled());
+
+  bool built = buildNext();
+  while (built) {
+    acc->adoptProgram(*front);
+    front->clearDatapath();
+    if (overlapped) {
+      std::thread builder([this, &built]() { built = buildNext(); });
+      schedule(estimate_only);
+      builder.join();
+    } else {
+      schedule(estimate_only);
+      built = buildNext();
+    }
+  }
+
+  profiler.merge(front->getProfiler());
+  front->getProfiler().clear();
+}
+
+bool InvocationPipeline::buildNext() {
+  if (!front->buildDddg())
+    return false;
+  Profiler::Phase phase(front->getProfiler(), "globalOptimizationPass");
+  front->optimizeGraph();
+  const Program& program = front->getProgram();
+  phase.setWork(program.nodes.size(), boost::num_edges(program.graph));
+  return true;
+}
+
+void InvocationPipeline::schedule(bool estimate_only) {
+  acc->assignMemories();
+  acc->prepareForScheduling();
+  if (estimate_only) {
+    acc->estimateStats();
+  } else {
+    while (!acc->step()) {
+    }
+    acc->dumpStats();
+  }
+  acc->clearDatapath();
+}
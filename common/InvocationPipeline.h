@@ -0,0 +1,64 @@
+#ifndef __INVOCATION_PIPELINE__
+#define __INVOCATION_PIPELINE__
+
+/* Simulates the accelerator invocations of a trace in a two stage pipeline.
+ *
+ * Normally every invocation is parsed, optimized, scheduled and reported
+ * before the next one is parsed. Invocations only depend on each other
+ * through the array base addresses and the state of the scratchpads, so the
+ * pipeline instead builds and optimizes invocation k+1 on a second datapath,
+ * on its own thread, while invocation k is scheduled. A trace with many
+ * invocations then takes about as long as the slower of the two stages per
+ * invocation instead of their sum.
+ *
+ * The front stage runs buildDddg() and ScratchpadDatapath::optimizeGraph(),
+ * which only touch the program and configuration of the front datapath. The
+ * back stage adopts the optimized program (see BaseDatapath::adoptProgram()),
+ * assigns it to its registers and scratchpad, and schedules it. Every
+ * invocation goes through the same steps in the same order as without the
+ * pipeline, so the results are identical.
+ */
+
+#include <memory>
+#include <string>
+
+#include "ScratchpadDatapath.h"
+
+class InvocationPipeline {
+ public:
+  // Schedule the invocations of the trace on @acc, building them on a second
+  // datapath created from the same arguments as @acc.
+  InvocationPipeline(ScratchpadDatapath* _acc,
+                     const std::string& bench,
+                     const std::string& trace_file,
+                     const std::string& config_file);
+
+  // Simulate every invocation of the trace. If @estimate_only is true,
+  // estimate each invocation analytically instead of scheduling it.
+  //
+  // If profiling is enabled on @acc, the phases of both stages are recorded in
+  // the profiler of @acc.
+  void run(bool estimate_only = false);
+
+  // Whether the two stages run at the same time. By default they do if the
+  // machine has more than one core; otherwise they take turns, which gives
+  // the same results without the overhead of a second thread.
+  void setOverlapped(bool _overlapped) { overlapped = _overlapped; }
+
+ private:
+  // Build and optimize the next invocation on the front datapath. Returns
+  // false at the end of the trace.
+  bool buildNext();
+
+  // Schedule (or estimate) the invocation held by the back datapath, then
+  // clear it.
+  void schedule(bool estimate_only);
+
+  // The back stage, owned by the caller.
+  ScratchpadDatapath* acc;
+  // The front stage.
+  std::unique_ptr<ScratchpadDatapath> front;
+  bool overlapped;
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 
 #include "LogicalArray.h"
@@ -9,10 +10,12 @@ LogicalArray::LogicalArray(std::string _base_name,
                            unsigned _total_size,
                            unsigned _word_size,
                            unsigned _num_ports,
-                           bool _ready_mode)
+                           bool _ready_mode,
+                           bool _timing_only)
     : base_name(_base_name), base_addr(_base_addr),
       partition_type(_partition_type), num_partitions(_partition_factor),
-      total_size(_total_size), word_size(_word_size), num_ports(_num_ports) {
+      total_size(_total_size), word_size(_word_size), num_ports(_num_ports),
+      ready_mode(_ready_mode) {
 
   if (base_addr == 0) {
     std::cerr
@@ -45,14 +48,17 @@ LogicalArray::LogicalArray(std::string _base_name,
   /* To ensure that we can accurately simulate loaded and stored values, be
    * more precise with the actual partition objects. */
   computePartitionSizes(size_per_part);
+  computeAddressDecode();
   for (auto part_size : size_per_part) {
     if (_ready_mode) {
       ReadyPartition* curr_part = new ReadyPartition();
+      curr_part->setKeepData(!_timing_only);
       curr_part->setSize(part_size, word_size);
       curr_part->setNumPorts(num_ports);
       partitions.push_back(curr_part);
     } else {
       Partition* curr_part = new Partition();
+      curr_part->setKeepData(!_timing_only);
       curr_part->setSize(part_size, word_size);
       curr_part->setNumPorts(num_ports);
       partitions.push_back(curr_part);
@@ -90,7 +96,32 @@ void LogicalArray::computePartitionSizes(std::vector<int>& size_per_part) {
   }
 }
 
-size_t LogicalArray::getPartitionIndex(Addr addr) {
+// Returns the log2 of @value if it is a power of two, and -1 otherwise.
+static int exactLog2(unsigned value) {
+  if (value == 0 || (value & (value - 1)) != 0)
+    return -1;
+  int shift = 0;
+  while ((1u << shift) != value)
+    shift++;
+  return shift;
+}
+
+void LogicalArray::computeAddressDecode() {
+  part_start_words.resize(num_partitions + 1);
+  part_start_words[0] = 0;
+  for (unsigned i = 0; i < num_partitions; i++)
+    part_start_words[i + 1] = part_start_words[i] + size_per_part[i] / word_size;
+
+  int word_log2 = exactLog2(word_size);
+  int part_log2 = exactLog2(num_partitions);
+  pow2_cyclic = partition_type == cyclic && word_log2 >= 0 && part_log2 >= 0;
+  word_shift = std::max(word_log2, 0);
+  part_shift = std::max(part_log2, 0);
+}
+
+void LogicalArray::decodeAddress(Addr addr,
+                                 unsigned* part_index,
+                                 unsigned* blk_index) {
   int rel_addr = addr - base_addr;
   if (rel_addr < 0)
     throw ArrayAccessException(base_name + ": Array offset is negative.");
@@ -100,22 +131,31 @@ size_t LogicalArray::getPartitionIndex(Addr addr) {
               << ", but total size = " << total_size;
     throw ArrayAccessException(error_msg.str());
   }
-  size_t part_index = 0;
-  if (partition_type == cyclic) {
+  if (pow2_cyclic) {
+    unsigned word = (unsigned)rel_addr >> word_shift;
+    *part_index = word & (num_partitions - 1);
+    *blk_index = word >> part_shift;
+  } else if (partition_type == cyclic) {
     /* cyclic partition. */
-    part_index = (rel_addr / word_size ) % num_partitions;
+    unsigned word = rel_addr / word_size;
+    *part_index = word % num_partitions;
+    *blk_index = word / num_partitions;
   } else {
     /* block partition. */
-    for (size_t i = 0; i < size_per_part.size(); i++) {
-      if (rel_addr - size_per_part[i] < 0)
-        return i;
-      rel_addr -= size_per_part[i];
-    }
-    // If rel_addr > 0, then we've gone past the bounds of the array.
-    assert(rel_addr <= 0);
-    part_index = size_per_part.size() - 1;
+    unsigned word = rel_addr / word_size;
+    // The first partition that starts after this word, minus one. Bytes past
+    // the last whole word of the array belong to the last partition.
+    auto next = std::upper_bound(
+        part_start_words.begin() + 1, part_start_words.end() - 1, word);
+    *part_index = next - (part_start_words.begin() + 1);
+    *blk_index = word - part_start_words[*part_index];
   }
-  assert(part_index < num_partitions);
+  assert(*part_index < num_partitions);
+}
+
+size_t LogicalArray::getPartitionIndex(Addr addr) {
+  unsigned part_index, blk_index;
+  decodeAddress(addr, &part_index, &blk_index);
   return part_index;
 }
 
@@ -123,15 +163,13 @@ size_t LogicalArray::getBlockIndex(unsigned part_index, Addr addr) {
   if (partition_type == cyclic) {
     /* cyclic partition. */
     Addr rel_addr = addr - base_addr;
+    if (pow2_cyclic)
+      return rel_addr >> word_shift >> part_shift;
     return rel_addr / word_size / num_partitions;
   } else {
     /* block partition. */
-    Addr part_base = base_addr;
-    for (size_t i = 0; i < part_index; i++) {
-      part_base += size_per_part[i];
-    }
-    Addr rel_addr = addr - part_base;
-    return rel_addr / word_size;
+    Addr rel_addr = addr - base_addr;
+    return rel_addr / word_size - part_start_words[part_index];
   }
 }
 
@@ -151,8 +189,7 @@ bool LogicalArray::canService() {
 bool LogicalArray::canService(unsigned part_index,
                               Addr addr,
                               bool isLoad) {
-  unsigned blk_index = getBlockIndex(part_index, addr);
-  return partitions[part_index]->canService(blk_index, isLoad);
+  return canServiceBlock(part_index, getBlockIndex(part_index, addr), isLoad);
 }
 
 unsigned LogicalArray::getTotalLoads() {
@@ -201,6 +238,39 @@ void LogicalArray::increment_streaming_stores(unsigned streaming_size) {
   }
 }
 
+template <typename Fn>
+void LogicalArray::forEachBlockRun(Addr addr, unsigned num_words, Fn fn) {
+  if (num_words == 0)
+    return;
+  // Check the bounds of the whole range up front; the words in between need
+  // no further checks.
+  unsigned part_index = getPartitionIndex(addr);
+  getPartitionIndex(addr + (num_words - 1) * word_size);
+
+  unsigned word = (addr - base_addr) / word_size;
+  if (partition_type == cyclic) {
+    unsigned end = word + num_words;
+    for (unsigned i = 0; i < std::min(num_words, num_partitions); i++) {
+      // The first word of the range that lives in partition part_index.
+      unsigned first = word + i;
+      fn(part_index, first / num_partitions,
+         (end - 1 - first) / num_partitions + 1);
+      if (++part_index == num_partitions)
+        part_index = 0;
+    }
+  } else {
+    while (num_words > 0) {
+      unsigned blk_index = word - part_start_words[part_index];
+      unsigned num_blocks = std::min(
+          num_words, part_start_words[part_index + 1] - word);
+      fn(part_index, blk_index, num_blocks);
+      word += num_blocks;
+      num_words -= num_blocks;
+      part_index++;
+    }
+  }
+}
+
 void LogicalArray::accessData(Addr addr,
                               uint8_t* data,
                               size_t len,
@@ -209,17 +279,38 @@ void LogicalArray::accessData(Addr addr,
     throw ArrayAccessException("Data access length must be nonzero");
   if (len % word_size != 0)
     throw ArrayAccessException("Data length is not a multiple of word size");
-  uint8_t* ptr = nullptr;
-  Addr curr_addr = addr;
-  for (size_t i = 0; i < len; i += word_size) {
-    ptr = &(data[i]);
-    unsigned part_index = getPartitionIndex(curr_addr);
-    unsigned blk_index = getBlockIndex(part_index, curr_addr);
+
+  auto access = [is_read](
+      Partition* part, unsigned blk_index, unsigned num_blocks, uint8_t* ptr) {
     if (is_read)
-      partitions[part_index]->readBlock(blk_index, ptr);
+      part->readBlocks(blk_index, num_blocks, ptr);
     else
-      partitions[part_index]->writeBlock(blk_index, ptr);
-    curr_addr += word_size;
+      part->writeBlocks(blk_index, num_blocks, ptr);
+  };
+  unsigned num_words = len / word_size;
+  uint8_t* ptr = data;
+  if (partition_type == cyclic && num_partitions > 1) {
+    // Consecutive words go to consecutive partitions, so they are copied one
+    // at a time.
+    unsigned part_index = getPartitionIndex(addr);
+    getPartitionIndex(addr + len - word_size);
+    unsigned blk_index = (addr - base_addr) / word_size / num_partitions;
+    for (unsigned i = 0; i < num_words; i++) {
+      access(partitions[part_index], blk_index, 1, ptr);
+      ptr += word_size;
+      if (++part_index == num_partitions) {
+        part_index = 0;
+        blk_index++;
+      }
+    }
+  } else {
+    // Otherwise the runs come in address order; copy each one in one go.
+    forEachBlockRun(
+        addr, num_words,
+        [&](unsigned part_index, unsigned blk_index, unsigned num_blocks) {
+          access(partitions[part_index], blk_index, num_blocks, ptr);
+          ptr += num_blocks * word_size;
+        });
   }
 }
 
@@ -233,33 +324,45 @@ void LogicalArray::readData(Addr addr, size_t len, uint8_t* data) {
 
 void LogicalArray::setReadyBit(unsigned part_index, Addr addr) {
   unsigned blk_index = getBlockIndex(part_index, addr);
-  partitions[part_index]->setReadyBit(blk_index);
-
+  if (ready_mode)
+    readyPartition(part_index)->setReadyBit(blk_index);
 }
 
 void LogicalArray::resetReadyBit(unsigned part_index, Addr addr) {
   unsigned blk_index = getBlockIndex(part_index, addr);
-  partitions[part_index]->resetReadyBit(blk_index);
+  if (ready_mode)
+    readyPartition(part_index)->resetReadyBit(blk_index);
 }
 
 void LogicalArray::setReadyBitRange(Addr addr, unsigned size) {
-  for (unsigned curr_size = 0; curr_size < size; curr_size += word_size) {
-    Addr curr_addr = addr + curr_size;
-    if (!(curr_addr >= base_addr && curr_addr < base_addr + total_size))
-      throw ArrayAccessException("Out of bounds array access");
-    unsigned part_index = getPartitionIndex(curr_addr);
-    unsigned blk_index = getBlockIndex(part_index, curr_addr);
-    partitions[part_index]->setReadyBit(blk_index);
-  }
+  unsigned num_words = (size + word_size - 1) / word_size;
+  forEachBlockRun(
+      addr, num_words,
+      [this](unsigned part_index, unsigned blk_index, unsigned num_blocks) {
+        if (ready_mode)
+          readyPartition(part_index)->setReadyBits(blk_index, num_blocks);
+      });
 }
 
 void LogicalArray::resetReadyBitRange(Addr addr, unsigned size) {
-  for (unsigned curr_size = 0; curr_size < size; curr_size += word_size) {
-    Addr curr_addr = addr + curr_size;
-    if (!(curr_addr >= base_addr && curr_addr < base_addr + total_size))
-      throw ArrayAccessException("Out of bounds array access");
-    unsigned part_index = getPartitionIndex(curr_addr);
-    unsigned blk_index = getBlockIndex(part_index, curr_addr);
-    partitions[part_index]->resetReadyBit(blk_index);
-  }
+  unsigned num_words = (size + word_size - 1) / word_size;
+  forEachBlockRun(
+      addr, num_words,
+      [this](unsigned part_index, unsigned blk_index, unsigned num_blocks) {
+        if (ready_mode)
+          readyPartition(part_index)->resetReadyBits(blk_index, num_blocks);
+      });
+}
+
+void LogicalArray::saveState(CheckpointWriter& out) const {
+  out.put(num_partitions);
+  for (const Partition* part : partitions)
+    part->saveState(out);
+}
+
+void LogicalArray::restoreState(CheckpointReader& in) {
+  in.check(in.get<unsigned>() == num_partitions,
+           "the number of partitions of " + base_name);
+  for (Partition* part : partitions)
+    part->restoreState(in);
 }
@@ -19,7 +19,8 @@ class LogicalArray {
                 unsigned _total_size,
                 unsigned _word_size,
                 unsigned _num_ports,
-                bool _ready_mode);
+                bool _ready_mode,
+                bool _timing_only = false);
   ~LogicalArray();
   void step();
   void computePartitionSizes(std::vector<int>& size_per_part);
@@ -27,6 +28,12 @@ class LogicalArray {
   bool canService();
   /* Return true if the partition with index part_index can service. */
   bool canService(unsigned part_index, Addr addr, bool isLoad);
+  /* Same as above, for an address already decoded by decodeAddress(). */
+  bool canServiceBlock(unsigned part_index, unsigned blk_index, bool isLoad) {
+    if (ready_mode)
+      return readyPartition(part_index)->canService(blk_index, isLoad);
+    return partitions[part_index]->canService();
+  }
 
   /* Setters. */
   void setBaseAddress(Addr _base_addr) { base_addr = _base_addr; }
@@ -38,9 +45,12 @@ class LogicalArray {
   void setArea(float _area) { part_area = _area; }
   /* Accessors. */
   /* Find the data block index for address addr in partition part_index. */
-  const std::string& getBaseName() { return base_name; }
+  const std::string& getBaseName() const { return base_name; }
   size_t getBlockIndex(unsigned part_index, Addr addr);
   size_t getPartitionIndex(Addr addr);
+  /* Find both the partition and the block index of address addr. Throws
+   * ArrayAccessException if addr is out of bounds. */
+  void decodeAddress(Addr addr, unsigned* part_index, unsigned* blk_index);
   unsigned getTotalSize() const { return total_size; }
   unsigned getTotalLoads();
   unsigned getTotalStores();
@@ -51,6 +61,11 @@ class LogicalArray {
   float getArea() { return part_area * num_partitions; }
   unsigned getNumPartitions() const { return num_partitions; }
   unsigned getWordSize() const { return word_size; }
+  unsigned getNumPorts() const { return num_ports; }
+  /* Energy of a single load or store to one partition. */
+  float getAccessEnergy(bool isLoad) const {
+    return isLoad ? part_read_energy : part_write_energy;
+  }
 
   /* Write @len bytes contained in @data into this array at address @addr.
    * It is assumed that data is at least len bytes long.
@@ -73,27 +88,34 @@ class LogicalArray {
   void increment_streaming_loads(unsigned streaming_size);
   void increment_streaming_stores(unsigned streaming_size);
 
-  /* Ready bit handling. */
+  /* Ready bit handling.
+   *
+   * The range operations work on whole runs of blocks in each partition, and
+   * in ready mode go straight to the ReadyPartition bitmaps instead of through
+   * the virtual Partition interface. Without ready mode they only check the
+   * bounds of the range. */
   void setReadyBit(unsigned part_index, Addr addr);
   void resetReadyBit(unsigned part_index, Addr addr);
   void setReadyBitRange(Addr addr, unsigned size);
   void resetReadyBitRange(Addr addr, unsigned size);
   void setReadyBits(unsigned part_index) {
-    partitions[part_index]->setAllReadyBits();
+    if (ready_mode)
+      readyPartition(part_index)->setAllReadyBits();
   }
   void resetReadyBits(unsigned part_index) {
-    partitions[part_index]->resetAllReadyBits();
+    if (ready_mode)
+      readyPartition(part_index)->resetAllReadyBits();
   }
   void setReadyBits() {
-    for ( Partition* part : partitions)
-      part->setAllReadyBits();
+    for (unsigned i = 0; i < num_partitions; i++)
+      setReadyBits(i);
   }
   void resetReadyBits() {
     /*HACK FOR AES SBOX*/
     if (base_name.compare("sbox") == 0)
       return;
-    for ( Partition* part : partitions)
-      part->resetAllReadyBits();
+    for (unsigned i = 0; i < num_partitions; i++)
+      resetReadyBits(i);
   }
 
   void resetStats() {
@@ -104,6 +126,10 @@ class LogicalArray {
 
   void dumpStats(std::ostream& outfile);
 
+  /* Save or restore the state of every partition for a checkpoint. */
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
  protected:
 
   /* Read or write data to this array.
@@ -113,6 +139,26 @@ class LogicalArray {
    */
   void accessData(Addr addr, uint8_t* data, size_t len, bool is_read);
 
+  /* Split the @num_words words starting at @addr into runs of consecutive
+   * blocks within a partition, and call @fn(part_index, blk_index, num_blocks)
+   * on each run. Throws ArrayAccessException if any word is out of bounds.
+   *
+   * With block partitioning the runs come in address order. With cyclic
+   * partitioning each partition holds every num_partitions-th word, so there
+   * is one run per partition.
+   */
+  template <typename Fn>
+  void forEachBlockRun(Addr addr, unsigned num_words, Fn fn);
+
+  /* Precompute the partition boundaries and shifts used by decodeAddress(). */
+  void computeAddressDecode();
+
+  /* Only valid in ready mode, where every partition is a ReadyPartition. */
+  ReadyPartition* readyPartition(unsigned part_index) {
+    assert(ready_mode);
+    return static_cast<ReadyPartition*>(partitions[part_index]);
+  }
+
   /* Array label for the LogicalArray. */
   const std::string base_name;
   /* Base address for the LogicalArray.
@@ -131,8 +177,18 @@ class LogicalArray {
   const unsigned word_size;
   /* Num of ports for each partition. */
   const unsigned num_ports;
+  /* Whether the partitions track ready bits. */
+  const bool ready_mode;
   /* Size of each partition. */
   std::vector<int> size_per_part;
+  /* Index of the first word of each partition, plus the total number of
+   * words at the end. */
+  std::vector<unsigned> part_start_words;
+  /* If word_size and num_partitions are both powers of two, a cyclic address
+   * is decoded with shifts and masks instead of divisions. */
+  bool pow2_cyclic;
+  unsigned word_shift;
+  unsigned part_shift;
   /* All the Partitions inside the same LogicalArray have the same
    * energy/power/area characteristics. */
   /* Per access read energy for each partition. */
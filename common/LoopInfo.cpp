@@ -35,6 +35,43 @@ void LoopInfo::buildLoopTree() {
   }
 }
 
+void LoopInfo::copyFrom(const LoopInfo& other) {
+  clear();
+  root = nullptr;
+  loop_sampling_factors = other.loop_sampling_factors;
+  if (other.loop_iters.empty())
+    return;
+
+  // The loop iterations refer to labels and nodes of the other program. Map
+  // them to their counterparts in this program.
+  std::unordered_map<const SrcTypes::UniqueLabel*, const SrcTypes::UniqueLabel*>
+      labels;
+  auto label_it = program->labelmap.begin();
+  for (auto& other_label : other.program->labelmap) {
+    labels[&other_label.second] = &label_it->second;
+    ++label_it;
+  }
+  std::unordered_map<const LoopIteration*, LoopIteration*> iters;
+  for (LoopIteration* other_loop : other.loop_iters) {
+    LoopIteration* loop = new LoopIteration(*other_loop);
+    if (loop->label)
+      loop->label = labels.at(loop->label);
+    if (loop->start_node)
+      loop->start_node = program->nodes.at(loop->start_node->get_node_id());
+    if (loop->end_node)
+      loop->end_node = program->nodes.at(loop->end_node->get_node_id());
+    iters[other_loop] = loop;
+    loop_iters.push_back(loop);
+  }
+  for (LoopIteration* loop : loop_iters) {
+    if (loop->parent)
+      loop->parent = iters.at(loop->parent);
+    for (auto& child : loop->children)
+      child = iters.at(child);
+  }
+  root = iters.at(other.root);
+}
+
 bool LoopInfo::insertLoop(LoopIteration* node, LoopIteration* loop) {
   if (node->contains(loop)) {
     // The loop should be inserted to the subtree from this node. We first
@@ -243,10 +280,13 @@ void LoopInfo::sampleDmaCorrection(LoopIteration* sample) {
   // have long latencies and we tend to use the DMA data right away as we
   // enter the loop.
   std::list<std::pair<int, int>> dma_intervals;
-  for (unsigned int node_id = sample->start_node->get_node_id() + 1;
-       node_id < sample->end_node->get_node_id();
-       node_id++) {
-    ExecNode* node = program->nodes.at(node_id);
+  // Node ids are not contiguous, since PHI and convert nodes are never added.
+  auto node_end = program->nodes.lower_bound(sample->end_node->get_node_id());
+  for (auto node_it =
+           program->nodes.upper_bound(sample->start_node->get_node_id());
+       node_it != node_end;
+       ++node_it) {
+    ExecNode* node = node_it->second;
     in_edge_iter in_edge_it, in_edge_end;
     for (boost::tie(in_edge_it, in_edge_end) =
              in_edges(node->get_vertex(), program->graph);
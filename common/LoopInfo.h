@@ -62,7 +62,7 @@ class LoopIteration {
 
 class LoopInfo {
  public:
-  LoopInfo(const Program* _program) : program(_program) {}
+  LoopInfo(const Program* _program) : root(nullptr), program(_program) {}
 
   ~LoopInfo() {
     for (auto s : loop_iters)
@@ -77,6 +77,18 @@ class LoopInfo {
   // Print the details of the loop tree.
   void printLoopTree();
 
+  // Replace the sampling factors and the loop tree with a copy of those of
+  // @other. This program must already be a copy of the program of @other.
+  void copyFrom(const LoopInfo& other);
+
+  // Exchange the sampling factors and loop trees of this and @other, whose
+  // programs are being swapped.
+  void swap(LoopInfo& other) {
+    loop_iters.swap(other.loop_iters);
+    loop_sampling_factors.swap(other.loop_sampling_factors);
+    std::swap(root, other.root);
+  }
+
   LoopIteration* getRootNode() const { return root; }
 
   void clear() {
@@ -92,6 +104,7 @@ class LoopInfo {
     loop_sampling_factors[label] = factor;
   }
 
+
   // This updates the line numbers of the sampled loops using the labelmap.
   void updateSamplingWithLabelInfo();
 
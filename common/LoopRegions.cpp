@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cassert>
+
+#include "ExecNode.h"
+#include "LoopRegions.h"
+
+const unsigned LoopRegions::NONE;
+
+void LoopRegions::build(const ExecNodeMap& nodes,
+                        const std::vector<DynLoopBound>& loop_bounds) {
+  clear();
+  for (auto& bound : loop_bounds) {
+    assert((ends.empty() || ends.back() < bound.node_id) &&
+           "Loop bounds must be in increasing node id order.");
+    ends.push_back(bound.node_id);
+  }
+  for (unsigned op_class = 0; op_class < NumOpClasses; op_class++)
+    class_nodes[op_class].resize(ends.size());
+  if (ends.empty() || nodes.empty())
+    return;
+
+  unsigned last_id = std::min(ends.back(), nodes.rbegin()->first + 1);
+  region_of.resize(last_id, NONE);
+  unsigned region = 0;
+  for (auto& node_pair : nodes) {
+    unsigned node_id = node_pair.first;
+    while (region < ends.size() && node_id >= ends[region])
+      region++;
+    if (region == ends.size())
+      break;
+    region_of[node_id] = region;
+    ExecNode* node = node_pair.second;
+    if (node->is_memory_op())
+      class_nodes[MemoryOps][region].push_back(node_id);
+    if (node->is_associative())
+      class_nodes[AssociativeOps][region].push_back(node_id);
+  }
+}
+
+bool LoopRegions::isBuiltFor(
+    const std::vector<DynLoopBound>& loop_bounds) const {
+  if (loop_bounds.size() != ends.size())
+    return false;
+  for (unsigned i = 0; i < ends.size(); i++) {
+    if (loop_bounds[i].node_id != ends[i])
+      return false;
+  }
+  return true;
+}
+
+void LoopRegions::clear() {
+  ends.clear();
+  region_of.clear();
+  for (unsigned op_class = 0; op_class < NumOpClasses; op_class++)
+    class_nodes[op_class].clear();
+}
+
+void LoopRegions::swap(LoopRegions& other) {
+  ends.swap(other.ends);
+  region_of.swap(other.region_of);
+  for (unsigned op_class = 0; op_class < NumOpClasses; op_class++)
+    class_nodes[op_class].swap(other.class_nodes[op_class]);
+}
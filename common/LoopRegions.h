@@ -0,0 +1,76 @@
+#ifndef _LOOP_REGIONS_H_
+#define _LOOP_REGIONS_H_
+
+#include <vector>
+
+#include "typedefs.h"
+
+/* A dynamic loop boundary is identified by a branch/call node and a target
+ * loop depth.
+ */
+struct DynLoopBound {
+  unsigned node_id;
+  unsigned target_loop_depth;
+  DynLoopBound(unsigned _node_id, unsigned _target_loop_depth)
+      : node_id(_node_id), target_loop_depth(_target_loop_depth) {}
+};
+
+// The regions of node ids between consecutive loop bounds.
+//
+// Region 0 holds the nodes before the first bound, and region i > 0 holds the
+// nodes in [loop_bounds[i-1], loop_bounds[i]), so a boundary branch is the
+// first node of the region that it starts. LoopUnrolling ends the bounds with
+// one past the last node, so every node belongs to exactly one of the
+// loop_bounds.size() regions.
+//
+// For the op classes that graph passes look for, each region also keeps the
+// list of its nodes in id order. The lists reflect the microops at the time
+// the index was built. Passes only ever turn memory ops into moves or silent
+// stores after that, so a list may hold nodes that are no longer of its class
+// and callers must still check the microop.
+class LoopRegions {
+ public:
+  enum OpClass { MemoryOps, AssociativeOps, NumOpClasses };
+
+  static const unsigned NONE = -1;
+
+  void build(const ExecNodeMap& nodes,
+             const std::vector<DynLoopBound>& loop_bounds);
+  // Is this the index of @loop_bounds?
+  bool isBuiltFor(const std::vector<DynLoopBound>& loop_bounds) const;
+  void clear();
+  void swap(LoopRegions& other);
+
+  unsigned size() const { return ends.size(); }
+  // Region @region spans the node ids [begin(region), end(region)).
+  unsigned begin(unsigned region) const {
+    return region == 0 ? 0 : ends[region - 1];
+  }
+  unsigned end(unsigned region) const { return ends[region]; }
+
+  // Return the region of @node_id, or NONE if it is past the last bound.
+  unsigned getRegion(unsigned node_id) const {
+    return node_id < region_of.size() ? region_of[node_id] : NONE;
+  }
+  // Is @node_id a loop bound, i.e. the first node of a region other than 0?
+  bool isBound(unsigned node_id) const {
+    unsigned region = getRegion(node_id);
+    return region != NONE && region > 0 && begin(region) == node_id;
+  }
+
+  // The nodes of @region that were of @op_class, in node id order.
+  const std::vector<unsigned>& getNodes(unsigned region,
+                                        OpClass op_class) const {
+    return class_nodes[op_class][region];
+  }
+
+ private:
+  // The end of every region, i.e. the node ids of the loop bounds.
+  std::vector<unsigned> ends;
+  // For each node id, its region.
+  std::vector<unsigned> region_of;
+  // For each op class and region, the node ids of that class.
+  std::vector<std::vector<unsigned>> class_nodes[NumOpClasses];
+};
+
+#endif
@@ -0,0 +1,309 @@
+#include <algorithm>
+
+#include "MemorySystemModel.h"
+
+CacheModel::CacheModel(const MemorySystemParams& params)
+    : hits(0), misses(0), merged_misses(0), mshr_stalls(0),
+      line_size(std::max(1u, params.cache_line_size)),
+      assoc(std::max(1u, params.cache_assoc)),
+      hit_latency(params.cache_hit_latency),
+      miss_latency(params.cache_miss_latency),
+      num_mshrs(std::max(1u, params.cache_mshrs)) {
+  num_sets = std::max(1u, params.cache_size / line_size / assoc);
+  sets.resize(num_sets);
+}
+
+int CacheModel::access(Addr addr, size_t size, int now) {
+  if (!canAccess(addr, size))
+    return -1;
+  Addr last = (addr + std::max<size_t>(size, 1) - 1) / line_size;
+  int done = now;
+  for (Addr line = addr / line_size; line <= last; line++)
+    done = std::max(done, accessLine(line, now));
+  return done;
+}
+
+bool CacheModel::canAccess(Addr addr, size_t size) {
+  Addr last = (addr + std::max<size_t>(size, 1) - 1) / line_size;
+  unsigned needed = 0;
+  for (Addr line = addr / line_size; line <= last; line++) {
+    if (mshrs.find(line) == mshrs.end() && !holds(line))
+      needed++;
+  }
+  if (needed == 0 || mshrs.empty() || mshrs.size() + needed <= num_mshrs)
+    return true;
+  mshr_stalls++;
+  return false;
+}
+
+bool CacheModel::holds(Addr line) const {
+  const std::vector<Addr>& set = sets[line % num_sets];
+  return std::find(set.begin(), set.end(), line) != set.end();
+}
+
+int CacheModel::accessLine(Addr line, int now) {
+  auto mshr_it = mshrs.find(line);
+  if (mshr_it != mshrs.end()) {
+    merged_misses++;
+    return std::max(mshr_it->second, now + (int)hit_latency);
+  }
+
+  std::vector<Addr>& set = sets[line % num_sets];
+  auto line_it = std::find(set.begin(), set.end(), line);
+  if (line_it != set.end()) {
+    hits++;
+    std::rotate(set.begin(), line_it, line_it + 1);
+    return now + hit_latency;
+  }
+
+  misses++;
+  // Allocate the line now; it cannot be hit until the MSHR is freed.
+  if (set.size() == assoc)
+    set.pop_back();
+  set.insert(set.begin(), line);
+  int filled = now + miss_latency;
+  mshrs[line] = filled;
+  return filled;
+}
+
+void CacheModel::retire(int now) {
+  for (auto it = mshrs.begin(); it != mshrs.end();) {
+    if (it->second <= now)
+      it = mshrs.erase(it);
+    else
+      ++it;
+  }
+}
+
+TlbModel::TlbModel(const MemorySystemParams& params)
+    : hits(0), misses(0), num_entries(params.tlb_entries),
+      page_size(std::max(1u, params.page_size)),
+      hit_latency(params.tlb_hit_latency),
+      miss_latency(params.tlb_miss_latency) {}
+
+unsigned TlbModel::translate(Addr addr) {
+  if (num_entries == 0)
+    return 0;
+  Addr page = addr / page_size;
+  auto it = page_map.find(page);
+  if (it != page_map.end()) {
+    hits++;
+    pages.splice(pages.begin(), pages, it->second);
+    return hit_latency;
+  }
+  misses++;
+  if (pages.size() == num_entries) {
+    page_map.erase(pages.back());
+    pages.pop_back();
+  }
+  pages.push_front(page);
+  page_map[page] = pages.begin();
+  return miss_latency;
+}
+
+void CacheModel::saveState(CheckpointWriter& out) const {
+  out.put(hits);
+  out.put(misses);
+  out.put(merged_misses);
+  out.put(mshr_stalls);
+  out.put<uint64_t>(sets.size());
+  for (auto& set : sets)
+    out.putVector(set);
+  out.put<uint64_t>(mshrs.size());
+  for (auto& mshr : mshrs) {
+    out.put(mshr.first);
+    out.put(mshr.second);
+  }
+}
+
+void CacheModel::restoreState(CheckpointReader& in) {
+  hits = in.get<unsigned>();
+  misses = in.get<unsigned>();
+  merged_misses = in.get<unsigned>();
+  mshr_stalls = in.get<unsigned>();
+  in.check(in.get<uint64_t>() == sets.size(), "the geometry of the cache");
+  for (auto& set : sets)
+    set = in.getVector<Addr>();
+  mshrs.clear();
+  uint64_t num_mshrs_used = in.get<uint64_t>();
+  for (uint64_t i = 0; i < num_mshrs_used; i++) {
+    Addr line = in.get<Addr>();
+    mshrs[line] = in.get<int>();
+  }
+}
+
+void TlbModel::saveState(CheckpointWriter& out) const {
+  out.put(hits);
+  out.put(misses);
+  out.putVector(std::vector<Addr>(pages.begin(), pages.end()));
+}
+
+void TlbModel::restoreState(CheckpointReader& in) {
+  hits = in.get<unsigned>();
+  misses = in.get<unsigned>();
+  std::vector<Addr> saved_pages = in.getVector<Addr>();
+  pages.assign(saved_pages.begin(), saved_pages.end());
+  page_map.clear();
+  for (auto it = pages.begin(); it != pages.end(); ++it)
+    page_map[*it] = it;
+}
+
+DmaEngineModel::DmaEngineModel(const MemorySystemParams& _params)
+    : transfers(0), requests(0), bytes(0), setup_cycles(0), params(_params),
+      busy_until(0) {
+  params.page_size = std::max(1u, params.page_size);
+  params.cache_line_size = std::max(1u, params.cache_line_size);
+}
+
+int DmaEngineModel::transfer(Addr host_addr, size_t size, bool isLoad, int now) {
+  unsigned lines =
+      (size + params.cache_line_size - 1) / params.cache_line_size;
+  unsigned setup = params.dma_setup_latency +
+                   lines * (isLoad ? params.cache_line_flush_latency
+                                   : params.cache_line_invalidate_latency);
+  // The CPU caches are flushed while the engine may still be busy with an
+  // earlier transfer.
+  int done = std::max(now + (int)setup, busy_until);
+  Addr addr = host_addr;
+  size_t remaining = size;
+  while (remaining > 0) {
+    size_t page_left = params.page_size - addr % params.page_size;
+    size_t request = std::min(remaining, page_left);
+    done += params.dma_page_latency;
+    if (params.dma_bandwidth)
+      done += (request + params.dma_bandwidth - 1) / params.dma_bandwidth;
+    addr += request;
+    remaining -= request;
+    requests++;
+  }
+  transfers++;
+  bytes += size;
+  setup_cycles += setup;
+  busy_until = done;
+  return done;
+}
+
+void DmaEngineModel::saveState(CheckpointWriter& out) const {
+  out.put(transfers);
+  out.put(requests);
+  out.put(bytes);
+  out.put(setup_cycles);
+  out.put(busy_until);
+}
+
+void DmaEngineModel::restoreState(CheckpointReader& in) {
+  transfers = in.get<unsigned>();
+  requests = in.get<unsigned>();
+  bytes = in.get<unsigned long>();
+  setup_cycles = in.get<unsigned>();
+  busy_until = in.get<int>();
+}
+
+MemorySystemModel::MemorySystemModel(const MemorySystemParams& _params)
+    : params(_params), cache(_params), tlb(_params), dma(_params),
+      issued_this_cycle(0), cache_loads(0), cache_stores(0), acp_loads(0),
+      acp_stores(0) {}
+
+bool MemorySystemModel::hasCacheBandwidth() const {
+  return params.cache_bandwidth == 0 ||
+         issued_this_cycle < params.cache_bandwidth;
+}
+
+int MemorySystemModel::issueCacheAccess(Addr addr,
+                                        size_t size,
+                                        bool isLoad,
+                                        int now) {
+  // Check for room before translating, so that a refused access leaves the
+  // TLB, the cache and their stats as they were, except for the MSHR stall.
+  if (!hasCacheBandwidth() || !cache.canAccess(addr, size))
+    return -1;
+  issued_this_cycle++;
+  int translated = now + tlb.translate(addr);
+  // An access that spans several lines completes when all of them do.
+  int done = cache.access(addr, size, translated);
+  if (isLoad)
+    cache_loads++;
+  else
+    cache_stores++;
+  return done;
+}
+
+int MemorySystemModel::issueAcpAccess(Addr addr,
+                                      size_t size,
+                                      bool isLoad,
+                                      int now) {
+  // ACP requests share the queue of the cache. ACP works on physical
+  // addresses, so like gem5 we translate them in zero time.
+  if (!hasCacheBandwidth())
+    return -1;
+  issued_this_cycle++;
+  if (isLoad)
+    acp_loads++;
+  else
+    acp_stores++;
+  return now + params.acp_latency;
+}
+
+int MemorySystemModel::issueDmaTransfer(Addr host_addr,
+                                        size_t size,
+                                        bool isLoad,
+                                        int now) {
+  return dma.transfer(host_addr, size, isLoad, now);
+}
+
+void MemorySystemModel::step(int now) {
+  issued_this_cycle = 0;
+  cache.retire(now);
+}
+
+bool MemorySystemModel::hasAccesses() const {
+  return cache_loads || cache_stores || acp_loads || acp_stores ||
+         dma.transfers;
+}
+
+void MemorySystemModel::dumpStats(std::ostream& out) {
+  out << "cache_loads," << cache_loads << "\n"
+      << "cache_stores," << cache_stores << "\n"
+      << "cache_hits," << cache.hits << "\n"
+      << "cache_misses," << cache.misses << "\n"
+      << "cache_merged_misses," << cache.merged_misses << "\n"
+      << "cache_mshr_stalls," << cache.mshr_stalls << "\n"
+      << "tlb_hits," << tlb.hits << "\n"
+      << "tlb_misses," << tlb.misses << "\n"
+      << "acp_loads," << acp_loads << "\n"
+      << "acp_stores," << acp_stores << "\n"
+      << "dma_transfers," << dma.transfers << "\n"
+      << "dma_requests," << dma.requests << "\n"
+      << "dma_bytes," << dma.bytes << "\n"
+      << "dma_setup_cycles," << dma.setup_cycles << "\n";
+}
+
+void MemorySystemModel::resetStats() {
+  cache_loads = cache_stores = acp_loads = acp_stores = 0;
+  cache.hits = cache.misses = cache.merged_misses = cache.mshr_stalls = 0;
+  tlb.hits = tlb.misses = 0;
+  dma.transfers = dma.requests = dma.setup_cycles = 0;
+  dma.bytes = 0;
+}
+
+void MemorySystemModel::saveState(CheckpointWriter& out) const {
+  cache.saveState(out);
+  tlb.saveState(out);
+  dma.saveState(out);
+  out.put(issued_this_cycle);
+  out.put(cache_loads);
+  out.put(cache_stores);
+  out.put(acp_loads);
+  out.put(acp_stores);
+}
+
+void MemorySystemModel::restoreState(CheckpointReader& in) {
+  cache.restoreState(in);
+  tlb.restoreState(in);
+  dma.restoreState(in);
+  issued_this_cycle = in.get<unsigned>();
+  cache_loads = in.get<unsigned>();
+  cache_stores = in.get<unsigned>();
+  acp_loads = in.get<unsigned>();
+  acp_stores = in.get<unsigned>();
+}
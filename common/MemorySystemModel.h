@@ -0,0 +1,163 @@
+#ifndef __MEMORY_SYSTEM_MODEL__
+#define __MEMORY_SYSTEM_MODEL__
+
+/* A first-order model of the memory system outside the accelerator, so that
+ * standalone Aladdin can schedule cache, ACP and DMA accesses without gem5.
+ *
+ * Each access is issued at a cycle and the model answers with the cycle at
+ * which it completes, or refuses it for this cycle if a queue is full. Only
+ * the timing is modeled: there is no coherence, no main memory contention and
+ * no power. The model is meant for quick exploration of the memory interface;
+ * use gem5 for anything more detailed.
+ */
+
+#include <list>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "typedefs.h"
+#include "user_config.h"
+
+// A set associative, write allocate cache with LRU replacement.
+//
+// A miss holds an MSHR until its line is filled. Later misses to the same line
+// merge into that MSHR, and new misses are refused while all MSHRs are busy.
+class CacheModel {
+ public:
+  CacheModel(const MemorySystemParams& params);
+
+  // Access the line holding @addr at cycle @now. Returns the cycle at which the
+  // data is available, or -1 if the access misses and no MSHR is free.
+  int access(Addr addr, int now) { return access(addr, 1, now); }
+  // Access every line holding the @size bytes at @addr at cycle @now. Returns
+  // the cycle at which all of them are available, or -1 without changing the
+  // cache if canAccess() refuses the access.
+  int access(Addr addr, size_t size, int now);
+  // True if the misses of an access to the @size bytes at @addr find enough
+  // free MSHRs. An access that needs more MSHRs than the cache has is allowed
+  // once all of them are free, so that it cannot stall forever. Counts an
+  // MSHR stall if the access is refused, and changes nothing else.
+  bool canAccess(Addr addr, size_t size);
+  // Free the MSHRs whose lines have been filled by cycle @now.
+  void retire(int now);
+
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
+  unsigned hits;
+  unsigned misses;
+  unsigned merged_misses;
+  unsigned mshr_stalls;
+
+ private:
+  // Access @line, allocating an MSHR if it misses.
+  int accessLine(Addr line, int now);
+  // True if @line is in the cache.
+  bool holds(Addr line) const;
+
+  unsigned line_size;
+  unsigned num_sets;
+  unsigned assoc;
+  unsigned hit_latency;
+  unsigned miss_latency;
+  unsigned num_mshrs;
+  // The lines of each set, from the most to the least recently used.
+  std::vector<std::vector<Addr>> sets;
+  // The cycle at which each line with an outstanding miss is filled.
+  std::unordered_map<Addr, int> mshrs;
+};
+
+// A fully associative TLB with LRU replacement.
+class TlbModel {
+ public:
+  TlbModel(const MemorySystemParams& params);
+
+  // Return the number of cycles needed to translate @addr.
+  unsigned translate(Addr addr);
+
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
+  unsigned hits;
+  unsigned misses;
+
+ private:
+  unsigned num_entries;
+  unsigned page_size;
+  unsigned hit_latency;
+  unsigned miss_latency;
+  // Pages from the most to the least recently used.
+  std::list<Addr> pages;
+  std::unordered_map<Addr, std::list<Addr>::iterator> page_map;
+};
+
+// A single DMA engine that performs one transfer at a time.
+//
+// A transfer first flushes (for a load) or invalidates (for a store) the host
+// buffer from the CPU caches, then is split into requests that do not cross
+// page boundaries. Each request costs a fixed latency plus its size over the
+// bandwidth.
+class DmaEngineModel {
+ public:
+  DmaEngineModel(const MemorySystemParams& params);
+
+  // Transfer @size bytes to or from host address @host_addr, starting no
+  // earlier than cycle @now. Returns the cycle at which the transfer is done.
+  int transfer(Addr host_addr, size_t size, bool isLoad, int now);
+
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
+  unsigned transfers;
+  unsigned requests;
+  unsigned long bytes;
+  unsigned setup_cycles;
+
+ private:
+  MemorySystemParams params;
+  // The cycle at which the engine finishes its last transfer.
+  int busy_until;
+};
+
+class MemorySystemModel {
+ public:
+  MemorySystemModel(const MemorySystemParams& params);
+
+  // Issue an access of @size bytes at @addr at cycle @now. Returns the cycle at
+  // which it completes, or -1 if it cannot be issued this cycle.
+  int issueCacheAccess(Addr addr, size_t size, bool isLoad, int now);
+  int issueAcpAccess(Addr addr, size_t size, bool isLoad, int now);
+  int issueDmaTransfer(Addr host_addr, size_t size, bool isLoad, int now);
+
+  // Advance to cycle @now.
+  void step(int now);
+
+  // True if any cache, ACP or DMA access has been issued since the stats were
+  // last reset.
+  bool hasAccesses() const;
+  void dumpStats(std::ostream& out);
+  void resetStats();
+
+  // Save or restore the contents of the cache and the TLB, the accesses in
+  // flight and the stats for a checkpoint.
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
+ private:
+  // Returns true if another cache or ACP request fits in this cycle.
+  bool hasCacheBandwidth() const;
+
+  MemorySystemParams params;
+  CacheModel cache;
+  TlbModel tlb;
+  DmaEngineModel dma;
+  unsigned issued_this_cycle;
+  unsigned cache_loads;
+  unsigned cache_stores;
+  unsigned acp_loads;
+  unsigned acp_stores;
+};
+
+#endif
@@ -5,4 +5,17 @@
 // via the host.
 typedef enum _MemoryType { spad, reg, dma, acp, cache } MemoryType;
 
+// All possible types of memory operations supported by Aladdin. This is
+// scoped, because several of the names are also the names of the classes that
+// model them.
+enum class MemoryOpType {
+  Register,
+  Scratchpad,
+  Cache,
+  Dma,
+  ACP,
+  ReadyBits,
+  NumMemoryOpTypes,
+};
+
 #endif
@@ -6,14 +6,20 @@ void Partition::setSize(unsigned _size, unsigned _word_size) {
   size = _size;
   word_size = _word_size;
   num_words = size/word_size;
-  data.resize(num_words);
-  for (auto& blk : data)
-    blk = new uint8_t[word_size];
+  if (keep_data)
+    data.reset(new uint8_t[num_words * word_size]);
+  else
+    data.reset();
 }
 
-Partition::~Partition() {
-  for (auto& blk : data) {
-    if (blk)
-      delete[] blk;
-  }
+void Partition::saveState(CheckpointWriter& out) const {
+  out.put(occupied_bw);
+  out.put(loads);
+  out.put(stores);
+}
+
+void Partition::restoreState(CheckpointReader& in) {
+  occupied_bw = in.get<unsigned>();
+  loads = in.get<unsigned>();
+  stores = in.get<unsigned>();
 }
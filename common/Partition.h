@@ -4,9 +4,12 @@
 #include <assert.h>
 #include <iostream>
 #include <math.h>
+#include <memory>
 #include <stdlib.h>
+#include <string.h>
 #include <unordered_map>
 #include <vector>
+#include "Checkpoint.h"
 #include "power_func.h"
 #include "typedefs.h"
 #include "user_config.h"
@@ -22,11 +25,15 @@ class Partition {
     word_size = 4;
     num_words = 0;
     num_ports = 1;
+    keep_data = true;
   }
-  virtual ~Partition();
+  virtual ~Partition() {}
   /* Setters. */
   virtual void setSize(unsigned _size, unsigned _word_size);
   void setNumPorts(unsigned _num_ports) { num_ports = _num_ports; }
+  /* If false, setSize() allocates no storage for the data: writes are
+   * dropped and reads return zeros. Must be called before setSize(). */
+  void setKeepData(bool _keep_data) { keep_data = _keep_data; }
   void setOccupiedBW(unsigned _bw) { occupied_bw = _bw; }
   void resetOccupiedBW() { occupied_bw = 0; }
   /* Getters */
@@ -44,16 +51,38 @@ class Partition {
     stores = 0;
   }
 
+  /* Save or restore the bandwidth used in the current cycle and the access
+   * counters for a checkpoint. The data is not saved, since scheduling never
+   * changes it. */
+  virtual void saveState(CheckpointWriter& out) const;
+  virtual void restoreState(CheckpointReader& in);
+
   // Access data stored in this array.
   // The _data array is assumed to be of length word_size/8.
-  virtual void writeBlock(unsigned blk_index, uint8_t* _data) {
-    assert(blk_index < data.size());
-    memcpy(data[blk_index], _data, word_size);
+  void writeBlock(unsigned blk_index, uint8_t* _data) {
+    writeBlocks(blk_index, 1, _data);
+  }
+
+  void readBlock(unsigned blk_index, uint8_t* _data) {
+    readBlocks(blk_index, 1, _data);
+  }
+
+  // Access @num_blocks consecutive blocks starting at @blk_index with a single
+  // copy. The _data array is assumed to be num_blocks * word_size bytes long.
+  virtual void writeBlocks(unsigned blk_index,
+                           unsigned num_blocks,
+                           const uint8_t* _data) {
+    assert(blk_index + num_blocks <= num_words);
+    if (data)
+      memcpy(&data[blk_index * word_size], _data, num_blocks * word_size);
   }
 
-  virtual void readBlock(unsigned blk_index, uint8_t* _data) {
-    assert(blk_index < data.size());
-    memcpy(_data, data[blk_index], word_size);
+  void readBlocks(unsigned blk_index, unsigned num_blocks, uint8_t* _data) {
+    assert(blk_index + num_blocks <= num_words);
+    if (data)
+      memcpy(_data, &data[blk_index * word_size], num_blocks * word_size);
+    else
+      memset(_data, 0, num_blocks * word_size);
   }
 
   /* Return true if there is available bandwidth. */
@@ -100,9 +129,13 @@ class Partition {
   unsigned word_size;
   /* Total number of words. */
   unsigned num_words;
+  /* Whether the data is stored at all. */
+  bool keep_data;
 
-  // Data stored in this partition, one array per block.
-  std::vector<uint8_t*> data;
+  // Data stored in this partition. Blocks are stored back to back in a single
+  // allocation, which is left uninitialized so that the pages of a large
+  // partition are only mapped once they are written.
+  std::unique_ptr<uint8_t[]> data;
 };
 
 
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <assert.h>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "Profiler.h"
+
+Profiler::Phase::Phase(Profiler& _profiler, const std::string& name)
+    : profiler(_profiler), active(_profiler.enabled), index(0),
+      start_wall_time(0), start_cpu_time(0) {
+  if (!active)
+    return;
+  std::string full_name;
+  for (auto& parent : profiler.open_phases)
+    full_name += parent + "/";
+  full_name += name;
+  profiler.open_phases.push_back(name);
+
+  PhaseRecord record;
+  record.name = full_name;
+  record.invocation =
+      profiler.num_invocations > 0 ? profiler.num_invocations - 1 : 0;
+  record.wall_time = 0;
+  record.cpu_time = 0;
+  record.peak_rss = 0;
+  record.nodes = 0;
+  record.edges = 0;
+  record.cycles = 0;
+  index = profiler.records.size();
+  profiler.records.push_back(record);
+
+  start_wall_time = getWallTime();
+  start_cpu_time = getCpuTime();
+}
+
+Profiler::Phase::~Phase() { end(); }
+
+void Profiler::Phase::end() {
+  if (!active)
+    return;
+  PhaseRecord& record = profiler.records.at(index);
+  record.wall_time = getWallTime() - start_wall_time;
+  record.cpu_time = getCpuTime() - start_cpu_time;
+  record.peak_rss = getPeakRss();
+  profiler.open_phases.pop_back();
+  active = false;
+}
+
+void Profiler::Phase::setWork(long nodes, long edges, long cycles) {
+  if (!active)
+    return;
+  PhaseRecord& record = profiler.records.at(index);
+  record.nodes = nodes;
+  record.edges = edges;
+  record.cycles = cycles;
+}
+
+void Profiler::Phase::discard() {
+  if (!active)
+    return;
+  assert(index == profiler.records.size() - 1 &&
+         "Cannot discard a phase that encloses other phases!");
+  profiler.records.pop_back();
+  profiler.open_phases.pop_back();
+  active = false;
+}
+
+void Profiler::clear() {
+  records.clear();
+  num_invocations = 0;
+}
+
+void Profiler::merge(const Profiler& other) {
+  records.insert(records.begin(), other.records.begin(), other.records.end());
+  std::stable_sort(records.begin(), records.end(),
+                   [](const PhaseRecord& a, const PhaseRecord& b) {
+                     return a.invocation < b.invocation;
+                   });
+  num_invocations = std::max(num_invocations, other.num_invocations);
+}
+
+double Profiler::getWallTime() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec + now.tv_usec * 1e-6;
+}
+
+double Profiler::getCpuTime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+long Profiler::getPeakRss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // Linux reports the maximum resident set size in kB.
+  return usage.ru_maxrss;
+}
+
+// Quote @str as a JSON string.
+static std::string jsonString(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c == '\n') {
+      quoted += "\\n";
+    } else if ((unsigned char)c < 0x20) {
+      quoted += ' ';
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+void Profiler::writeJson(std::ostream& out) const {
+  // A rate is only meaningful if the phase did some work of that kind.
+  auto writeRate = [&out](const char* name, long count, double time) {
+    if (count > 0 && time > 0)
+      out << ", \"" << name << "\": " << count / time;
+  };
+
+  out << "{\n";
+  out << "  \"benchmark\": " << jsonString(benchmark) << ",\n";
+  out << "  \"phases\": [";
+  for (size_t i = 0; i < records.size(); i++) {
+    const PhaseRecord& record = records[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": " << jsonString(record.name)
+        << ", \"invocation\": " << record.invocation
+        << ", \"wall_time_s\": " << record.wall_time
+        << ", \"cpu_time_s\": " << record.cpu_time
+        << ", \"peak_rss_kb\": " << record.peak_rss
+        << ", \"nodes\": " << record.nodes
+        << ", \"edges\": " << record.edges
+        << ", \"cycles\": " << record.cycles;
+    writeRate("nodes_per_s", record.nodes, record.wall_time);
+    writeRate("edges_per_s", record.edges, record.wall_time);
+    writeRate("cycles_per_s", record.cycles, record.wall_time);
+    out << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
+
+void Profiler::writeJson(const std::string& file_name) const {
+  std::ofstream out(file_name);
+  writeJson(out);
+}
@@ -0,0 +1,97 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* Records the wall time, CPU time and peak resident set size of the phases of
+ * a simulation, and writes them out as JSON.
+ *
+ * A phase lasts as long as the Profiler::Phase object that opened it. Phases
+ * may nest; a nested phase is named after the phases that enclose it, e.g.
+ * "dumpStats/writePerCycleActivity". A phase can also report how much work it
+ * did (nodes, edges and cycles), from which the throughput of the phase is
+ * computed, so that runs of different sizes can be compared.
+ *
+ * Profiling is disabled by default. Phases opened on a disabled profiler are
+ * not recorded.
+ */
+class Profiler {
+ public:
+  struct PhaseRecord {
+    std::string name;
+    // Index of the accelerator invocation this phase belongs to.
+    unsigned invocation;
+    // In seconds.
+    double wall_time;
+    double cpu_time;
+    // Peak resident set size of the process at the end of the phase, in kB.
+    long peak_rss;
+    long nodes;
+    long edges;
+    long cycles;
+  };
+
+  class Phase {
+   public:
+    Phase(Profiler& _profiler, const std::string& name);
+    ~Phase();
+
+    // The amount of work done by this phase.
+    void setWork(long nodes, long edges, long cycles = 0);
+
+    // End this phase before the object is destroyed.
+    void end();
+
+    // Drop this phase from the records, e.g. if it turned out to have nothing
+    // to do. Must not enclose any other phase.
+    void discard();
+
+   private:
+    Profiler& profiler;
+    // False if the profiler was disabled when this phase started, or if the
+    // phase has ended.
+    bool active;
+    // Index of this phase in the records of the profiler.
+    size_t index;
+    double start_wall_time;
+    double start_cpu_time;
+  };
+
+  Profiler(const std::string& _benchmark)
+      : benchmark(_benchmark), enabled(false), num_invocations(0) {}
+
+  void setEnabled(bool _enabled) { enabled = _enabled; }
+  bool isEnabled() const { return enabled; }
+
+  // Phases recorded from now on belong to a new invocation.
+  void startInvocation() { num_invocations++; }
+
+  // Phases in the order they started.
+  const std::vector<PhaseRecord>& getRecords() const { return records; }
+
+  void clear();
+
+  // Add the records of @other, which profiled the earlier phases of the same
+  // invocations on another thread. Records stay ordered by invocation, with
+  // the records of @other first within each invocation.
+  void merge(const Profiler& other);
+
+  void writeJson(std::ostream& out) const;
+  void writeJson(const std::string& file_name) const;
+
+ private:
+  static double getWallTime();
+  static double getCpuTime();
+  static long getPeakRss();
+
+  std::string benchmark;
+  bool enabled;
+  unsigned num_invocations;
+  std::vector<PhaseRecord> records;
+  // Names of the phases that have started and not yet ended, outermost first.
+  std::vector<std::string> open_phases;
+};
+
+#endif
@@ -13,11 +13,16 @@ void Program::addEdge(unsigned int from, unsigned int to, uint8_t parid) {
 }
 
 ExecNode* Program::insertNode(unsigned node_id, uint8_t microop) {
-  nodes[node_id] = new ExecNode(node_id, microop);
+  return insertNode(new ExecNode(node_id, microop));
+}
+
+ExecNode* Program::insertNode(ExecNode* node) {
+  unsigned node_id = node->get_node_id();
+  nodes[node_id] = node;
   Vertex v = add_vertex(VertexProperty(node_id), graph);
-  nodes.at(node_id)->set_vertex(v);
+  node->set_vertex(v);
   assert(get(boost::vertex_node_id, graph, v) == node_id);
-  return nodes.at(node_id);
+  return node;
 }
 
 void Program::clearExecNodes() {
@@ -31,9 +36,43 @@ void Program::clear() {
   graph.clear();
   call_arg_map.clear();
   loop_bounds.clear();
+  barriers.clear();
+  loop_regions.clear();
   loop_info.clear();
 }
 
+void Program::copyFrom(const Program& other) {
+  clear();
+  for (auto& node_pair : other.nodes)
+    nodes[node_pair.first] = node_pair.second->clone();
+  // Vertices are stored in a vector, so the copied graph assigns every vertex
+  // the same descriptor and the cloned nodes remain valid.
+  graph = other.graph;
+  labelmap = other.labelmap;
+  inline_labelmap = other.inline_labelmap;
+  loop_bounds = other.loop_bounds;
+  barriers = other.barriers;
+  loop_regions = other.loop_regions;
+  call_arg_map = other.call_arg_map;
+  createVertexMap();
+  loop_info.copyFrom(other.loop_info);
+}
+
+void Program::swap(Program& other) {
+  nodes.swap(other.nodes);
+  graph.swap(other.graph);
+  labelmap.swap(other.labelmap);
+  inline_labelmap.swap(other.inline_labelmap);
+  loop_bounds.swap(other.loop_bounds);
+  barriers.swap(other.barriers);
+  loop_regions.swap(other.loop_regions);
+  std::swap(call_arg_map, other.call_arg_map);
+  // The vertex maps refer to the graphs themselves, not to their contents.
+  createVertexMap();
+  other.createVertexMap();
+  loop_info.swap(other.loop_info);
+}
+
 ExecNode* Program::getNextNode(unsigned node_id) const {
   auto it = nodes.find(node_id);
   assert(it != nodes.end());
@@ -83,7 +122,6 @@ std::list<cnode_pair_t> Program::findLoopBoundaries(
   for (int i = 0; i < int(loop_bounds.size()) - 1; ++i) {
     const DynLoopBound* loop_bound = &loop_bounds[i];
     const ExecNode* node = nodes.at(loop_bound->node_id);
-    const Vertex vertex = node->get_vertex();
     // Check if the loop information matches.
     bool is_same_loop = false;
     if (static_mode) {
@@ -95,7 +133,7 @@ std::list<cnode_pair_t> Program::findLoopBoundaries(
                      node->get_dynamic_function() ==
                          *(dynamic_label->get_dynamic_function());
     }
-    if (boost::degree(vertex, graph) > 0 && is_same_loop) {
+    if (getDegree(node) > 0 && is_same_loop) {
       if (!is_loop_executing) {
         if (loop_bound->target_loop_depth > node->get_loop_depth()) {
           is_loop_executing = true;
@@ -182,6 +220,9 @@ std::vector<unsigned> Program::getParentNodes(unsigned int node_id) const {
     Vertex source_vertex = source(edge, graph);
     connectedNodes.push_back(atVertex(source_vertex));
   }
+  barriers.forEachParent(node_id, [&](unsigned parent_id) {
+    connectedNodes.push_back(parent_id);
+  });
   return connectedNodes;
 }
 
@@ -198,6 +239,8 @@ std::vector<unsigned> Program::getChildNodes(unsigned int node_id) const {
     Vertex target_vertex = target(edge, graph);
     connectedNodes.push_back(atVertex(target_vertex));
   }
+  barriers.forEachChild(
+      node_id, [&](unsigned child_id) { connectedNodes.push_back(child_id); });
   return connectedNodes;
 }
 
@@ -207,7 +250,7 @@ int Program::getEdgeWeight(unsigned node_id_0, unsigned node_id_1) const {
   ExecNode* node_1 = nodes.at(node_id_1);
   auto edge_pair = edge(node_0->get_vertex(), node_1->get_vertex(), graph);
   if (!edge_pair.second)
-    return -1;
+    return barriers.hasEdge(node_id_0, node_id_1) ? CONTROL_EDGE : -1;
   return edge_to_parid[edge_pair.first];
 }
 
@@ -233,3 +276,33 @@ int Program::shortestDistanceBetweenNodes(unsigned from, unsigned to) const {
   }
   return -1;
 }
+
+std::vector<Vertex> Program::getReverseTopologicalOrder() const {
+  // Kahn's algorithm, from the bottom of the graph up.
+  std::vector<unsigned> num_children(boost::num_vertices(graph));
+  std::vector<Vertex> order;
+  order.reserve(num_children.size());
+  vertex_iter vi, vi_end;
+  for (boost::tie(vi, vi_end) = vertices(graph); vi != vi_end; ++vi) {
+    num_children[*vi] = getOutDegree(nodeAtVertex(*vi));
+    if (num_children[*vi] == 0)
+      order.push_back(*vi);
+  }
+  auto visit_parent = [&](Vertex parent) {
+    if (--num_children[parent] == 0)
+      order.push_back(parent);
+  };
+  for (size_t i = 0; i < order.size(); i++) {
+    Vertex vertex = order[i];
+    in_edge_iter in_edge_it, in_edge_end;
+    for (boost::tie(in_edge_it, in_edge_end) = in_edges(vertex, graph);
+         in_edge_it != in_edge_end;
+         ++in_edge_it)
+      visit_parent(source(*in_edge_it, graph));
+    barriers.forEachParent(atVertex(vertex), [&](unsigned parent_id) {
+      visit_parent(nodes.at(parent_id)->get_vertex());
+    });
+  }
+  assert(order.size() == num_children.size() && "The graph has a cycle.");
+  return order;
+}
@@ -3,22 +3,14 @@
 
 #include <list>
 
+#include "ControlBarriers.h"
 #include "DynamicEntity.h"
 #include "ExecNode.h"
 #include "SourceEntity.h"
 #include "LoopInfo.h"
+#include "LoopRegions.h"
 #include "typedefs.h"
 
-/* A dynamic loop boundary is identified by a branch/call node and a target
- * loop depth.
- */
-struct DynLoopBound {
-  unsigned node_id;
-  unsigned target_loop_depth;
-  DynLoopBound(unsigned _node_id, unsigned _target_loop_depth)
-      : node_id(_node_id), target_loop_depth(_target_loop_depth) {}
-};
-
 
 // This class maintains mappings between names of function call arguments in
 // the caller and callee.
@@ -70,9 +62,22 @@ class Program {
   void clear();
   void clearExecNodes();
 
+  // Replace the contents of this program with a deep copy of @other.
+  //
+  // Graph optimizations modify a program in place, so this is how the same
+  // unoptimized program can be optimized under several configurations, or an
+  // optimized one saved and restored.
+  void copyFrom(const Program& other);
+
+  // Exchange the contents of this program and @other, without copying any
+  // nodes. Like copyFrom(), but much cheaper when @other is no longer needed.
+  void swap(Program& other);
+
   // Graph modifiers.
   void addEdge(unsigned int from, unsigned int to, uint8_t parid);
   ExecNode* insertNode(unsigned node_id, uint8_t microop);
+  // Add @node to the graph. The program takes ownership of it.
+  ExecNode* insertNode(ExecNode* node);
 
   void createVertexMap() { vertex_to_name = get(boost::vertex_node_id, graph); }
 
@@ -87,13 +92,30 @@ class Program {
   std::vector<unsigned> getChildNodes(unsigned int node_id) const;
 
   int getNumNodes() const { return boost::num_vertices(graph); }
-  int getNumEdges() const { return boost::num_edges(graph); }
+  int getNumEdges() const {
+    return boost::num_edges(graph) + barriers.numEdges();
+  }
   int getNumConnectedNodes(unsigned int node_id) const {
-    return boost::degree(nodes.at(node_id)->get_vertex(), graph);
+    return getDegree(nodes.at(node_id));
+  }
+
+  // The number of edges to and from @node, including the implicit control
+  // edges of the barriers. Use these instead of boost::degree() and friends.
+  unsigned getInDegree(const ExecNode* node) const {
+    return boost::in_degree(node->get_vertex(), graph) +
+           barriers.numParents(node->get_node_id());
+  }
+  unsigned getOutDegree(const ExecNode* node) const {
+    return boost::out_degree(node->get_vertex(), graph) +
+           barriers.numChildren(node->get_node_id());
+  }
+  unsigned getDegree(const ExecNode* node) const {
+    return getInDegree(node) + getOutDegree(node);
   }
 
   bool edgeExistsV(Vertex from, Vertex to) const {
-    return edge(from, to, graph).second;
+    return edge(from, to, graph).second ||
+           barriers.hasEdge(atVertex(from), atVertex(to));
   }
 
   bool edgeExists(const ExecNode* from, const ExecNode* to) const {
@@ -102,8 +124,14 @@ class Program {
     return false;
   }
 
+  // There is no edge to or from a node that is not in the program, like an
+  // elided PHI node.
   bool edgeExists(unsigned int from, unsigned int to) const {
-    return edgeExists(nodes.at(from), nodes.at(to));
+    auto from_it = nodes.find(from);
+    auto to_it = nodes.find(to);
+    if (from_it == nodes.end() || to_it == nodes.end())
+      return false;
+    return edgeExists(from_it->second, to_it->second);
   }
 
   bool edgeExists(unsigned int node_id) const {
@@ -168,6 +196,19 @@ class Program {
   // considered to have distance 1.
   int shortestDistanceBetweenNodes(unsigned from, unsigned to) const;
 
+  // Return all vertices in reverse topological order, like
+  // boost::topological_sort(), including the edges of the barriers.
+  std::vector<Vertex> getReverseTopologicalOrder() const;
+
+  // Return the index of the regions between loop_bounds. It is built on first
+  // use and rebuilt only after loop_bounds changes, so the passes that run
+  // after loop unrolling share one.
+  const LoopRegions& getLoopRegions() const {
+    if (!loop_regions.isBuiltFor(loop_bounds))
+      loop_regions.build(nodes, loop_bounds);
+    return loop_regions;
+  }
+
   //=-------- Program data ---------=//
 
   // Complete set of all execution nodes.
@@ -189,6 +230,11 @@ class Program {
   // the LoopUnrolling optimization.
   std::vector<DynLoopBound> loop_bounds;
 
+  // Control dependences of unrolled loop iterations. These are edges of the
+  // graph too, so everything that walks the edges of a node must also visit
+  // the implicit ones. This is populated by the LoopUnrolling optimization.
+  ControlBarriers barriers;
+
   // Caller-callee function argument name mappings.
   CallArgMap call_arg_map;
 
@@ -197,6 +243,10 @@ class Program {
 
   // Loop sampling information.
   LoopInfo loop_info;
+
+ private:
+  // Cache for getLoopRegions().
+  mutable LoopRegions loop_regions;
 };
 
 #endif
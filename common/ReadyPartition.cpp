@@ -5,5 +5,17 @@ ReadyPartition::~ReadyPartition() {}
 
 void ReadyPartition::setSize(unsigned _size, unsigned _word_size) {
   Partition::setSize(_size, _word_size);
-  ready_bits.resize(num_words);
+  ready_bits.assign((num_words + 63) / 64, 0);
+}
+
+void ReadyPartition::saveState(CheckpointWriter& out) const {
+  Partition::saveState(out);
+  out.putVector(ready_bits);
+}
+
+void ReadyPartition::restoreState(CheckpointReader& in) {
+  Partition::restoreState(in);
+  std::vector<uint64_t> bits = in.getVector<uint64_t>();
+  in.check(bits.size() == ready_bits.size(), "the size of a partition");
+  ready_bits.swap(bits);
 }
@@ -1,48 +1,73 @@
 #ifndef __READY_PARTITION__
 #define __READY_PARTITION__
 
+#include <algorithm>
+#include <stdint.h>
+
 #include "Partition.h"
 
-class ReadyPartition : public Partition {
+/* A partition that also tracks whether each of its words is ready.
+ *
+ * The class is final so that the LogicalArray, which knows when all of its
+ * partitions are ReadyPartitions, can call the ready bit operations below
+ * without going through the vtable.
+ */
+class ReadyPartition final : public Partition {
  public:
   ReadyPartition();
   ~ReadyPartition();
 
-  virtual void writeBlock(unsigned blk_index, uint8_t* data) {
-    Partition::writeBlock(blk_index, data);
-    setReadyBit(blk_index);
-  }
-
-  virtual void readBlock(unsigned blk_index, uint8_t* data) {
-    Partition::readBlock(blk_index, data);
+  virtual void writeBlocks(unsigned blk_index,
+                           unsigned num_blocks,
+                           const uint8_t* data) {
+    Partition::writeBlocks(blk_index, num_blocks, data);
+    setReadyBits(blk_index, num_blocks);
   }
 
   /* Setters. */
   virtual void setSize(unsigned _size, unsigned _word_size);
 
+  /* Stores set ready bits while scheduling, so they are saved as well. */
+  virtual void saveState(CheckpointWriter& out) const;
+  virtual void restoreState(CheckpointReader& in);
+
   /* Set the ready bit for the specific blk_index. */
   virtual void setReadyBit(unsigned blk_index) {
     // Related to bugs ALADDIN-60 and ALADDIN-61.
     assert(blk_index < num_words);
-    ready_bits[blk_index] = true;
+    ready_bits[blk_index / 64] |= bitMask(blk_index);
   }
 
   /* Reset the ready bit for the specific blk_index. */
   virtual void resetReadyBit(unsigned blk_index) {
     assert(blk_index < num_words);
-    ready_bits[blk_index] = false;
+    ready_bits[blk_index / 64] &= ~bitMask(blk_index);
   }
 
-  /* Set all the ready bits in the partition. */
-  virtual void setAllReadyBits() {
-    for (unsigned i = 0; i < num_words; ++i)
-      setReadyBit(i);
+  /* Return true if the data at blk_index is ready. */
+  bool isReady(unsigned blk_index) const {
+    assert(blk_index < num_words);
+    return ready_bits[blk_index / 64] & bitMask(blk_index);
+  }
+
+  /* Set or reset the ready bits of num_blocks consecutive blocks starting at
+   * blk_index, 64 blocks at a time. */
+  void setReadyBits(unsigned blk_index, unsigned num_blocks) {
+    forEachBitmapWord(blk_index, num_blocks,
+                      [](uint64_t& bits, uint64_t mask) { bits |= mask; });
   }
 
+  void resetReadyBits(unsigned blk_index, unsigned num_blocks) {
+    forEachBitmapWord(blk_index, num_blocks,
+                      [](uint64_t& bits, uint64_t mask) { bits &= ~mask; });
+  }
+
+  /* Set all the ready bits in the partition. */
+  virtual void setAllReadyBits() { setReadyBits(0, num_words); }
+
   /* Reset all the ready bits in the partition. */
   virtual void resetAllReadyBits() {
-    for (unsigned i = 0; i < num_words; ++i)
-      resetReadyBit(i);
+    std::fill(ready_bits.begin(), ready_bits.end(), 0);
   }
 
   /* Return true if the data at blk_index is ready and the partition can service. */
@@ -54,14 +79,41 @@ class ReadyPartition : public Partition {
         setReadyBit(blk_index);
         return true;
       }
-      return ready_bits[blk_index];
+      return isReady(blk_index);
     }
     return false;
   }
 
  protected:
-  // Ready bits are stored at word granularity.
-  std::vector<bool> ready_bits;
+  static uint64_t bitMask(unsigned blk_index) {
+    return uint64_t(1) << (blk_index % 64);
+  }
+
+  /* Call @op(bits, mask) on each word of the bitmap that covers the blocks
+   * [blk_index, blk_index + num_blocks), where mask selects the bits of the
+   * range within that word. */
+  template <typename Op>
+  void forEachBitmapWord(unsigned blk_index, unsigned num_blocks, Op op) {
+    assert(blk_index + num_blocks <= num_words);
+    if (num_blocks == 0)
+      return;
+    unsigned end = blk_index + num_blocks;
+    unsigned first = blk_index / 64;
+    unsigned last = (end - 1) / 64;
+    uint64_t first_mask = ~uint64_t(0) << (blk_index % 64);
+    uint64_t last_mask = ~uint64_t(0) >> (63 - (end - 1) % 64);
+    if (first == last) {
+      op(ready_bits[first], first_mask & last_mask);
+      return;
+    }
+    op(ready_bits[first], first_mask);
+    for (unsigned i = first + 1; i < last; i++)
+      op(ready_bits[i], ~uint64_t(0));
+    op(ready_bits[last], last_mask);
+  }
+
+  // Ready bits are stored at word granularity, 64 words to an element.
+  std::vector<uint64_t> ready_bits;
 };
 
 #endif
@@ -57,3 +57,19 @@ double Registers::getWriteEnergy(std::string baseName) {
 double Registers::getLeakagePower(std::string baseName) {
   return regs[baseName]->getLeakagePower();
 }
+
+void Registers::saveState(CheckpointWriter& out) const {
+  out.put<uint32_t>(regs.size());
+  for (auto it = regs.begin(); it != regs.end(); it++) {
+    out.putString(it->first);
+    it->second->saveState(out);
+  }
+}
+
+void Registers::restoreState(CheckpointReader& in) {
+  in.check(in.get<uint32_t>() == regs.size(), "the number of registers");
+  for (auto it = regs.begin(); it != regs.end(); it++) {
+    in.check(in.getString() == it->first, "the registers");
+    it->second->restoreState(in);
+  }
+}
@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "Checkpoint.h"
 #include "power_func.h"
 
 class Register {
@@ -51,6 +52,15 @@ class Register {
   unsigned getTotalSize() const { return total_size; }
   unsigned getWordSize() const { return word_size; }
 
+  void saveState(CheckpointWriter& out) const {
+    out.put(loads);
+    out.put(stores);
+  }
+  void restoreState(CheckpointReader& in) {
+    loads = in.get<unsigned>();
+    stores = in.get<unsigned>();
+  }
+
  private:
   std::string baseName;
   unsigned int total_size;  // bytes
@@ -88,6 +98,10 @@ class Registers {
   bool has(std::string baseName);
   void clear();
 
+  // Save or restore the access counters of every register for a checkpoint.
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
  private:
   std::map<std::string, Register*> regs;
 };
@@ -0,0 +1,458 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "DDDG.h"
+#include "ScheduleSnapshot.h"
+
+using namespace SrcTypes;
+
+namespace {
+
+const char kMagic[8] = { 'A', 'L', 'A', 'D', 'S', 'N', 'A', 'P' };
+const uint32_t kVersion = 1;
+// Offset into the data section of an absent string.
+const uint32_t kNoString = -1;
+
+enum NodeFlags : uint8_t {
+  Isolated = 1 << 0,
+  Inductive = 1 << 1,
+  DynamicMemOp = 1 << 2,
+  DoublePrecision = 1 << 3,
+  FloatValue = 1 << 4,
+};
+
+// The kind of the MemAccess of a node.
+enum MemAccessKind : uint8_t {
+  NoAccess,
+  Scalar,
+  Vector,
+  TimingOnly,
+  Host,
+  ReadyBits,
+};
+
+}  // namespace
+
+struct ScheduleSnapshot::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_cycles;
+  uint32_t num_nodes;
+  uint32_t num_edges;
+  uint32_t num_loop_bounds;
+  uint32_t num_labels;
+  uint64_t data_size;
+};
+
+struct ScheduleSnapshot::NodeRecord {
+  uint32_t node_id;
+  uint32_t dynamic_invocation;
+  int32_t line_num;
+  // -1 if the node never started or completed.
+  int32_t start_cycle;
+  int32_t complete_cycle;
+  uint32_t loop_depth;
+  uint32_t partition_index;
+  // Offsets of the names of the source entities into the data section.
+  uint32_t function;
+  uint32_t variable;
+  uint32_t instruction;
+  uint32_t basic_block;
+  uint32_t array_label;
+  uint32_t special_math_op;
+  // The source variable of a host access, or the array of ready bits.
+  uint32_t mem_src_var;
+  uint32_t mem_dst_var;
+  uint32_t mem_size;
+  uint8_t microop;
+  uint8_t flags;
+  uint8_t mem_kind;
+  uint8_t memory_type;
+  uint32_t reserved;
+  uint64_t mem_addr;
+  uint64_t mem_src_addr;
+  // The value of a scalar or ready bits access, or the offset of the value of
+  // a vector access into the data section.
+  uint64_t mem_value;
+};
+
+struct ScheduleSnapshot::EdgeRecord {
+  uint32_t from;
+  uint32_t to;
+  int32_t parid;
+};
+
+struct ScheduleSnapshot::LoopBoundRecord {
+  uint32_t node_id;
+  uint32_t target_loop_depth;
+};
+
+struct ScheduleSnapshot::LabelRecord {
+  uint32_t line;
+  uint32_t function;
+  uint32_t label;
+  int32_t line_number;
+};
+
+namespace {
+
+// Builds the data section, storing every distinct string once.
+class DataWriter {
+ public:
+  template <class T>
+  uint32_t addName(const T* entity) {
+    return entity ? addString(entity->get_name()) : kNoString;
+  }
+
+  uint32_t addString(const std::string& str) {
+    auto it = offsets.find(str);
+    if (it != offsets.end())
+      return it->second;
+    uint32_t offset = data.size();
+    data.insert(data.end(), str.begin(), str.end());
+    data.push_back('\0');
+    offsets[str] = offset;
+    return offset;
+  }
+
+  uint32_t addBytes(const uint8_t* bytes, size_t size) {
+    uint32_t offset = data.size();
+    data.insert(data.end(), bytes, bytes + size);
+    return offset;
+  }
+
+  const std::vector<char>& getData() const { return data; }
+
+ private:
+  std::vector<char> data;
+  std::map<std::string, uint32_t> offsets;
+};
+
+template <class T>
+void writeArray(std::ofstream& out, const std::vector<T>& records) {
+  out.write(reinterpret_cast<const char*>(records.data()),
+            records.size() * sizeof(T));
+}
+
+}  // namespace
+
+void ScheduleSnapshot::write(const Program& program,
+                             unsigned num_cycles,
+                             const std::string& file_name) {
+  static_assert(sizeof(Header) % 8 == 0 && sizeof(NodeRecord) % 8 == 0 &&
+                    sizeof(LoopBoundRecord) % 8 == 0 &&
+                    sizeof(LabelRecord) % 8 == 0,
+                "Every section must start aligned for its records.");
+  DataWriter data;
+  std::vector<NodeRecord> nodes;
+  std::vector<EdgeRecord> edges;
+  nodes.reserve(program.nodes.size());
+  auto edge_to_parid = get(boost::edge_name, program.graph);
+
+  for (auto& node_pair : program.nodes) {
+    const ExecNode* node = node_pair.second;
+    NodeRecord record;
+    memset(&record, 0, sizeof(record));
+    record.node_id = node->get_node_id();
+    record.dynamic_invocation = node->get_dynamic_invocation();
+    record.line_num = node->get_line_num();
+    record.start_cycle =
+        node->started() ? node->get_start_execution_cycle() : -1;
+    record.complete_cycle =
+        node->completed() ? node->get_complete_execution_cycle() : -1;
+    record.loop_depth = node->get_loop_depth();
+    record.partition_index = node->get_partition_index();
+    record.function = data.addName(node->get_static_function());
+    record.variable = data.addName(node->get_variable());
+    record.instruction = data.addName(node->get_static_inst());
+    record.basic_block = data.addName(node->get_basic_block());
+    record.array_label = node->has_array_label()
+                             ? data.addString(node->get_array_label())
+                             : kNoString;
+    record.special_math_op = node->get_special_math_op().empty()
+                                 ? kNoString
+                                 : data.addString(node->get_special_math_op());
+    record.mem_src_var = kNoString;
+    record.mem_dst_var = kNoString;
+    record.microop = node->get_microop();
+    record.flags = (node->is_isolated() ? Isolated : 0) |
+                   (node->is_inductive() ? Inductive : 0) |
+                   (node->is_dynamic_mem_op() ? DynamicMemOp : 0) |
+                   (node->is_double_precision() ? DoublePrecision : 0);
+
+    MemAccess* mem_access = node->get_mem_access();
+    record.mem_kind = NoAccess;
+    if (mem_access) {
+      record.mem_addr = mem_access->vaddr;
+      record.mem_size = mem_access->size;
+      if (auto host_access = dynamic_cast<HostMemAccess*>(mem_access)) {
+        record.mem_kind = Host;
+        record.memory_type = host_access->memory_type;
+        record.mem_src_addr = host_access->src_addr;
+        record.mem_src_var = data.addName(host_access->src_var);
+        record.mem_dst_var = data.addName(host_access->dst_var);
+      } else if (auto ready_access =
+                     dynamic_cast<ReadyBitAccess*>(mem_access)) {
+        record.mem_kind = ReadyBits;
+        record.mem_src_var = data.addName(ready_access->array);
+        record.mem_value = ready_access->value;
+      } else if (auto scalar_access =
+                     dynamic_cast<ScalarMemAccess*>(mem_access)) {
+        record.mem_kind = Scalar;
+        if (scalar_access->is_float)
+          record.flags |= FloatValue;
+        memcpy(&record.mem_value, scalar_access->data(), 8);
+      } else if (auto vector_access =
+                     dynamic_cast<VectorMemAccess*>(mem_access)) {
+        record.mem_kind = Vector;
+        record.mem_value =
+            data.addBytes(vector_access->data(), vector_access->size);
+      } else {
+        record.mem_kind = TimingOnly;
+      }
+    }
+    nodes.push_back(record);
+
+    // Store the edges grouped by their source node.
+    out_edge_iter out_edge_it, out_edge_end;
+    for (boost::tie(out_edge_it, out_edge_end) =
+             out_edges(node->get_vertex(), program.graph);
+         out_edge_it != out_edge_end;
+         ++out_edge_it) {
+      edges.push_back({ record.node_id,
+                        program.atVertex(target(*out_edge_it, program.graph)),
+                        edge_to_parid[*out_edge_it] });
+    }
+    program.barriers.forEachChild(record.node_id, [&](unsigned child_id) {
+      edges.push_back({ record.node_id, child_id, CONTROL_EDGE });
+    });
+  }
+
+  std::vector<LoopBoundRecord> loop_bounds;
+  for (auto& bound : program.loop_bounds)
+    loop_bounds.push_back({ bound.node_id, bound.target_loop_depth });
+
+  std::vector<LabelRecord> labels;
+  for (auto& label_pair : program.labelmap) {
+    const UniqueLabel& label = label_pair.second;
+    labels.push_back({ label_pair.first,
+                       data.addName(label.get_function()),
+                       data.addName(label.get_label()),
+                       label.get_line_number() });
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_cycles = num_cycles;
+  header.num_nodes = nodes.size();
+  header.num_edges = edges.size();
+  header.num_loop_bounds = loop_bounds.size();
+  header.num_labels = labels.size();
+  header.data_size = data.getData().size();
+
+  std::ofstream out(file_name, std::ios::binary);
+  if (!out) {
+    std::cerr << "[ERROR]: Failed to open the snapshot file " << file_name
+              << " for writing.\n";
+    exit(1);
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  writeArray(out, nodes);
+  writeArray(out, loop_bounds);
+  writeArray(out, labels);
+  writeArray(out, edges);
+  writeArray(out, data.getData());
+}
+
+void ScheduleSnapshot::open(const std::string& file_name) {
+  close();
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd == -1 || fstat(fd, &st) != 0) {
+    std::cerr << "[ERROR]: Failed to open the snapshot file " << file_name
+              << ".\n";
+    exit(1);
+  }
+  mapping_size = st.st_size;
+  if (mapping_size >= sizeof(Header)) {
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+      mapping = nullptr;
+  }
+  ::close(fd);
+  if (!mapping) {
+    std::cerr << "[ERROR]: Failed to map the snapshot file " << file_name
+              << ".\n";
+    exit(1);
+  }
+
+  header = static_cast<const Header*>(mapping);
+  bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->version == kVersion;
+  if (valid) {
+    size_t expected_size = sizeof(Header) +
+                           header->num_nodes * sizeof(NodeRecord) +
+                           header->num_loop_bounds * sizeof(LoopBoundRecord) +
+                           header->num_labels * sizeof(LabelRecord) +
+                           header->num_edges * sizeof(EdgeRecord) +
+                           header->data_size;
+    valid = expected_size == mapping_size;
+  }
+  if (!valid) {
+    std::cerr << "[ERROR]: " << file_name
+              << " is not a schedule snapshot of version " << kVersion
+              << ".\n";
+    exit(1);
+  }
+}
+
+void ScheduleSnapshot::close() {
+  if (mapping)
+    munmap(mapping, mapping_size);
+  mapping = nullptr;
+  mapping_size = 0;
+  header = nullptr;
+}
+
+unsigned ScheduleSnapshot::getNumCycles() const { return header->num_cycles; }
+unsigned ScheduleSnapshot::getNumNodes() const { return header->num_nodes; }
+unsigned ScheduleSnapshot::getNumEdges() const { return header->num_edges; }
+
+const ScheduleSnapshot::NodeRecord* ScheduleSnapshot::getNodes() const {
+  return reinterpret_cast<const NodeRecord*>(header + 1);
+}
+
+const ScheduleSnapshot::LoopBoundRecord* ScheduleSnapshot::getLoopBounds()
+    const {
+  return reinterpret_cast<const LoopBoundRecord*>(getNodes() +
+                                                  header->num_nodes);
+}
+
+const ScheduleSnapshot::LabelRecord* ScheduleSnapshot::getLabels() const {
+  return reinterpret_cast<const LabelRecord*>(getLoopBounds() +
+                                              header->num_loop_bounds);
+}
+
+const ScheduleSnapshot::EdgeRecord* ScheduleSnapshot::getEdges() const {
+  return reinterpret_cast<const EdgeRecord*>(getLabels() + header->num_labels);
+}
+
+const char* ScheduleSnapshot::getData() const {
+  return reinterpret_cast<const char*>(getEdges() + header->num_edges);
+}
+
+const char* ScheduleSnapshot::getString(uint32_t offset) const {
+  return offset == kNoString ? nullptr : getData() + offset;
+}
+
+void ScheduleSnapshot::restore(Program& program,
+                               SourceManager& srcManager) const {
+  program.clear();
+  program.labelmap.clear();
+  program.inline_labelmap.clear();
+
+  auto variable = [&](uint32_t offset) -> Variable* {
+    const char* name = getString(offset);
+    return name ? srcManager.insert<Variable>(name) : nullptr;
+  };
+
+  const NodeRecord* nodes = getNodes();
+  for (unsigned i = 0; i < header->num_nodes; i++) {
+    const NodeRecord& record = nodes[i];
+    ExecNode* node = program.insertNode(record.node_id, record.microop);
+    node->set_dynamic_invocation(record.dynamic_invocation);
+    node->set_line_num(record.line_num);
+    node->set_start_execution_cycle(record.start_cycle);
+    node->set_complete_execution_cycle(record.complete_cycle);
+    node->set_loop_depth(record.loop_depth);
+    node->set_partition_index(record.partition_index);
+    if (const char* name = getString(record.function))
+      node->set_static_function(srcManager.insert<Function>(name));
+    node->set_variable(variable(record.variable));
+    if (const char* name = getString(record.instruction))
+      node->set_static_inst(srcManager.insert<Instruction>(name));
+    if (const char* name = getString(record.basic_block))
+      node->set_basic_block(srcManager.insert<BasicBlock>(name));
+    if (const char* name = getString(record.array_label))
+      node->set_array_label(name);
+    if (const char* name = getString(record.special_math_op))
+      node->set_special_math_op(name);
+    node->set_isolated(record.flags & Isolated);
+    node->set_inductive(record.flags & Inductive);
+    node->set_dynamic_mem_op(record.flags & DynamicMemOp);
+    node->set_double_precision(record.flags & DoublePrecision);
+
+    MemAccess* mem_access = nullptr;
+    switch (record.mem_kind) {
+      case Scalar: {
+        ScalarMemAccess* scalar_access = new ScalarMemAccess();
+        scalar_access->set_value(record.mem_value);
+        scalar_access->is_float = record.flags & FloatValue;
+        mem_access = scalar_access;
+        break;
+      }
+      case Vector: {
+        VectorMemAccess* vector_access = new VectorMemAccess();
+        uint8_t* value = new uint8_t[record.mem_size];
+        memcpy(value, getData() + record.mem_value, record.mem_size);
+        vector_access->set_value(value);
+        mem_access = vector_access;
+        break;
+      }
+      case TimingOnly:
+        mem_access = new TimingMemAccess(record.mem_size);
+        break;
+      case Host:
+        mem_access = new HostMemAccess((MemoryType)record.memory_type,
+                                       record.mem_addr,
+                                       record.mem_src_addr,
+                                       record.mem_size,
+                                       variable(record.mem_src_var),
+                                       variable(record.mem_dst_var));
+        break;
+      case ReadyBits:
+        mem_access = new ReadyBitAccess(record.mem_addr,
+                                        record.mem_size,
+                                        variable(record.mem_src_var),
+                                        record.mem_value);
+        break;
+      default:
+        break;
+    }
+    if (mem_access) {
+      mem_access->vaddr = record.mem_addr;
+      mem_access->size = record.mem_size;
+      node->set_mem_access(mem_access);
+    }
+  }
+  program.createVertexMap();
+
+  const EdgeRecord* edges = getEdges();
+  for (unsigned i = 0; i < header->num_edges; i++)
+    program.addEdge(edges[i].from, edges[i].to, edges[i].parid);
+
+  const LoopBoundRecord* loop_bounds = getLoopBounds();
+  for (unsigned i = 0; i < header->num_loop_bounds; i++) {
+    program.loop_bounds.push_back(DynLoopBound(
+        loop_bounds[i].node_id, loop_bounds[i].target_loop_depth));
+  }
+
+  const LabelRecord* labels = getLabels();
+  for (unsigned i = 0; i < header->num_labels; i++) {
+    const LabelRecord& record = labels[i];
+    Function* function = srcManager.insert<Function>(getString(record.function));
+    Label* label = srcManager.insert<Label>(getString(record.label));
+    program.labelmap.insert(std::make_pair(
+        record.line, UniqueLabel(function, label, record.line_number)));
+  }
+}
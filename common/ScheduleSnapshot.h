@@ -0,0 +1,67 @@
+#ifndef _SCHEDULE_SNAPSHOT_H_
+#define _SCHEDULE_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+
+#include "Program.h"
+#include "SourceManager.h"
+
+/* A compact, read-only image of a program after it has been scheduled.
+ *
+ * The snapshot holds everything the debugger shows about a datapath: the node
+ * metadata and source info, the optimized edges (the implicit control edges of
+ * the barriers are stored as real ones), the start and complete cycle of every
+ * node, the loop bounds and the labelmap. It is written once after scheduling
+ * and can then be inspected any number of times without parsing the trace,
+ * optimizing the graph or scheduling it again.
+ *
+ * The file is a header followed by arrays of fixed size records and a data
+ * section with the strings they refer to, all suitably aligned, so it is read
+ * by mapping it into memory rather than by parsing it.
+ */
+class ScheduleSnapshot {
+ public:
+  ScheduleSnapshot() : mapping(nullptr), mapping_size(0), header(nullptr) {}
+  ~ScheduleSnapshot() { close(); }
+
+  // Write @program, scheduled in @num_cycles cycles, to @file_name.
+  static void write(const Program& program,
+                    unsigned num_cycles,
+                    const std::string& file_name);
+
+  // Map the snapshot in @file_name. Exits if it cannot be read or is not a
+  // snapshot of this version.
+  void open(const std::string& file_name);
+  void close();
+  bool isOpen() const { return mapping != nullptr; }
+
+  unsigned getNumCycles() const;
+  unsigned getNumNodes() const;
+  unsigned getNumEdges() const;
+
+  // Replace the contents of @program with the snapshot. The functions,
+  // variables and labels it refers to are added to @srcManager.
+  void restore(Program& program, SrcTypes::SourceManager& srcManager) const;
+
+ private:
+  struct Header;
+  struct NodeRecord;
+  struct EdgeRecord;
+  struct LoopBoundRecord;
+  struct LabelRecord;
+
+  const NodeRecord* getNodes() const;
+  const LoopBoundRecord* getLoopBounds() const;
+  const LabelRecord* getLabels() const;
+  const EdgeRecord* getEdges() const;
+  const char* getData() const;
+  // Return the string at @offset of the data section, or nullptr for none.
+  const char* getString(uint32_t offset) const;
+
+  void* mapping;
+  size_t mapping_size;
+  const Header* header;
+};
+
+#endif
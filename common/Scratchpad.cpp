@@ -1,10 +1,14 @@
 #include "Scratchpad.h"
 
 Scratchpad::Scratchpad(
-    unsigned ports_per_part, float cycle_time, bool _ready_mode) {
+    unsigned ports_per_part,
+    float cycle_time,
+    bool _ready_mode,
+    bool _timing_only) {
   num_ports = ports_per_part;
   cycleTime = cycle_time;
   ready_mode = _ready_mode;
+  timing_only = _timing_only;
 }
 
 Scratchpad::~Scratchpad() { clear(); }
@@ -14,6 +18,7 @@ void Scratchpad::clear() {
     delete it->second;
   }
   logical_arrays.clear();
+  array_slots.clear();
 }
 
 // wordsize in bytes
@@ -26,8 +31,9 @@ void Scratchpad::setScratchpad(std::string baseName,
   assert(!partitionExist(baseName));
   LogicalArray* curr_base = new LogicalArray(
       baseName, base_addr, part_type, part_factor, num_of_bytes, wordsize,
-      num_ports, ready_mode);
+      num_ports, ready_mode, timing_only);
   logical_arrays[baseName] = curr_base;
+  array_slots.push_back(curr_base);
 }
 
 void Scratchpad::step() {
@@ -121,3 +127,20 @@ void Scratchpad::dumpStats(std::ofstream& outfile) {
   }
   outfile << "===============\n";
 }
+
+void Scratchpad::saveState(CheckpointWriter& out) const {
+  out.put<uint32_t>(array_slots.size());
+  for (const LogicalArray* array : array_slots) {
+    out.putString(array->getBaseName());
+    array->saveState(out);
+  }
+}
+
+void Scratchpad::restoreState(CheckpointReader& in) {
+  in.check(in.get<uint32_t>() == array_slots.size(),
+           "the number of scratchpad arrays");
+  for (LogicalArray* array : array_slots) {
+    in.check(in.getString() == array->getBaseName(), "the scratchpad arrays");
+    array->restoreState(in);
+  }
+}
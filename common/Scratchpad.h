@@ -1,8 +1,11 @@
 #ifndef __SCRATCHPAD__
 #define __SCRATCHPAD__
 
+#include <algorithm>
+
 #include "Partition.h"
 #include "LogicalArray.h"
+#include "SpadAccessDescriptor.h"
 
 /* Definitions of three classes for Scratchpad processing.
  *
@@ -18,7 +21,12 @@
 
 class Scratchpad {
  public:
-  Scratchpad(unsigned p_ports_per_part, float cycle_time, bool ready_mode);
+  /* If timing_only is true, the partitions do not store any data (see
+   * UserConfigParams::timing_only). */
+  Scratchpad(unsigned p_ports_per_part,
+             float cycle_time,
+             bool ready_mode,
+             bool timing_only = false);
   virtual ~Scratchpad();
   void clear();
   void step();
@@ -35,6 +43,36 @@ class Scratchpad {
                            bool isLoad);
   bool partitionExist(std::string baseName);
 
+  /* Decode an access to @addr in array @baseName once, so that it can be
+   * checked and counted below without looking up the array or recomputing
+   * the partition and block on every attempt. Throws UnknownArrayException
+   * or ArrayAccessException like canServicePartition(). */
+  SpadAccessDescriptor decodeAccess(const std::string& baseName, Addr addr) {
+    SpadAccessDescriptor access;
+    access.array_slot = getArraySlot(baseName);
+    array_slots[access.array_slot]->decodeAddress(
+        addr, &access.part_index, &access.blk_index);
+    return access;
+  }
+  bool canServiceAccess(const SpadAccessDescriptor& access, bool isLoad) {
+    return array_slots[access.array_slot]->canServiceBlock(
+        access.part_index, access.blk_index, isLoad);
+  }
+  void increment_loads(const SpadAccessDescriptor& access) {
+    array_slots[access.array_slot]->increment_loads(access.part_index);
+  }
+  void increment_stores(const SpadAccessDescriptor& access) {
+    array_slots[access.array_slot]->increment_stores(access.part_index);
+  }
+  /* The number of ports of each partition of the array an access lands in,
+   * and the energy of the access. Neither changes any stats. */
+  unsigned getNumPorts(const SpadAccessDescriptor& access) const {
+    return array_slots[access.array_slot]->getNumPorts();
+  }
+  float getAccessEnergy(const SpadAccessDescriptor& access, bool isLoad) const {
+    return array_slots[access.array_slot]->getAccessEnergy(isLoad);
+  }
+
   size_t getPartitionIndex(std::string arrayName, Addr abs_addr) {
     return getLogicalArray(arrayName)->getPartitionIndex(abs_addr);
   }
@@ -126,6 +164,11 @@ class Scratchpad {
 
   void dumpStats(std::ofstream& stats_file);
 
+  /* Save or restore the port usage, access counters and ready bits of every
+   * array for a checkpoint. */
+  void saveState(CheckpointWriter& out) const;
+  void restoreState(CheckpointReader& in);
+
  private:
   LogicalArray* getLogicalArray(const std::string& name) {
     auto it = logical_arrays.find(name);
@@ -135,12 +178,22 @@ class Scratchpad {
     return logical_arrays.at(name);
   }
 
+  unsigned getArraySlot(const std::string& name) {
+    LogicalArray* array = getLogicalArray(name);
+    return std::find(array_slots.begin(), array_slots.end(), array) -
+           array_slots.begin();
+  }
+
   /* Num of read/write ports per partition. */
   unsigned num_ports;
   /* Set if ReadyPartition is used. */
   bool ready_mode;
+  /* Set if the partitions do not store data. */
+  bool timing_only;
   float cycleTime;  // in ns
   std::unordered_map<std::string, LogicalArray*> logical_arrays;
+  /* The same arrays, indexed by the slot used in SpadAccessDescriptors. */
+  std::vector<LogicalArray*> array_slots;
 };
 
 #endif
@@ -19,31 +19,63 @@ ScratchpadDatapath::ScratchpadDatapath(std::string bench,
   std::cout << "-------------------------------" << std::endl;
   scratchpad = new Scratchpad(user_params.scratchpad_ports,
                               user_params.cycle_time,
-                              user_params.ready_mode);
+                              user_params.ready_mode,
+                              user_params.timing_only);
+  memory_system = new MemorySystemModel(user_params.mem_system);
   scratchpadCanService = true;
   mem_reg_conversion_executed = false;
   scratchpad_partition_executed = false;
 }
 
-ScratchpadDatapath::~ScratchpadDatapath() { delete scratchpad; }
+ScratchpadDatapath::~ScratchpadDatapath() {
+  delete scratchpad;
+  delete memory_system;
+}
 
 void ScratchpadDatapath::clearDatapath() {
   BaseDatapath::clearDatapath();
+  // The next invocation starts again from cycle zero.
+  delete memory_system;
+  memory_system = new MemorySystemModel(user_params.mem_system);
+  inflight_memory_system_nodes.clear();
+}
+
+void ScratchpadDatapath::reconfigure(const Program& prog,
+                                     const UserConfigParams& params,
+                                     const ProgramInfo& info) {
+  BaseDatapath::reconfigure(prog, params, info);
+  // The scratchpad geometry depends on the configuration, so build it again.
+  cycle_time = user_params.cycle_time;
+  delete scratchpad;
+  scratchpad = new Scratchpad(user_params.scratchpad_ports,
+                              user_params.cycle_time,
+                              user_params.ready_mode,
+                              user_params.timing_only);
+  delete memory_system;
+  memory_system = new MemorySystemModel(user_params.mem_system);
+  inflight_memory_system_nodes.clear();
+  scratchpadCanService = true;
+  inflight_multicycle_nodes.clear();
+  mem_reg_conversion_executed = false;
+  scratchpad_partition_executed = false;
 }
 
 void ScratchpadDatapath::globalOptimizationPass() {
+  Profiler::Phase phase(profiler, "globalOptimizationPass");
+  optimizeGraph();
+  assignMemories();
+  phase.setWork(program.nodes.size(), boost::num_edges(program.graph));
+}
+
+void ScratchpadDatapath::optimizeGraph() {
   std::cout << "=============================================" << std::endl;
   std::cout << "      Optimizing...            " << benchName << std::endl;
   std::cout << "=============================================" << std::endl;
-  // Node removals must come first.
-  removePhiNodes();
-  /* memoryAmbiguation() should execute after removeInductionDependence()
-   * because it needs induction_nodes. */
-  removeInductionDependence();
+  // Node removals must come first. Inductive nodes are already marked when the
+  // DDDG is built.
+  removeDeadNodes();
   // Base address must be initialized next.
   initBaseAddress();
-  completePartition();
-  scratchpadPartition();
   loopFlatten();
   loopUnrolling();
   removeSharedLoads();
@@ -57,36 +89,53 @@ void ScratchpadDatapath::globalOptimizationPass() {
   // fixed
   perLoopPipelining();
   loopPipelining();
+  restoreCachedProgram();
+}
+
+void ScratchpadDatapath::assignMemories() {
+  // None of the graph optimizations read the registers or the partition
+  // indices, so they are assigned last. This keeps the partition factors out
+  // of the keys of the graph cache.
+  completePartition();
+  scratchpadPartition();
 }
 
 /* First, compute all base addresses, then check each node to make sure that
  * each entry is valid.
  */
 void ScratchpadDatapath::initBaseAddress() {
-  BaseDatapath::initBaseAddress();
-  BaseDatapath::initDmaBaseAddress();
-
-  vertex_iter vi, vi_end;
-  for (boost::tie(vi, vi_end) = vertices(program.graph); vi != vi_end; ++vi) {
-    if (boost::degree(*vi, program.graph) == 0)
-      continue;
-    Vertex curr_vertex = *vi;
-    ExecNode* node = program.nodeAtVertex(curr_vertex);
-    if (!node->is_memory_op())
-      continue;
-    const std::string& part_name = node->get_array_label();
-    if (user_params.partition.find(part_name) == user_params.partition.end()) {
-      std::cerr << "Unknown partition : " << part_name
-                << " at node: " << node->get_node_id() << std::endl;
-      exit(-1);
+  // The DMA base addresses and the check below read the array declarations.
+  runCachedStage("ScratchpadDatapath::initBaseAddress",
+                 UserConfigParams::PartitionLayout,
+                 [this]() {
+    BaseDatapath::initBaseAddress();
+    BaseDatapath::initDmaBaseAddress();
+
+    vertex_iter vi, vi_end;
+    for (boost::tie(vi, vi_end) = vertices(program.graph); vi != vi_end;
+         ++vi) {
+      Vertex curr_vertex = *vi;
+      ExecNode* node = program.nodeAtVertex(curr_vertex);
+      if (program.getDegree(node) == 0)
+        continue;
+      if (!node->is_memory_op())
+        continue;
+      const std::string& part_name = node->get_array_label();
+      if (user_params.partition.find(part_name) ==
+          user_params.partition.end()) {
+        std::cerr << "Unknown partition : " << part_name
+                  << " at node: " << node->get_node_id() << std::endl;
+        exit(-1);
+      }
     }
-  }
+  });
 }
 
 /*
  * Modify scratchpad
  */
 void ScratchpadDatapath::completePartition() {
+  Profiler::Phase phase(profiler, "completePartition");
   if (mem_reg_conversion_executed)
     return;
 
@@ -115,6 +164,7 @@ void ScratchpadDatapath::completePartition() {
  * Modify: baseAddress
  */
 void ScratchpadDatapath::scratchpadPartition() {
+  Profiler::Phase phase(profiler, "scratchpadPartition");
   // read the partition config file to get the address range
   // <base addr, <type, part_factor> >
   if (!user_params.partition.size())
@@ -160,45 +210,49 @@ void ScratchpadDatapath::scratchpadPartition() {
       scratchpad->setLogicalArrayBaseAddress(array_label, base_addr);
     }
   }
-  if (!spad_partition)
-    return;
-  scratchpad_partition_executed = true;
+  if (spad_partition)
+    scratchpad_partition_executed = true;
 
+  // Resolve which memory services each node, and decode the scratchpad
+  // accesses, so that the scheduler does neither on every attempt.
   for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
        ++node_it) {
     ExecNode* node = node_it->second;
-    if (!node->is_memory_op())
+    if (!node->is_memory_op() && !node->is_host_mem_op())
       continue;
-    if (boost::degree(node->get_vertex(), program.graph) == 0)
+    if (program.getDegree(node) == 0)
       continue;
     const std::string& base_label = node->get_array_label();
 
-    auto part_it = user_params.partition.find(base_label);
-    if (part_it != user_params.partition.end()) {
-      PartitionType p_type = part_it->second.partition_type;
-      MemoryType m_type = part_it->second.memory_type;
-      /* continue if it's complete partition, cache, or acp. */
-      if (p_type == complete || m_type != spad)
+    try {
+      MemoryOpType type = getMemoryOpType(node);
+      bool local = type == MemoryOpType::Register ||
+                   type == MemoryOpType::Scratchpad;
+      // Standalone Aladdin does not model host accesses to local memory.
+      if (!node->is_memory_op() && local)
+        type = MemoryOpType::NumMemoryOpTypes;
+      node->set_memory_op_type(type);
+      if (type != MemoryOpType::Scratchpad)
         continue;
-      assert(p_type == block || p_type == cyclic);
 
       MemAccess* mem_access = node->get_mem_access();
       Addr abs_addr = mem_access->vaddr;
       unsigned data_size = mem_access->size;  // in bytes
       assert(data_size != 0 && "Memory access size must be >= 1 byte.");
-      try {
-        node->set_partition_index(
-            scratchpad->getPartitionIndex(base_label, abs_addr));
-      } catch (UnknownArrayException& e) {
-        std::cerr << "[ERROR]: At node " << node->get_node_id()
-                  << ", could not set partition index on array \"" << base_label
-                  << "\" because it does not exist!" << std::endl;
-        exit(1);
-      } catch (ArrayAccessException& e) {
-        std::cerr << "[ERROR]: At node " << node->get_node_id()
-                  << ", invalid array access: " << e.what() << std::endl;
-        exit(1);
-      }
+      node->set_spad_access(scratchpad->decodeAccess(base_label, abs_addr));
+    } catch (UnknownArrayException& e) {
+      std::cerr << "[ERROR]: Node " << node->get_node_id()
+                << " tried to access array \"" << base_label
+                << "\", which does not exist: " << e.what() << std::endl;
+      exit(1);
+    } catch (ArrayAccessException& e) {
+      std::cerr << "[ERROR]: At node " << node->get_node_id()
+                << ", invalid array access: " << e.what() << std::endl;
+      exit(1);
+    } catch (AladdinException& e) {
+      std::cerr << "[ERROR]: At node " << node->get_node_id() << ": "
+                << e.what() << std::endl;
+      exit(1);
     }
   }
 #ifdef DEBUG
@@ -210,6 +264,8 @@ bool ScratchpadDatapath::step() {
   if (!BaseDatapath::step()) {
     scratchpad->step();
     scratchpadCanService = true;
+    memory_system->step(num_cycles);
+    checkpointIfDue();
     return false;
   } else {
     return true;
@@ -222,43 +278,52 @@ void ScratchpadDatapath::stepExecutingQueue() {
   while (it != executingQueue.end()) {
     ExecNode* node = *it;
     bool executed = false;
-    if (node->is_memory_op()) {
-      const std::string& array_name = node->get_array_label();
-      unsigned array_name_index = node->get_partition_index();
-      if (registers.has(array_name)) {
-        markNodeStarted(node);
-        if (node->is_load_op())
-          registers.getRegister(array_name)->increment_loads();
-        else
-          registers.getRegister(array_name)->increment_stores();
-        markNodeCompleted(it, index);
-        executed = true;
-      } else if (scratchpadCanService) {
-        PartitionEntry partition = user_params.partition.at(array_name);
-        assert(partition.memory_type != dma &&
-               "Host memory accesses are not supported by standalone Aladdin!");
-        MemAccess* mem_access = node->get_mem_access();
-        Addr vaddr = mem_access->vaddr;
-        bool isLoad = node->is_load_op();
-        try {
-          if (scratchpad->canServicePartition(
-                  array_name, array_name_index, vaddr, isLoad)) {
+    if (node->is_memory_op() || node->is_host_mem_op()) {
+      // The memory op type was resolved by scratchpadPartition().
+      MemoryOpType type = node->get_memory_op_type();
+      switch (type) {
+        case MemoryOpType::Cache:
+        case MemoryOpType::ACP:
+        case MemoryOpType::Dma:
+          executed = stepMemorySystemOp(node, type);
+          if (executed)
+            markNodeCompleted(it, index);
+          break;
+        case MemoryOpType::Register:
+          markNodeStarted(node);
+          if (node->is_load_op())
+            registers.getRegister(node->get_array_label())->increment_loads();
+          else
+            registers.getRegister(node->get_array_label())->increment_stores();
+          markNodeCompleted(it, index);
+          executed = true;
+          break;
+        case MemoryOpType::Scratchpad: {
+          if (!scratchpadCanService)
+            break;
+          // The access was decoded by scratchpadPartition().
+          const SpadAccessDescriptor& access = node->get_spad_access();
+          bool isLoad = node->is_load_op();
+          if (scratchpad->canServiceAccess(access, isLoad)) {
             markNodeStarted(node);
             if (isLoad)
-              scratchpad->increment_loads(array_name, array_name_index);
+              scratchpad->increment_loads(access);
             else
-              scratchpad->increment_stores(array_name, array_name_index);
+              scratchpad->increment_stores(access);
             markNodeCompleted(it, index);
             executed = true;
           } else {
             scratchpadCanService = scratchpad->canService();
           }
-        } catch (UnknownArrayException& e) {
-          std::cerr << "[ERROR]: Node " << node->get_node_id()
-                    << " tried to access array \"" << array_name
-                    << "\", which does not exist: " << e.what() << std::endl;
-          exit(1);
+          break;
         }
+        default:
+          // Standalone Aladdin does not model ready bits, nor host accesses to
+          // local memory.
+          markNodeStarted(node);
+          markNodeCompleted(it, index);
+          executed = true;
+          break;
       }
     } else if (node->is_multicycle_op()) {
       unsigned node_id = node->get_node_id();
@@ -288,9 +353,185 @@ void ScratchpadDatapath::stepExecutingQueue() {
   }
 }
 
+void ScratchpadDatapath::saveSchedulerState(CheckpointWriter& out) const {
+  out.put<uint8_t>(scratchpadCanService);
+  out.put<uint64_t>(inflight_multicycle_nodes.size());
+  for (auto& node_pair : inflight_multicycle_nodes) {
+    out.put<uint32_t>(node_pair.first);
+    out.put<uint32_t>(node_pair.second);
+  }
+  out.put<uint64_t>(inflight_memory_system_nodes.size());
+  for (auto& node_pair : inflight_memory_system_nodes) {
+    out.put<uint32_t>(node_pair.first);
+    out.put<int32_t>(node_pair.second);
+  }
+  scratchpad->saveState(out);
+  memory_system->saveState(out);
+}
+
+void ScratchpadDatapath::restoreSchedulerState(CheckpointReader& in) {
+  scratchpadCanService = in.get<uint8_t>();
+  inflight_multicycle_nodes.clear();
+  uint64_t num_inflight = in.get<uint64_t>();
+  for (uint64_t i = 0; i < num_inflight; i++) {
+    unsigned node_id = in.get<uint32_t>();
+    inflight_multicycle_nodes[node_id] = in.get<uint32_t>();
+  }
+  inflight_memory_system_nodes.clear();
+  num_inflight = in.get<uint64_t>();
+  for (uint64_t i = 0; i < num_inflight; i++) {
+    unsigned node_id = in.get<uint32_t>();
+    inflight_memory_system_nodes[node_id] = in.get<int32_t>();
+  }
+  scratchpad->restoreState(in);
+  memory_system->restoreState(in);
+}
+
+void ScratchpadDatapath::getStatsFiles(std::vector<std::string>& file_names) {
+  BaseDatapath::getStatsFiles(file_names);
+  file_names.push_back(benchName + "_spad_stats.txt");
+  file_names.push_back(benchName + "_mem_system_stats.txt");
+}
+
+MemoryOpType ScratchpadDatapath::getMemoryOpType(
+    const std::string& array_label) {
+  auto it = user_params.partition.find(array_label);
+  if (it == user_params.partition.end())
+    throw UnknownArrayException(array_label);
+  switch (it->second.memory_type) {
+    case spad:
+      return MemoryOpType::Scratchpad;
+    case reg:
+      return MemoryOpType::Register;
+    case dma:
+      return MemoryOpType::Dma;
+    case acp:
+      return MemoryOpType::ACP;
+    case cache:
+      return MemoryOpType::Cache;
+    default:
+      throw IllegalHostMemoryAccessException(array_label);
+  }
+}
+
+MemoryOpType ScratchpadDatapath::getMemoryOpType(ExecNode* node) {
+  if (node->is_dma_load() || node->is_dma_store() || node->is_dma_fence())
+    return MemoryOpType::Dma;
+  if (node->is_set_ready_bits())
+    return MemoryOpType::ReadyBits;
+
+  if (node->is_host_mem_op()) {
+    HostMemAccess* mem_access = node->get_host_mem_access();
+    bool isLoad = node->is_host_load();
+    const std::string& array_label = isLoad ? mem_access->src_var->get_name()
+                                            : mem_access->dst_var->get_name();
+    return getMemoryOpType(array_label);
+  }
+  assert(node->is_memory_op() &&
+         "Memory op types are only defined for local and host memory ops!");
+  return getMemoryOpType(node->get_array_label());
+}
+
+bool ScratchpadDatapath::stepMemorySystemOp(ExecNode* node,
+                                            MemoryOpType type) {
+  unsigned node_id = node->get_node_id();
+  auto inflight_it = inflight_memory_system_nodes.find(node_id);
+  if (inflight_it != inflight_memory_system_nodes.end()) {
+    if (inflight_it->second > num_cycles)
+      return false;
+    inflight_memory_system_nodes.erase(inflight_it);
+    return true;
+  }
+
+  int done_cycle = num_cycles;
+  if (type == MemoryOpType::Dma) {
+    if (node->is_dma_fence()) {
+      markNodeStarted(node);
+      return true;
+    }
+    if (!node->is_host_mem_op()) {
+      std::cerr << "[ERROR]: At node " << node_id << ", array \""
+                << node->get_array_label()
+                << "\" is only accessible by DMA." << std::endl;
+      exit(1);
+    }
+    HostMemAccess* mem_access = node->get_host_mem_access();
+    bool isLoad = node->is_dma_load();
+    // A DMA load reads from the host, and a DMA store writes to it.
+    Addr host_addr = isLoad ? mem_access->src_addr : mem_access->vaddr;
+    done_cycle = memory_system->issueDmaTransfer(
+        host_addr, mem_access->size, isLoad, num_cycles);
+  } else {
+    MemAccess* mem_access = node->get_mem_access();
+    bool isLoad = node->is_load_op() || node->is_host_load();
+    if (type == MemoryOpType::Cache) {
+      done_cycle = memory_system->issueCacheAccess(
+          mem_access->vaddr, mem_access->size, isLoad, num_cycles);
+    } else {
+      done_cycle = memory_system->issueAcpAccess(
+          mem_access->vaddr, mem_access->size, isLoad, num_cycles);
+    }
+    // The request queue is full. Try again next cycle.
+    if (done_cycle < 0)
+      return false;
+  }
+  markNodeStarted(node);
+  if (done_cycle <= num_cycles)
+    return true;
+  inflight_memory_system_nodes[node_id] = done_cycle;
+  return false;
+}
+
+int ScratchpadDatapath::computeMemoryBoundCycles() {
+  // Accesses to each partition of each scratchpad array, by array slot and
+  // partition index, and to the cache and ACP, which share one request queue.
+  std::map<std::pair<unsigned, unsigned>, unsigned> partition_accesses;
+  unsigned cache_accesses = 0;
+  unsigned bound = 0;
+  for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
+       ++node_it) {
+    ExecNode* node = node_it->second;
+    if (node->is_isolated())
+      continue;
+    // Registers never stall, and DMA transfers are left to the scheduler.
+    MemoryOpType type = node->get_memory_op_type();
+    if (type == MemoryOpType::Cache || type == MemoryOpType::ACP) {
+      cache_accesses++;
+    } else if (type == MemoryOpType::Scratchpad) {
+      const SpadAccessDescriptor& access = node->get_spad_access();
+      unsigned num_ports = scratchpad->getNumPorts(access);
+      if (num_ports == 0)
+        continue;
+      unsigned accesses =
+          ++partition_accesses[std::make_pair(access.array_slot,
+                                              access.part_index)];
+      bound = std::max(bound, (accesses + num_ports - 1) / num_ports);
+    }
+  }
+  unsigned cache_bandwidth = user_params.mem_system.cache_bandwidth;
+  if (cache_bandwidth != 0) {
+    bound = std::max(bound,
+                     (cache_accesses + cache_bandwidth - 1) / cache_bandwidth);
+  }
+  return bound;
+}
+
+float ScratchpadDatapath::computeMemoryDynamicEnergy() {
+  float energy = 0;
+  for (auto node_it = program.nodes.begin(); node_it != program.nodes.end();
+       ++node_it) {
+    ExecNode* node = node_it->second;
+    if (node->is_isolated() ||
+        node->get_memory_op_type() != MemoryOpType::Scratchpad)
+      continue;
+    energy += scratchpad->getAccessEnergy(node->get_spad_access(),
+                                          node->is_load_op());
+  }
+  return energy;
+}
+
 int ScratchpadDatapath::rescheduleNodesWhenNeeded() {
-  std::vector<Vertex> topo_nodes;
-  boost::topological_sort(program.graph, std::back_inserter(topo_nodes));
+  std::vector<Vertex> topo_nodes = program.getReverseTopologicalOrder();
   // bottom nodes first
   std::map<unsigned, int> alap_finish_time;
   for (auto node_it : program.nodes)
@@ -318,7 +559,7 @@ int ScratchpadDatapath::rescheduleNodesWhenNeeded() {
         } else {
           node->set_start_execution_cycle(new_cycle);
           alap_start_execution_time =
-              alap_complete_execution_time - node->fu_node_latency(cycle_time);
+              alap_complete_execution_time - node->get_fu_node_latency();
         }
       }
     }
@@ -330,6 +571,10 @@ int ScratchpadDatapath::rescheduleNodesWhenNeeded() {
       if (alap_finish_time.at(parent_id) > alap_start_execution_time)
         alap_finish_time.at(parent_id) = alap_start_execution_time;
     }
+    program.barriers.forEachParent(node_id, [&](unsigned parent_id) {
+      if (alap_finish_time.at(parent_id) > alap_start_execution_time)
+        alap_finish_time.at(parent_id) = alap_start_execution_time;
+    });
   }
   return num_cycles;
 }
@@ -356,20 +601,15 @@ void ScratchpadDatapath::updateChildren(ExecNode* node) {
   } else {
     if (node->get_time_before_execution() > num_cycles * cycle_time) {
       latency_after_current_node =
-          node->fu_node_latency(cycle_time) + node->get_time_before_execution();
+          node->get_fu_node_latency() + node->get_time_before_execution();
     } else {
       latency_after_current_node =
-          node->fu_node_latency(cycle_time) + num_cycles * cycle_time;
+          node->get_fu_node_latency() + num_cycles * cycle_time;
     }
   }
-  Vertex curr_vertex = node->get_vertex();
-  out_edge_iter out_edge_it, out_edge_end;
-  for (boost::tie(out_edge_it, out_edge_end) = out_edges(curr_vertex, program.graph);
-       out_edge_it != out_edge_end;
-       ++out_edge_it) {
-    Vertex child_vertex = target(*out_edge_it, program.graph);
-    ExecNode* child_node = program.nodeAtVertex(child_vertex);
-    int edge_parid = edgeToParid[*out_edge_it];
+  bool curr_zero_latency =
+      !node->is_memory_op() && node->get_fu_node_latency() == 0;
+  auto update_child = [&](ExecNode* child_node, int edge_parid) {
     float child_earliest_time = child_node->get_time_before_execution();
     if (child_earliest_time < latency_after_current_node) {
       child_node->set_time_before_execution(latency_after_current_node);
@@ -377,13 +617,8 @@ void ScratchpadDatapath::updateChildren(ExecNode* node) {
     if (child_node->get_num_parents() > 0) {
       child_node->decr_num_parents();
       if (child_node->get_num_parents() == 0) {
-        bool child_zero_latency =
-            (child_node->is_memory_op())
-                ? false
-                : (child_node->fu_node_latency(cycle_time) == 0);
-        bool curr_zero_latency = (node->is_memory_op())
-                                     ? false
-                                     : (node->fu_node_latency(cycle_time) == 0);
+        bool child_zero_latency = !child_node->is_memory_op() &&
+                                  child_node->get_fu_node_latency() == 0;
         if (edge_parid == REGISTER_EDGE || edge_parid == FUSED_BRANCH_EDGE ||
             node->is_call_op() || node->is_ret_op() ||
             ((child_zero_latency || curr_zero_latency) &&
@@ -403,7 +638,7 @@ void ScratchpadDatapath::updateChildren(ExecNode* node) {
             readyToExecuteQueue.push_back(child_node);
           } else {
             float after_child_time = child_node->get_time_before_execution() +
-                                     child_node->fu_node_latency(cycle_time);
+                                     child_node->get_fu_node_latency();
             if (after_child_time < (num_cycles + 1) * cycle_time)
               executingQueue.push_back(child_node);
             else
@@ -413,7 +648,19 @@ void ScratchpadDatapath::updateChildren(ExecNode* node) {
         child_node->set_num_parents(-1);
       }
     }
+  };
+  Vertex curr_vertex = node->get_vertex();
+  out_edge_iter out_edge_it, out_edge_end;
+  for (boost::tie(out_edge_it, out_edge_end) = out_edges(curr_vertex, program.graph);
+       out_edge_it != out_edge_end;
+       ++out_edge_it) {
+    Vertex child_vertex = target(*out_edge_it, program.graph);
+    update_child(program.nodeAtVertex(child_vertex),
+                 edgeToParid[*out_edge_it]);
   }
+  program.barriers.forEachChild(node->get_node_id(), [&](unsigned child_id) {
+    update_child(program.nodes.at(child_id), CONTROL_EDGE);
+  });
 }
 
 #ifdef USE_DB
@@ -461,4 +708,12 @@ void ScratchpadDatapath::writeOtherStats() {
   spad_stats_file.open(file_name.c_str(), std::ofstream::out | std::ofstream::app);
   scratchpad->dumpStats(spad_stats_file);
   spad_stats_file.close();
+
+  if (memory_system->hasAccesses()) {
+    std::ofstream mem_stats_file;
+    file_name = benchName + "_mem_system_stats.txt";
+    mem_stats_file.open(file_name.c_str(), std::ofstream::out | std::ofstream::app);
+    memory_system->dumpStats(mem_stats_file);
+    mem_stats_file.close();
+  }
 }
@@ -5,6 +5,7 @@
 
 #include "BaseDatapath.h"
 #include "ExecNode.h"
+#include "MemorySystemModel.h"
 #include "Scratchpad.h"
 
 class ScratchpadDatapath : public BaseDatapath {
@@ -16,9 +17,18 @@ class ScratchpadDatapath : public BaseDatapath {
   virtual ~ScratchpadDatapath();
 
   void globalOptimizationPass();
+  // The two halves of globalOptimizationPass(). optimizeGraph() only changes
+  // the program, so it can run on another datapath than the one that
+  // schedules it; assignMemories() sets up the registers and scratchpad of
+  // this datapath for the optimized program.
+  void optimizeGraph();
+  void assignMemories();
   void completePartition();
   void scratchpadPartition();
   virtual void clearDatapath();
+  virtual void reconfigure(const Program& prog,
+                           const UserConfigParams& params,
+                           const ProgramInfo& info);
   virtual void initBaseAddress();
   virtual void stepExecutingQueue();
   virtual bool step();
@@ -30,17 +40,39 @@ class ScratchpadDatapath : public BaseDatapath {
   virtual void getMemoryBlocks(std::vector<std::string>& names);
   virtual void updateChildren(ExecNode* node);
   virtual int rescheduleNodesWhenNeeded();
+  virtual int computeMemoryBoundCycles();
+  virtual float computeMemoryDynamicEnergy();
 
  protected:
   virtual void writeOtherStats();
+  virtual void saveSchedulerState(CheckpointWriter& out) const;
+  virtual void restoreSchedulerState(CheckpointReader& in);
+  virtual void getStatsFiles(std::vector<std::string>& file_names);
+
+  /* Returns the memory op type for this node (or array label).
+   *
+   * The memory op type depends on the datapath's particular configuration,
+   * so this must be determined by the datapath.
+   */
+  MemoryOpType getMemoryOpType(ExecNode* node);
+  MemoryOpType getMemoryOpType(const std::string& array_label);
+
+  /* Issue a cache, ACP or DMA node to the memory system model, or check on it
+   * if it was already issued. Returns true once the node has completed. */
+  bool stepMemorySystemOp(ExecNode* node, MemoryOpType type);
+
   Scratchpad* scratchpad;
+  /* Stands in for the caches, ACP and DMA engine that gem5 would provide. */
+  MemorySystemModel* memory_system;
+  /* The cycle at which each node issued to the memory system completes. */
+  std::map<unsigned, int> inflight_memory_system_nodes;
   /*True if any of the scratchpads can still service memory requests.
     False if non of the scratchpads can service any memory requests.*/
   bool scratchpadCanService;
   /* Stores number of cycles left for multi-cycle nodes currently in flight. */
   std::map<unsigned, unsigned> inflight_multicycle_nodes;
   // To streamline code.
-  const float cycle_time;
+  float cycle_time;
 
   // If we invoke the same accelerator more than once, we don't need to create
   // scratchpad objects again.  (the scratchpads can't change), but we will
@@ -0,0 +1,19 @@
+#ifndef __SPAD_ACCESS_DESCRIPTOR_H__
+#define __SPAD_ACCESS_DESCRIPTOR_H__
+
+// Where a scratchpad access lands: the logical array (by its slot in the
+// Scratchpad), the partition of that array, and the block within the
+// partition. Scratchpad::decodeAccess() produces it; ScratchpadDatapath stores
+// one on each scratchpad node so that the scheduler does not repeat the
+// lookup on every attempt to issue it.
+//
+// This is kept out of Scratchpad.h because ExecNode holds one by value, and
+// Scratchpad.h (through Partition.h and user_config.h) includes ExecNode.h.
+struct SpadAccessDescriptor {
+  SpadAccessDescriptor() : array_slot(0), part_index(0), blk_index(0) {}
+  unsigned array_slot;
+  unsigned part_index;
+  unsigned blk_index;
+};
+
+#endif
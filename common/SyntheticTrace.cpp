@@ -0,0 +1,441 @@
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "opcode_func.h"
+#include "SyntheticTrace.h"
+
+// Base addresses of the accelerator and host arrays. Each array gets its own
+// page-aligned region.
+static const unsigned long kAccArrayBase = 0x10000000;
+static const unsigned long kHostArrayBase = 0x80000000;
+// Addresses of the DMA runtime functions, as they appear in real traces.
+static const unsigned long kDmaLoadFunc = 0x406b40;
+static const unsigned long kDmaStoreFunc = 0x406c90;
+static const unsigned long kDmaFenceFunc = 0x40b5a0;
+static const unsigned long kSetReadyBitsFunc = 0x406d10;
+// Flush the write buffer once it grows past this many bytes.
+static const size_t kBufferSize = 1 << 20;
+
+static std::string toHex(unsigned long value) {
+  std::stringstream stream;
+  stream << "0x" << std::hex << value;
+  return stream.str();
+}
+
+SyntheticTraceGenerator::SyntheticTraceGenerator(
+    const SyntheticTraceParams& _params)
+    : params(_params), rng(_params.seed), file(nullptr), num_nodes(0),
+      last_stored_element(-1) {
+  if (params.trip_counts.empty()) {
+    std::cerr << "[ERROR]: A synthetic trace needs at least one loop."
+              << std::endl;
+    exit(1);
+  }
+  if (params.num_inputs == 0 || params.array_elements == 0) {
+    std::cerr << "[ERROR]: A synthetic trace needs at least one input array "
+                 "with at least one element." << std::endl;
+    exit(1);
+  }
+  if (params.word_size != 4 && params.word_size != 8) {
+    std::cerr << "[ERROR]: The word size of a synthetic trace must be 4 or 8 "
+                 "bytes." << std::endl;
+    exit(1);
+  }
+}
+
+std::string SyntheticTraceGenerator::getArrayName(unsigned index) const {
+  if (index < params.num_inputs)
+    return "in" + std::to_string(index);
+  return "out";
+}
+
+std::string SyntheticTraceGenerator::getLoopName(unsigned level) const {
+  return "loop" + std::to_string(level);
+}
+
+std::string SyntheticTraceGenerator::getBlockName(const std::string& name,
+                                                  unsigned depth) const {
+  return name + ":" + std::to_string(depth);
+}
+
+SyntheticTraceGenerator::Operand SyntheticTraceGenerator::reg(
+    unsigned size, const std::string& value, const std::string& name) {
+  return { size, value, name };
+}
+
+SyntheticTraceGenerator::Operand SyntheticTraceGenerator::constant(
+    unsigned size, long value) {
+  return { size, std::to_string(value), "" };
+}
+
+SyntheticTraceGenerator::Operand SyntheticTraceGenerator::address(
+    unsigned array, unsigned element) {
+  unsigned long array_bytes = params.array_elements * params.word_size;
+  unsigned long stride = (array_bytes + 0xfff) & ~0xfffUL;
+  unsigned long addr =
+      kAccArrayBase + array * stride + element * params.word_size;
+  return { 64, toHex(addr), "" };
+}
+
+SyntheticTraceGenerator::Operand SyntheticTraceGenerator::hostAddress(
+    unsigned array) {
+  unsigned long array_bytes = params.array_elements * params.word_size;
+  unsigned long stride = (array_bytes + 0xfff) & ~0xfffUL;
+  return { 64, toHex(kHostArrayBase + array * stride), "" };
+}
+
+void SyntheticTraceGenerator::writeNode(int line,
+                                        const std::string& bblock,
+                                        const std::string& inst,
+                                        unsigned microop) {
+  if (buffer.size() > kBufferSize)
+    flush();
+  buffer += "\n0," + std::to_string(line) + "," + params.function + "," +
+            bblock + "," + inst + "," + std::to_string(microop) + "," +
+            std::to_string(num_nodes) + "\n";
+  num_nodes++;
+}
+
+void SyntheticTraceGenerator::writeOperand(unsigned tag, const Operand& op) {
+  buffer += std::to_string(tag) + "," + std::to_string(op.size) + "," +
+            op.value + (op.reg.empty() ? ",0, ,\n" : ",1," + op.reg + ",\n");
+}
+
+void SyntheticTraceGenerator::writePhiOperand(unsigned tag,
+                                              const Operand& op,
+                                              const std::string& prev_bblock) {
+  buffer += std::to_string(tag) + "," + std::to_string(op.size) + "," +
+            op.value + (op.reg.empty() ? ",0, ," : ",1," + op.reg + ",") +
+            prev_bblock + ",\n";
+}
+
+void SyntheticTraceGenerator::writeForward(const Operand& op) {
+  buffer += "f," + std::to_string(op.size) + "," + op.value + ",1," + op.reg +
+            ",\n";
+}
+
+void SyntheticTraceGenerator::writeResult(const Operand& op) {
+  buffer += "r," + std::to_string(op.size) + "," + op.value + ",1," + op.reg +
+            ",\n";
+}
+
+void SyntheticTraceGenerator::flush() {
+  if (buffer.empty())
+    return;
+  if (gzwrite(file, buffer.data(), buffer.size()) != (int)buffer.size()) {
+    std::cerr << "[ERROR]: Failed to write the synthetic trace." << std::endl;
+    exit(1);
+  }
+  buffer.clear();
+}
+
+long SyntheticTraceGenerator::writeTrace(const std::string& file_name) {
+  bool compress = file_name.size() > 3 &&
+                  file_name.compare(file_name.size() - 3, 3, ".gz") == 0;
+  // "T" writes the file without compression.
+  file = gzopen(file_name.c_str(), compress ? "wb" : "wT");
+  if (!file) {
+    std::cerr << "[ERROR]: Unable to open " << file_name << std::endl;
+    exit(1);
+  }
+  rng.seed(params.seed);
+  num_nodes = 0;
+  last_stored_element = -1;
+  induction.assign(params.trip_counts.size(), 0);
+  buffer.clear();
+
+  buffer += "%%%% LABEL MAP START %%%%\n";
+  for (unsigned level = 0; level < params.trip_counts.size(); level++) {
+    buffer += params.function + "/" + getLoopName(level) + " " +
+              std::to_string(getLoopLine(level)) + "\n";
+  }
+  buffer += "%%%% LABEL MAP END %%%%\n\n";
+
+  writeEntry();
+  std::string entry_block = getBlockName("entry", 0);
+  if (params.dma)
+    writeDmaLoads();
+  writeNode(getLoopLine(0), entry_block, "br", LLVM_IR_Br);
+  writeOperand(1, reg(0, "0", getBlockName("loop0", 1)));
+  writeLoop(0, entry_block);
+  if (params.dma)
+    writeDmaStore();
+  writeNode(200, getBlockName("exit", 0), "ret", LLVM_IR_Ret);
+
+  flush();
+  gzclose(file);
+  file = nullptr;
+  return num_nodes;
+}
+
+void SyntheticTraceGenerator::writeEntry() {
+  unsigned num_arrays = params.num_inputs + 1;
+  unsigned num_args = params.dma ? num_arrays * 2 : num_arrays;
+  buffer += "\nentry," + params.function + "," + std::to_string(num_args) +
+            ",\n";
+  for (unsigned i = 0; i < num_arrays; i++) {
+    Operand op = address(i, 0);
+    op.reg = getArrayName(i);
+    writeOperand(i + 1, op);
+  }
+  if (params.dma) {
+    for (unsigned i = 0; i < num_arrays; i++) {
+      Operand op = hostAddress(i);
+      op.reg = getArrayName(i) + "_host";
+      writeOperand(num_arrays + i + 1, op);
+    }
+  }
+}
+
+void SyntheticTraceGenerator::writeDmaLoads() {
+  std::string block = getBlockName("entry", 0);
+  Operand bytes = constant(64, params.array_elements * params.word_size);
+  for (unsigned i = 0; i < params.num_inputs; i++) {
+    Operand acc = address(i, 0);
+    acc.reg = getArrayName(i);
+    Operand host = hostAddress(i);
+    host.reg = getArrayName(i) + "_host";
+    if (params.ready_bits) {
+      std::string name = "ready" + std::to_string(i);
+      writeNode(1, block, name, LLVM_IR_SetReadyBits);
+      writeOperand(4, reg(64, toHex(kSetReadyBitsFunc), "setReadyBits"));
+      writeOperand(1, acc);
+      writeOperand(2, bytes);
+      writeOperand(3, constant(32, 0));
+      writeResult(reg(32, "0", name));
+    }
+    std::string name = "call" + std::to_string(i);
+    writeNode(2, block, name, LLVM_IR_DMALoad);
+    writeOperand(4, reg(64, toHex(kDmaLoadFunc), "dmaLoad"));
+    writeOperand(1, acc);
+    writeOperand(2, host);
+    writeOperand(3, bytes);
+    writeForward(reg(64, acc.value, "dst_addr"));
+    writeForward(reg(64, host.value, "src_host_addr"));
+    writeForward(reg(64, bytes.value, "size"));
+    writeResult(reg(32, "3", name));
+  }
+  // Without ready bits, nothing may start before all the data has arrived.
+  if (!params.ready_bits) {
+    writeNode(3, block, "fence", LLVM_IR_DMAFence);
+    writeOperand(1, reg(64, toHex(kDmaFenceFunc), "dmaFence"));
+  }
+}
+
+void SyntheticTraceGenerator::writeDmaStore() {
+  std::string block = getBlockName("exit", 0);
+  unsigned out = params.num_inputs;
+  Operand acc = address(out, 0);
+  acc.reg = getArrayName(out);
+  Operand host = hostAddress(out);
+  host.reg = getArrayName(out) + "_host";
+  Operand bytes = constant(64, params.array_elements * params.word_size);
+  writeNode(199, block, "callout", LLVM_IR_DMAStore);
+  writeOperand(4, reg(64, toHex(kDmaStoreFunc), "dmaStore"));
+  writeOperand(1, host);
+  writeOperand(2, acc);
+  writeOperand(3, bytes);
+  writeForward(reg(64, host.value, "dst_host_addr"));
+  writeForward(reg(64, acc.value, "src_addr"));
+  writeForward(reg(64, bytes.value, "size"));
+  writeResult(reg(32, "3", "callout"));
+}
+
+void SyntheticTraceGenerator::writeLoop(unsigned level,
+                                        const std::string& preheader) {
+  unsigned depth = params.trip_counts.size();
+  bool innermost = level == depth - 1;
+  int line = getLoopLine(level);
+  std::string lvl = std::to_string(level);
+  std::string header = getBlockName("loop" + lvl, level + 1);
+  std::string latch =
+      innermost ? header : getBlockName("latch" + lvl, level + 1);
+  std::string exit =
+      level == 0 ? getBlockName("exit", 0)
+                 : getBlockName("latch" + std::to_string(level - 1), level);
+  std::string iv = "iv" + lvl;
+  std::string iv_next = "iv.next" + lvl;
+  std::string exitcond = "exitcond" + lvl;
+  unsigned trip_count = params.trip_counts[level];
+
+  for (unsigned i = 0; i < trip_count; i++) {
+    induction[level] = i;
+    std::string value = std::to_string(i);
+    writeNode(-1, header, iv, LLVM_IR_PHI);
+    writePhiOperand(2, reg(64, value, iv_next), latch);
+    writePhiOperand(1, constant(64, 0), preheader);
+    writeResult(reg(64, value, iv));
+
+    // Flatten the index of this iteration: flat = flat * trip_count + iv.
+    if (level > 0) {
+      unsigned long outer = 0;
+      for (unsigned l = 0; l < level; l++)
+        outer = outer * params.trip_counts[l] + induction[l];
+      std::string prev =
+          level == 1 ? "iv0" : "flat" + std::to_string(level - 1);
+      std::string mul = "mul" + lvl;
+      std::string mul_value = std::to_string(outer * trip_count);
+      writeNode(100 + level, header, mul, LLVM_IR_Mul);
+      writeOperand(2, constant(64, trip_count));
+      writeOperand(1, reg(64, std::to_string(outer), prev));
+      writeResult(reg(64, mul_value, mul));
+      writeNode(100 + level, header, "flat" + lvl, LLVM_IR_Add);
+      writeOperand(2, reg(64, value, iv));
+      writeOperand(1, reg(64, mul_value, mul));
+      writeResult(
+          reg(64, std::to_string(outer * trip_count + i), "flat" + lvl));
+    }
+
+    if (innermost) {
+      writeBody();
+    } else {
+      writeNode(getLoopLine(level + 1), header, "br" + lvl, LLVM_IR_Br);
+      std::string inner = "loop" + std::to_string(level + 1);
+      writeOperand(1, reg(0, "0", getBlockName(inner, level + 2)));
+      writeLoop(level + 1, header);
+    }
+
+    bool last = i + 1 == trip_count;
+    std::string next_value = std::to_string(i + 1);
+    writeNode(line, latch, iv_next, LLVM_IR_Add);
+    writeOperand(2, constant(64, 1));
+    writeOperand(1, reg(64, value, iv));
+    writeResult(reg(64, next_value, iv_next));
+    writeNode(line, latch, exitcond, LLVM_IR_ICmp);
+    writeOperand(2, constant(64, trip_count));
+    writeOperand(1, reg(64, next_value, iv_next));
+    writeResult(reg(1, last ? "1" : "0", exitcond));
+    writeNode(line, latch, "br.latch" + lvl, LLVM_IR_Br);
+    writeOperand(3, reg(0, "0", exit));
+    writeOperand(2, reg(0, "0", header));
+    writeOperand(1, reg(1, last ? "1" : "0", exitcond));
+  }
+}
+
+void SyntheticTraceGenerator::writeBody() {
+  unsigned depth = params.trip_counts.size();
+  std::string block = getBlockName("loop" + std::to_string(depth - 1), depth);
+  int line = 100 + depth;
+  unsigned word_bits = params.word_size * 8;
+  std::uniform_real_distribution<float> coin(0, 1);
+
+  unsigned long flat = 0;
+  for (unsigned l = 0; l < depth; l++)
+    flat = flat * params.trip_counts[l] + induction[l];
+  std::string flat_reg = depth > 1 ? "flat" + std::to_string(depth - 1) : "iv0";
+
+  // Wrap the index around the footprint of the arrays. A power of two
+  // footprint only needs a mask.
+  unsigned elements = params.array_elements;
+  bool pow2 = (elements & (elements - 1)) == 0;
+  unsigned element = flat % elements;
+  writeNode(line, block, "idx", pow2 ? LLVM_IR_And : LLVM_IR_URem);
+  writeOperand(2, constant(64, pow2 ? elements - 1 : elements));
+  writeOperand(1, reg(64, std::to_string(flat), flat_reg));
+  writeResult(reg(64, std::to_string(element), "idx"));
+
+  // Load one element of every input.
+  std::vector<Operand> values;
+  for (unsigned i = 0; i < params.num_inputs; i++) {
+    std::string arrayidx = "arrayidx" + std::to_string(i);
+    Operand base = address(i, 0);
+    base.reg = getArrayName(i);
+    Operand addr = address(i, element);
+    addr.reg = arrayidx;
+    writeNode(line, block, arrayidx, LLVM_IR_GetElementPtr);
+    writeOperand(2, reg(64, std::to_string(element), "idx"));
+    writeOperand(1, base);
+    writeResult(addr);
+    Operand value = reg(word_bits, std::to_string(i * 1000 + element),
+                        "v" + std::to_string(i));
+    writeNode(line, block, value.reg, LLVM_IR_Load);
+    writeOperand(1, addr);
+    writeResult(value);
+    values.push_back(value);
+  }
+
+  // Chain the arithmetic operations through the loaded values.
+  Operand acc = values[0];
+  for (unsigned j = 0; j < params.ops_per_iteration; j++) {
+    const Operand& rhs = values[(j + 1) % values.size()];
+    bool fp = coin(rng) < params.fp_fraction;
+    bool mul = j % 2 == 1;
+    unsigned microop = fp ? (mul ? LLVM_IR_FMul : LLVM_IR_FAdd)
+                          : (mul ? LLVM_IR_Mul : LLVM_IR_Add);
+    Operand result = reg(word_bits, fp ? std::to_string(j) + ".5"
+                                       : std::to_string(j),
+                         "t" + std::to_string(j));
+    writeNode(line, block, result.reg, microop);
+    writeOperand(2, rhs);
+    writeOperand(1, acc);
+    writeResult(result);
+    acc = result;
+  }
+
+  // Read back the element written by the previous iteration.
+  unsigned out = params.num_inputs;
+  if (last_stored_element >= 0 && coin(rng) < params.mem_dep_density) {
+    unsigned prev_element = last_stored_element;
+    Operand base = address(out, 0);
+    base.reg = getArrayName(out);
+    Operand addr = address(out, prev_element);
+    addr.reg = "arrayidx.prev";
+    writeNode(line, block, "prev", LLVM_IR_Add);
+    writeOperand(2, constant(64, -1));
+    writeOperand(1, reg(64, std::to_string(element), "idx"));
+    writeResult(reg(64, std::to_string(prev_element), "prev"));
+    writeNode(line, block, addr.reg, LLVM_IR_GetElementPtr);
+    writeOperand(2, reg(64, std::to_string(prev_element), "prev"));
+    writeOperand(1, base);
+    writeResult(addr);
+    Operand value = reg(word_bits, "1", "v.prev");
+    writeNode(line, block, value.reg, LLVM_IR_Load);
+    writeOperand(1, addr);
+    writeResult(value);
+    Operand result = reg(word_bits, "2", "t.prev");
+    writeNode(line, block, result.reg, LLVM_IR_Add);
+    writeOperand(2, value);
+    writeOperand(1, acc);
+    writeResult(result);
+    acc = result;
+  }
+
+  Operand base = address(out, 0);
+  base.reg = getArrayName(out);
+  Operand addr = address(out, element);
+  addr.reg = "arrayidx.out";
+  writeNode(line, block, addr.reg, LLVM_IR_GetElementPtr);
+  writeOperand(2, reg(64, std::to_string(element), "idx"));
+  writeOperand(1, base);
+  writeResult(addr);
+  writeNode(line, block, "store", LLVM_IR_Store);
+  writeOperand(2, addr);
+  writeOperand(1, acc);
+  last_stored_element = element;
+}
+
+void SyntheticTraceGenerator::writeConfig(const std::string& file_name) {
+  std::ofstream config(file_name);
+  if (!config.is_open()) {
+    std::cerr << "[ERROR]: Unable to open " << file_name << std::endl;
+    exit(1);
+  }
+  config << "cycle_time," << params.cycle_time << std::endl;
+  config << "pipelining," << params.pipelining << std::endl;
+  for (unsigned i = 0; i <= params.num_inputs; i++) {
+    config << "partition,cyclic," << getArrayName(i) << ","
+           << params.array_elements * params.word_size << ","
+           << params.word_size << "," << params.partition_factor << std::endl;
+  }
+  for (unsigned level = 0; level < params.trip_counts.size(); level++) {
+    // Only the innermost loop is unrolled by the requested factor; the outer
+    // loops are kept rolled.
+    unsigned factor =
+        level + 1 == params.trip_counts.size() ? params.unroll_factor : 1;
+    config << "unrolling," << params.function << "," << getLoopName(level)
+           << "," << factor << std::endl;
+  }
+}
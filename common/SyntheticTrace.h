@@ -0,0 +1,149 @@
+#ifndef __SYNTHETIC_TRACE_H__
+#define __SYNTHETIC_TRACE_H__
+
+/* A generator of synthetic dynamic traces.
+ *
+ * The generated trace has the same format as the traces produced by
+ * LLVM-Tracer, so it can be simulated like any other trace, but no compiler
+ * toolchain is needed to produce it. This makes it possible to test how
+ * Aladdin scales to traces of any size.
+ *
+ * The trace is a single function with a perfect loop nest:
+ *
+ *   for (i0 = 0; i0 < trip_counts[0]; i0++)
+ *     for (i1 = 0; i1 < trip_counts[1]; i1++)
+ *       ...
+ *         idx = flatten(i0, i1, ...) % array_elements;
+ *         t = in0[idx] op in1[idx] op ... (ops_per_iteration ops)
+ *         out[idx] = t;
+ *
+ * Every operation is an integer or floating point add or multiply, chosen at
+ * random with probability fp_fraction of being floating point. With
+ * probability mem_dep_density, an iteration also loads the element of out that
+ * was stored by the previous iteration, creating a memory dependence between
+ * consecutive iterations.
+ *
+ * With DMA enabled, the inputs are first copied in from host arrays with
+ * dmaLoad (preceded by setReadyBits if ready bits are enabled) and the output
+ * is copied back with dmaStore after the loop nest.
+ *
+ * A configuration file matching the trace can be written as well. It
+ * partitions every accelerator array cyclically and unrolls the innermost
+ * loop.
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+struct SyntheticTraceParams {
+  SyntheticTraceParams()
+      : function("synthetic"), trip_counts({ 128 }), num_inputs(2),
+        array_elements(128), word_size(4), ops_per_iteration(2),
+        fp_fraction(0), mem_dep_density(0), dma(false), ready_bits(false),
+        partition_factor(2), unroll_factor(2), pipelining(false),
+        cycle_time(1), seed(0) {}
+
+  // Name of the traced function.
+  std::string function;
+  // Trip count of each loop of the nest, outermost first.
+  std::vector<unsigned> trip_counts;
+  // Number of arrays read in every iteration.
+  unsigned num_inputs;
+  // Number of elements in every array.
+  unsigned array_elements;
+  // Size of an element in bytes.
+  unsigned word_size;
+  // Number of arithmetic operations in every iteration.
+  unsigned ops_per_iteration;
+  // Fraction of the arithmetic operations that are floating point.
+  float fp_fraction;
+  // Fraction of the iterations that depend on the store of the previous
+  // iteration.
+  float mem_dep_density;
+  // Copy the arrays in and out with DMA.
+  bool dma;
+  // Reset the ready bits of the input arrays before loading them. Only
+  // gem5-Aladdin sets ready bits as DMA data arrives, so the configuration
+  // never enables ready mode; standalone Aladdin would wait forever.
+  bool ready_bits;
+
+  // Only used for the configuration file.
+  unsigned partition_factor;
+  unsigned unroll_factor;
+  bool pipelining;
+  float cycle_time;
+
+  unsigned seed;
+};
+
+class SyntheticTraceGenerator {
+ public:
+  SyntheticTraceGenerator(const SyntheticTraceParams& _params);
+
+  // Write the trace to @file_name. The trace is gzipped if the name ends with
+  // ".gz". Returns the number of nodes in the trace.
+  long writeTrace(const std::string& file_name);
+
+  // Write a configuration file for the trace to @file_name.
+  void writeConfig(const std::string& file_name);
+
+  // Name of the accelerator array @index, where the inputs come first and the
+  // output is last.
+  std::string getArrayName(unsigned index) const;
+  // Name of the loop at @level of the nest, outermost first.
+  std::string getLoopName(unsigned level) const;
+
+ protected:
+  // A register or constant operand.
+  struct Operand {
+    unsigned size;
+    std::string value;
+    // Empty for constants.
+    std::string reg;
+  };
+
+  // Start a new node.
+  void writeNode(int line,
+                 const std::string& bblock,
+                 const std::string& inst,
+                 unsigned microop);
+  // Write the operand @tag of the current node.
+  void writeOperand(unsigned tag, const Operand& op);
+  void writePhiOperand(unsigned tag, const Operand& op,
+                       const std::string& prev_bblock);
+  void writeForward(const Operand& op);
+  void writeResult(const Operand& op);
+
+  void writeEntry();
+  void writeDmaLoads();
+  void writeDmaStore();
+  void writeLoop(unsigned level, const std::string& preheader);
+  void writeBody();
+
+  Operand reg(unsigned size, const std::string& value, const std::string& name);
+  Operand constant(unsigned size, long value);
+  Operand address(unsigned array, unsigned element);
+  Operand hostAddress(unsigned array);
+
+  // Flush the write buffer to the file.
+  void flush();
+
+  std::string getBlockName(const std::string& name, unsigned depth) const;
+  int getLoopLine(unsigned level) const { return 10 + level; }
+
+  SyntheticTraceParams params;
+  std::mt19937 rng;
+  gzFile file;
+  std::string buffer;
+  long num_nodes;
+
+  // Current value of the induction variable of each loop.
+  std::vector<unsigned> induction;
+  // Element of the output array stored by the last iteration, or -1.
+  long last_stored_element;
+};
+
+#endif
@@ -2,7 +2,10 @@
 #include "ScratchpadDatapath.h"
 #include "Scratchpad.h"
 #include "DDDG.h"
+#include "DesignSpaceExplorer.h"
+#include "InvocationPipeline.h"
 #include <stdio.h>
+#include <vector>
 
 int main(int argc, const char* argv[]) {
   const char* logo =
@@ -20,27 +23,102 @@ int main(int argc, const char* argv[]) {
 
   std::cout << logo << std::endl;
 
-  if (argc < 4) {
+  // Pull the optional flags out before reading the positional arguments.
+  bool estimate_only = false;
+  bool profile = false;
+  bool pipeline = false;
+  bool resume = false;
+  std::string sweep_file;
+  std::string snapshot_file;
+  std::string checkpoint_file;
+  unsigned checkpoint_interval = 100000;
+  std::vector<const char*> args;
+  for (int i = 0; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "--estimate")
+      estimate_only = true;
+    else if (arg == "--profile")
+      profile = true;
+    else if (arg == "--pipeline")
+      pipeline = true;
+    else if (arg.compare(0, 10, "--explore=") == 0)
+      sweep_file = arg.substr(10);
+    else if (arg.compare(0, 11, "--snapshot=") == 0)
+      snapshot_file = arg.substr(11);
+    else if (arg.compare(0, 13, "--checkpoint=") == 0)
+      checkpoint_file = arg.substr(13);
+    else if (arg.compare(0, 22, "--checkpoint-interval=") == 0)
+      checkpoint_interval = std::stoul(arg.substr(22));
+    else if (arg == "--resume")
+      resume = true;
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (args.size() < 4) {
     std::cout << "-------------------------------" << std::endl;
     std::cout << "Aladdin takes:                 " << std::endl;
     std::cout
         << "./aladdin <bench> <dynamic trace> <config file> <experiment_name>"
-        << std::endl;
+        << " [--estimate] [--explore=<sweep file>] [--profile] [--pipeline]"
+        << " [--snapshot=<snapshot file>]"
+        << " [--checkpoint=<checkpoint file>] [--checkpoint-interval=<cycles>]"
+        << " [--resume]" << std::endl;
     std::cout << "   experiment_name is an optional parameter, only used to \n"
               << "   identify results stored in a local database." << std::endl;
+    std::cout << "   --estimate skips cycle-level scheduling and reports an \n"
+              << "   analytical estimate of cycles and power instead."
+              << std::endl;
+    std::cout << "   --explore searches the configurations listed in the \n"
+              << "   sweep file for the Pareto frontier of cycles and power."
+              << std::endl;
+    std::cout << "   --profile writes the time, memory usage and throughput \n"
+              << "   of each phase of the simulation to <bench>_profile.json."
+              << std::endl;
+    std::cout << "   --pipeline builds the next accelerator invocation while \n"
+              << "   the current one is scheduled, on a second thread."
+              << std::endl;
+    std::cout << "   --snapshot writes the scheduled datapath to the snapshot \n"
+              << "   file, which the debugger can open without rerunning the \n"
+              << "   simulation." << std::endl;
+    std::cout << "   --checkpoint writes the state of the simulation to the \n"
+              << "   checkpoint file every --checkpoint-interval cycles \n"
+              << "   (100000 by default). --resume continues from the last \n"
+              << "   checkpoint in the file with the same results, or starts \n"
+              << "   from the beginning if there is none yet." << std::endl;
     std::cout << "   Aladdin supports gzipped dynamic trace files - append \n"
               << "   the \".gz\" extension to the end of the trace file."
               << std::endl;
     std::cout << "-------------------------------" << std::endl;
     exit(0);
   }
+  if (!sweep_file.empty() && (estimate_only || pipeline)) {
+    std::cerr << "[ERROR]: --explore cannot be combined with --estimate or "
+                 "--pipeline.\n";
+    exit(1);
+  }
+  if (resume && checkpoint_file.empty()) {
+    std::cerr << "[ERROR]: --resume needs a --checkpoint file.\n";
+    exit(1);
+  }
+  if (!checkpoint_file.empty() &&
+      (estimate_only || pipeline || !sweep_file.empty())) {
+    std::cerr << "[ERROR]: --checkpoint cannot be combined with --estimate, "
+                 "--explore or --pipeline.\n";
+    exit(1);
+  }
+  if (!checkpoint_file.empty() && checkpoint_interval == 0) {
+    std::cerr << "[ERROR]: The checkpoint interval must be positive.\n";
+    exit(1);
+  }
+
   std::cout << "-------------------------------" << std::endl;
   std::cout << "      Starts Aladdin           " << std::endl;
   std::cout << "-------------------------------" << std::endl;
 
-  std::string bench(argv[1]);
-  std::string trace_file(argv[2]);
-  std::string config_file(argv[3]);
+  std::string bench(args[1]);
+  std::string trace_file(args[2]);
+  std::string config_file(args[3]);
   std::string experiment_name;
 
   std::cout << bench << "," << trace_file << "," << config_file << ","
@@ -49,34 +127,70 @@ int main(int argc, const char* argv[]) {
   ScratchpadDatapath* acc;
 
   acc = new ScratchpadDatapath(bench, trace_file, config_file);
+  acc->getProfiler().setEnabled(profile);
+  acc->setSnapshotFile(snapshot_file);
+  if (!checkpoint_file.empty())
+    acc->setCheckpointFile(checkpoint_file, checkpoint_interval);
+  if (resume)
+    acc->resumeFromCheckpoint();
 
 #ifdef USE_DB
-  bool use_db = (argc == 5);
+  bool use_db = (args.size() == 5);
   if (use_db) {
-    experiment_name = std::string(argv[4]);
+    experiment_name = std::string(args[4]);
     acc->setExperimentParameters(experiment_name);
   }
 #endif
 
+  if (!sweep_file.empty()) {
+    DesignSpaceExplorer explorer(acc, sweep_file);
+    explorer.explore();
+    if (profile)
+      acc->getProfiler().writeJson(bench + "_profile.json");
+    delete acc;
+    return 0;
+  }
+
+  if (pipeline) {
+    InvocationPipeline invocations(acc, bench, trace_file, config_file);
+    invocations.run(estimate_only);
+    if (profile)
+      acc->getProfiler().writeJson(bench + "_profile.json");
+    delete acc;
+    return 0;
+  }
+
   // Build the graph.
   bool dddg_built = acc->buildDddg();
 
   // Repeat for each invocation of the accelerator.
   while (dddg_built) {
     acc->globalOptimizationPass();
+    if (acc->isReplayingInvocation()) {
+      // Finished before the checkpoint that is being resumed.
+      acc->clearDatapath();
+      dddg_built = acc->buildDddg();
+      continue;
+    }
     /* Profiling */
     acc->prepareForScheduling();
 
-    // Scheduling
-    while (!acc->step()) {
-    }
+    if (estimate_only) {
+      acc->estimateStats();
+    } else {
+      // Scheduling
+      while (!acc->step()) {
+      }
 
-    acc->dumpStats();
+      acc->dumpStats();
+    }
     acc->clearDatapath();
 
     dddg_built = acc->buildDddg();
   };
 
+  if (profile)
+    acc->getProfiler().writeJson(bench + "_profile.json");
   delete acc;
   return 0;
 }
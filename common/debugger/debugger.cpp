@@ -10,6 +10,11 @@
 // This is a drop in replacement for Aladdin, so run it just like standalone
 // Aladdin but with the different executable name.
 //
+// To inspect a datapath after the fact, run Aladdin with --snapshot=<file> and
+// then open the snapshot with --snapshot=<file> here instead of a trace. The
+// debugger then starts right after scheduling, without parsing the trace or
+// simulating the datapath again.
+//
 // For best results, install libreadline (any recent version will do) to enable
 // features like accessing command history (C-r to search, up/down arrows to go
 // back and forth).
@@ -18,6 +23,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "../ScratchpadDatapath.h"
 
@@ -41,25 +47,48 @@ int main(int argc, const char* argv[]) {
 
   std::cout << logo << std::endl;
 
-  if (argc < 4) {
+  std::string snapshot_file;
+  std::vector<const char*> args;
+  for (int i = 0; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 11, "--snapshot=") == 0)
+      snapshot_file = arg.substr(11);
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (args.size() < (snapshot_file.empty() ? 4 : 3)) {
     std::cout << "-------------------------------" << std::endl;
     std::cout << "Aladdin Debugger Usage:    " << std::endl;
     std::cout
         << "./debugger <bench> <dynamic trace> <config file>"
         << std::endl;
+    std::cout
+        << "./debugger --snapshot=<snapshot file> <bench> <config file>"
+        << std::endl;
     std::cout << "   Aladdin supports gzipped dynamic trace files - append \n"
               << "   the \".gz\" extension to the end of the trace file."
               << std::endl;
+    std::cout << "   --snapshot opens a snapshot written by \n"
+              << "   ./aladdin --snapshot=<snapshot file> after scheduling."
+              << std::endl;
     std::cout << "-------------------------------" << std::endl;
     exit(0);
   }
 
-  std::string bench(argv[1]);
-  std::string trace_file(argv[2]);
-  std::string config_file(argv[3]);
+  std::string bench(args[1]);
+  std::string trace_file;
+  std::string config_file;
+  if (snapshot_file.empty()) {
+    trace_file = args[2];
+    config_file = args[3];
+  } else {
+    config_file = args[2];
+  }
 
-  std::cout << bench << "," << trace_file << "," << config_file << ","
-            << std::endl;
+  std::cout << bench << ","
+            << (snapshot_file.empty() ? trace_file : snapshot_file) << ","
+            << config_file << "," << std::endl;
 
   ScratchpadDatapath* acc;
 
@@ -67,6 +96,14 @@ int main(int argc, const char* argv[]) {
 
   acc = new ScratchpadDatapath(bench, trace_file, config_file);
 
+  if (!snapshot_file.empty()) {
+    acc->loadSnapshot(snapshot_file);
+    execution_status = POSTSCHEDULING;
+    interactive_mode(acc);
+    delete acc;
+    return 0;
+  }
+
   // Build the graph.
   acc->buildDddg();
 
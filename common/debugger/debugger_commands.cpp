@@ -1,53 +1,44 @@
 // Implementation of all debugging command handlers.
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <unordered_map>
 #include <string>
 #include <vector>
 
-#include <boost/graph/breadth_first_search.hpp>
 #include <boost/tokenizer.hpp>
 
+#include "../GraphExporter.h"
 #include "../typedefs.h"
 #include "debugger_commands.h"
-#include "debugger_graph.h"
+#include "debugger_index.h"
 #include "debugger_print.h"
 #include "debugger_prompt.h"
 
 using namespace adb;
 
-void dump_graph(Graph& graph, ScratchpadDatapath* acc, std::string graph_name) {
-  std::unordered_map<Vertex, const ExecNode*> vertexToNode;
-  BGL_FORALL_VERTICES(v, graph, Graph) {
-    const ExecNode* node =
-        acc->getProgram().nodes.at(get(boost::vertex_node_id, graph, v));
-    vertexToNode[v] = node;
+// Remove the arguments named in @names from @tokens and store their values in
+// @values. Unlike parse_command_args(), the values may be any string.
+static int extract_string_args(CommandTokens& tokens,
+                               const std::vector<std::string>& names,
+                               std::map<std::string, std::string>& values) {
+  for (auto it = tokens.begin(); it != tokens.end();) {
+    size_t eq = it->find('=');
+    std::string arg_name = it->substr(0, eq);
+    if (std::find(names.begin(), names.end(), arg_name) == names.end()) {
+      ++it;
+      continue;
+    }
+    if (eq == std::string::npos || eq + 1 == it->size()) {
+      std::cerr << "ERROR: Missing value to parameter " << arg_name << ".\n";
+      return -1;
+    }
+    values[arg_name] = it->substr(eq + 1);
+    it = tokens.erase(it);
   }
-  std::ofstream out(graph_name + "_graph.dot", std::ofstream::out);
-  write_graphviz(out, graph, make_microop_label_writer(vertexToNode, graph));
-}
-
-void reconstruct_graph(Graph* new_graph,
-                       ScratchpadDatapath* acc,
-                       unsigned root_node_id,
-                       unsigned num_nodes,
-                       int max_node_id,
-                       bool show_branch_children) {
-  const Graph &g = acc->getProgram().graph;
-  const ExecNode* root_node = acc->getProgram().nodes.at(root_node_id);
-  Vertex root_vertex = root_node->get_vertex();
-  unsigned num_nodes_visited = 0;
-  std::map<unsigned, Vertex> existing_nodes;
-  NodeVisitor visitor(new_graph,
-                      &existing_nodes,
-                      acc,
-                      root_vertex,
-                      num_nodes,
-                      max_node_id,
-                      show_branch_children,
-                      &num_nodes_visited);
-  boost::breadth_first_search(g, root_vertex, boost::visitor(visitor));
+  return 0;
 }
 
 HandlerRet adb::cmd_print_cycle(const CommandTokens& command_tokens,
@@ -189,7 +180,9 @@ HandlerRet adb::cmd_print(const CommandTokens& command_tokens,
   return ret;
 }
 
-// graph root=N [max_nodes=K] [show_branch_children=1/0]
+// graph [root=N [radius=R] [num_nodes=K] [max_node_id=M]
+//        [show_branch_children=1/0]] [from=A] [to=B]
+//       [loop=L [iteration=I]] [function=F [invocation=I]] [format=dot/csv/bin]
 HandlerRet adb::cmd_graph(const CommandTokens& command_tokens,
                           Command* subcmd_list,
                           ScratchpadDatapath* acc) {
@@ -198,47 +191,112 @@ HandlerRet adb::cmd_graph(const CommandTokens& command_tokens,
     return HANDLER_ERROR;
   }
 
-  int root_node = -1;
   bool show_branch_children = true;  // Default
   int num_nodes = 300;  // Default.
   int max_node_id = -1;  // Default.
+  unsigned radius = std::numeric_limits<unsigned>::max();  // Default.
+  GraphExporter::Format format = GraphExporter::Graphviz;  // Default.
 
   CommandTokens args_tokens(++command_tokens.begin(), command_tokens.end());
+  std::map<std::string, std::string> string_args;
+  if (extract_string_args(
+          args_tokens, { "loop", "function", "format" }, string_args) != 0)
+    return HANDLER_ERROR;
   CommandArgs args;
   if (parse_command_args(args_tokens, args) != 0)
     return HANDLER_ERROR;
 
-  if (args.find("root") != args.end()) {
-    root_node = args["root"];
-  } else {
-    std::cerr << "ERROR: Must specify the root node!\n";
+  if (string_args.find("format") != string_args.end() &&
+      !GraphExporter::parseFormat(string_args["format"], format)) {
+    std::cerr << "ERROR: Unknown format " << string_args["format"]
+              << "! Must be one of dot, csv or bin.\n";
     return HANDLER_ERROR;
   }
-
   if (args.find("num_nodes") != args.end())
     num_nodes = args["num_nodes"];
   if (args.find("max_node_id") != args.end())
     max_node_id = args["max_node_id"];
   if (args.find("show_branch_children") != args.end())
     show_branch_children = args["show_branch_children"];
+  if (args.find("radius") != args.end())
+    radius = args["radius"];
 
-  if (!acc->getProgram().nodeExists(root_node)) {
-    std::cerr << "ERROR: Node " << root_node << " does not exist!\n";
-    return HANDLER_ERROR;
+  const Program& program = acc->getProgram();
+  GraphExporter exporter(program);
+  bool has_region = false;
+
+  if (args.find("root") != args.end()) {
+    int root_node = args["root"];
+    if (!program.nodeExists(root_node)) {
+      std::cerr << "ERROR: Node " << root_node << " does not exist!\n";
+      return HANDLER_ERROR;
+    }
+    exporter.selectNeighborhood(
+        root_node, radius, num_nodes, max_node_id, show_branch_children);
+    has_region = true;
   }
-  Graph subgraph;
-  try {
-    reconstruct_graph(&subgraph,
-                      acc,
-                      root_node,
-                      num_nodes,
-                      max_node_id,
-                      show_branch_children);
-  } catch (const bfs_finished &e) {
-    // Nothing to do.
+
+  if (args.find("from") != args.end() || args.find("to") != args.end()) {
+    unsigned from = args.find("from") != args.end() ? args["from"] : 0;
+    unsigned to = args.find("to") != args.end()
+                      ? args["to"]
+                      : std::numeric_limits<unsigned>::max();
+    exporter.selectNodes(from, to);
+    has_region = true;
   }
-  dump_graph(subgraph, acc, "debug");
-  std::cout << "Graph has been written to debug_graph.dot.\n";
+
+  SrcTypes::SourceManager& srcManager = acc->get_source_manager();
+  SrcTypes::Function* func = nullptr;
+  if (string_args.find("function") != string_args.end()) {
+    func = srcManager.get<SrcTypes::Function>(string_args["function"]);
+    if (!func) {
+      std::cerr << "ERROR: No such function " << string_args["function"]
+                << "!\n";
+      return HANDLER_ERROR;
+    }
+  }
+
+  DebugIndex& index = get_debug_index(acc);
+  if (string_args.find("loop") != string_args.end()) {
+    // Graph the loop in every function that has it, unless a function was
+    // also given.
+    int iteration =
+        args.find("iteration") != args.end() ? args["iteration"] : -1;
+    SrcTypes::Label* label =
+        srcManager.get<SrcTypes::Label>(string_args["loop"]);
+    bool found = false;
+    for (auto& unique_label : index.findLoopLabels(label)) {
+      if (func && unique_label.get_function() != func)
+        continue;
+      found |= exporter.selectLoop(unique_label, iteration);
+    }
+    if (!found) {
+      std::cerr << "ERROR: No executed iterations of loop "
+                << string_args["loop"] << " found!\n";
+      return HANDLER_ERROR;
+    }
+    has_region = true;
+  } else if (func) {
+    int invocation =
+        args.find("invocation") != args.end() ? args["invocation"] : -1;
+    if (!exporter.selectFunction(func, invocation)) {
+      std::cerr << "ERROR: No invocations of function "
+                << string_args["function"] << " found!\n";
+      return HANDLER_ERROR;
+    }
+    has_region = true;
+  }
+
+  if (!has_region) {
+    std::cerr << "ERROR: Must specify a root node, a node range, a loop or a "
+                 "function!\n";
+    return HANDLER_ERROR;
+  }
+
+  std::string file_name = "debug_graph" + GraphExporter::getExtension(format);
+  unsigned num_written = exporter.write(file_name, format);
+  std::cout << "Graph of " << num_written << " nodes has been written to "
+            << file_name << ".\n";
 
   return HANDLER_SUCCESS;
 }
@@ -274,15 +332,25 @@ HandlerRet adb::cmd_help(const CommandTokens& tokens,
             << "    Optional arguments:\n"
             << "      max_nodes=M                 : Print up to M nodes. Default: 300.\n"
             << "\n"
-            << "  graph root=[node-id]            : Dump the DDDG in BFS fashion, with node-id as the root.\n"
-            << "    Optional arguments:\n"
-            << "      num_nodes=M              : Graph up to M nodes. Default: 300.\n"
-            << "      max_node_id=N            : Don't show any nodes greater than this ID. Default: unlimited.\n"
-            << "      show_branch_children=1/0 : Include edges to the children of all branch and call nodes.\n"
+            << "  graph [region...]               : Dump a region of the DDDG. The region is the union of:\n"
+            << "      root=[node-id]              : The nodes reachable from node-id, in BFS fashion.\n"
+            << "        num_nodes=M               : Graph up to M nodes. Default: 300.\n"
+            << "        radius=R                  : Only go up to R edges away from the root. Default: unlimited.\n"
+            << "        max_node_id=N             : Don't show any nodes greater than this ID. Default: unlimited.\n"
+            << "        show_branch_children=1/0  : Include edges to the children of all branch and call nodes.\n"
             << "           By default, include (1). Set to 0 to exclude.\n"
             << "           Branch and call nodes tend to have a lot of child dependent nodes that may\n"
             << "           not be dependent on each other (e.g. different iterations of the same or\n"
             << "           different loop), so you can exclude them to keep the output cleaner.\n"
+            << "      from=A to=B                 : The nodes with ids from A to B.\n"
+            << "      loop=[label-name]           : The iterations of this loop. If function=F is also\n"
+            << "           given, only the loop in F.\n"
+            << "        iteration=I               : Only the I-th (unrolled) iteration, from 0.\n"
+            << "      function=[function-name]    : The invocations of this function.\n"
+            << "        invocation=I              : Only the I-th invocation, from 0.\n"
+            << "    Optional arguments:\n"
+            << "      format=dot/csv/bin          : Write Graphviz (default), a CSV edge list, or the\n"
+            << "           binary format of GraphExporter to debug_graph.dot, .csv or .bin.\n"
             << "\n"
             << "  continue                           : Continue executing Aladdin\n"
             << "  quit                               : Quit the debugger.\n";
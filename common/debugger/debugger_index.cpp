@@ -0,0 +1,195 @@
+#include <algorithm>
+
+#include "debugger_index.h"
+
+using namespace adb;
+using namespace SrcTypes;
+
+//---------------------
+// CycleIntervalTree
+//---------------------
+
+const int CycleIntervalTree::NONE;
+
+void CycleIntervalTree::build(const ExecNodeMap& nodes) {
+  clear();
+  std::vector<const ExecNode*> intervals;
+  for (auto& node_pair : nodes) {
+    if (node_pair.second->started())
+      intervals.push_back(node_pair.second);
+  }
+  root = build(intervals);
+}
+
+int CycleIntervalTree::build(std::vector<const ExecNode*>& intervals) {
+  if (intervals.empty())
+    return NONE;
+
+  auto by_start = [](const ExecNode* a, const ExecNode* b) {
+    return a->get_start_execution_cycle() < b->get_start_execution_cycle();
+  };
+  auto median = intervals.begin() + intervals.size() / 2;
+  std::nth_element(intervals.begin(), median, intervals.end(), by_start);
+  int center = (*median)->get_start_execution_cycle();
+
+  std::vector<const ExecNode*> left, right, here;
+  for (const ExecNode* node : intervals) {
+    if (node->get_complete_execution_cycle() < center)
+      left.push_back(node);
+    else if (node->get_start_execution_cycle() > center)
+      right.push_back(node);
+    else
+      here.push_back(node);
+  }
+  intervals.clear();
+  intervals.shrink_to_fit();
+
+  int index = tree.size();
+  tree.push_back(TreeNode());
+  TreeNode& tree_node = tree.back();
+  tree_node.center = center;
+  tree_node.by_start = here;
+  std::sort(tree_node.by_start.begin(), tree_node.by_start.end(), by_start);
+  tree_node.by_end.swap(here);
+  std::sort(tree_node.by_end.begin(),
+            tree_node.by_end.end(),
+            [](const ExecNode* a, const ExecNode* b) {
+              return a->get_complete_execution_cycle() >
+                     b->get_complete_execution_cycle();
+            });
+  // The tree grows while the subtrees are built, so don't hold on to
+  // tree_node past this point.
+  int left_index = build(left);
+  int right_index = build(right);
+  tree[index].left = left_index;
+  tree[index].right = right_index;
+  return index;
+}
+
+void CycleIntervalTree::clear() {
+  tree.clear();
+  root = NONE;
+}
+
+std::vector<const ExecNode*> CycleIntervalTree::findNodes(int cycle) const {
+  std::vector<const ExecNode*> found;
+  int index = root;
+  while (index != NONE) {
+    const TreeNode& tree_node = tree[index];
+    if (cycle < tree_node.center) {
+      for (const ExecNode* node : tree_node.by_start) {
+        if (node->get_start_execution_cycle() > cycle)
+          break;
+        found.push_back(node);
+      }
+      index = tree_node.left;
+    } else if (cycle > tree_node.center) {
+      for (const ExecNode* node : tree_node.by_end) {
+        if (node->get_complete_execution_cycle() < cycle)
+          break;
+        found.push_back(node);
+      }
+      index = tree_node.right;
+    } else {
+      found.insert(
+          found.end(), tree_node.by_start.begin(), tree_node.by_start.end());
+      break;
+    }
+  }
+  std::sort(found.begin(), found.end(),
+            [](const ExecNode* a, const ExecNode* b) {
+              return a->get_node_id() < b->get_node_id();
+            });
+  return found;
+}
+
+//---------------------
+// DebugIndex
+//---------------------
+
+void DebugIndex::attach(const Program* _program) {
+  if (program != _program)
+    clear();
+  program = _program;
+}
+
+void DebugIndex::clear() {
+  cycles_built = false;
+  cycles.clear();
+  functions_built = false;
+  function_boundaries.clear();
+  labels_built = false;
+  loop_labels.clear();
+  loop_boundaries.clear();
+}
+
+std::vector<const ExecNode*> DebugIndex::findNodesInCycle(int cycle) {
+  if (!cycles_built) {
+    cycles.build(program->nodes);
+    cycles_built = true;
+  }
+  return cycles.findNodes(cycle);
+}
+
+const std::vector<UniqueLabel>& DebugIndex::findLoopLabels(Label* label) {
+  if (!labels_built) {
+    for (auto& label_pair : program->labelmap) {
+      const UniqueLabel& unique_label = label_pair.second;
+      loop_labels[unique_label.get_label()].push_back(unique_label);
+    }
+    labels_built = true;
+  }
+  return loop_labels[label];
+}
+
+const std::list<cnode_pair_t>& DebugIndex::getLoopBoundaries(
+    const UniqueLabel& label) {
+  auto it = loop_boundaries.find(label);
+  if (it == loop_boundaries.end()) {
+    it = loop_boundaries
+             .insert(std::make_pair(label, program->findLoopBoundaries(label)))
+             .first;
+  }
+  return it->second;
+}
+
+const std::list<cnode_pair_t>& DebugIndex::getFunctionBoundaries(
+    Function* func) {
+  if (!functions_built) {
+    buildFunctionBoundaries();
+    functions_built = true;
+  }
+  return function_boundaries[func];
+}
+
+// Find the boundaries of every function in one pass, the same way that
+// Program::findFunctionBoundaries() does for one of them.
+void DebugIndex::buildFunctionBoundaries() {
+  const ExecNodeMap& nodes = program->nodes;
+  // The last call into each function that has not returned yet.
+  std::unordered_map<Function*, const ExecNode*> open_calls;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+    const ExecNode* node = it->second;
+    if (node->is_call_op()) {
+      auto next_it = std::next(it);
+      if (next_it != nodes.end())
+        open_calls[next_it->second->get_static_function()] = node;
+    } else if (node->is_ret_op()) {
+      Function* func = node->get_static_function();
+      const ExecNode*& call = open_calls[func];
+      // Without a call, this must have been the top level function.
+      const ExecNode* first = call ? call : nodes.begin()->second;
+      function_boundaries[func].push_back(std::make_pair(first, node));
+      call = nullptr;
+    }
+  }
+}
+
+static DebugIndex debug_index;
+
+DebugIndex& adb::get_debug_index(ScratchpadDatapath* acc) {
+  debug_index.attach(&acc->getProgram());
+  return debug_index;
+}
+
+void adb::clear_debug_index() { debug_index.clear(); }
@@ -0,0 +1,108 @@
+#ifndef _DEBUGGER_INDEX_H_
+#define _DEBUGGER_INDEX_H_
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "../ExecNode.h"
+#include "../Program.h"
+#include "../ScratchpadDatapath.h"
+#include "../SourceEntity.h"
+#include "../typedefs.h"
+
+namespace adb {
+
+// An interval tree over the execution cycles of the scheduled nodes.
+//
+// Every node of the tree holds the intervals that contain its center cycle,
+// and its subtrees hold the intervals that end before and start after the
+// center. The center is the median start cycle, so the tree is balanced and a
+// query visits O(log n) tree nodes plus the k intervals it returns.
+class CycleIntervalTree {
+ public:
+  CycleIntervalTree() : root(NONE) {}
+
+  // Index the nodes of @nodes that have been scheduled.
+  void build(const ExecNodeMap& nodes);
+  void clear();
+
+  // Return the nodes that execute in @cycle, i.e. start at or before it and
+  // complete at or after it, in node id order.
+  std::vector<const ExecNode*> findNodes(int cycle) const;
+
+ private:
+  static const int NONE = -1;
+
+  struct TreeNode {
+    int center;
+    // The intervals that contain center, by increasing start cycle and by
+    // decreasing complete cycle.
+    std::vector<const ExecNode*> by_start;
+    std::vector<const ExecNode*> by_end;
+    int left;
+    int right;
+  };
+
+  // Build the subtree of @intervals and return its index.
+  int build(std::vector<const ExecNode*>& intervals);
+
+  std::vector<TreeNode> tree;
+  int root;
+};
+
+// Secondary indexes of the program being debugged, so that the print
+// commands don't scan the whole program on every query.
+//
+// Each index is built on first use. The program must not change while the
+// index is in use; interactive_mode() clears the index every time it is
+// entered, as that is the only time the program changes.
+class DebugIndex {
+ public:
+  DebugIndex() : program(nullptr), cycles_built(false),
+                 functions_built(false), labels_built(false) {}
+
+  // Clear the index if it does not belong to @_program.
+  void attach(const Program* _program);
+  void clear();
+
+  // The nodes that execute in @cycle, in node id order.
+  std::vector<const ExecNode*> findNodesInCycle(int cycle);
+
+  // All labels named @label, in labelmap order.
+  const std::vector<SrcTypes::UniqueLabel>& findLoopLabels(
+      SrcTypes::Label* label);
+
+  // The same as Program::findLoopBoundaries() and findFunctionBoundaries().
+  const std::list<cnode_pair_t>& getLoopBoundaries(
+      const SrcTypes::UniqueLabel& label);
+  const std::list<cnode_pair_t>& getFunctionBoundaries(
+      SrcTypes::Function* func);
+
+ private:
+  void buildFunctionBoundaries();
+
+  const Program* program;
+
+  bool cycles_built;
+  CycleIntervalTree cycles;
+
+  bool functions_built;
+  std::unordered_map<SrcTypes::Function*, std::list<cnode_pair_t>>
+      function_boundaries;
+
+  bool labels_built;
+  std::unordered_map<SrcTypes::Label*, std::vector<SrcTypes::UniqueLabel>>
+      loop_labels;
+  // Boundaries of the loops queried so far.
+  std::unordered_map<SrcTypes::UniqueLabel, std::list<cnode_pair_t>>
+      loop_boundaries;
+};
+
+// The index of the program of @acc.
+DebugIndex& get_debug_index(ScratchpadDatapath* acc);
+void clear_debug_index();
+
+};  // namespace adb
+
+#endif
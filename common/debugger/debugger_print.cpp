@@ -134,8 +134,8 @@ void DebugNodePrinter::printMemoryOp() {
       char* hexstr = bytesToHexStr(vec_access->data(), vec_access->size, true);
       out << hexstr << "\n";
       delete[] hexstr;
-    } else {
-      auto scalar_access = dynamic_cast<ScalarMemAccess*>(mem_access);
+    } else if (auto scalar_access =
+                   dynamic_cast<ScalarMemAccess*>(mem_access)) {
       uint64_t bits;
       memcpy(&bits, scalar_access->data(), 8);
       if (scalar_access->is_float && scalar_access->size == 4)
@@ -145,6 +145,8 @@ void DebugNodePrinter::printMemoryOp() {
       else
         out << bits;
       out << "\n";
+    } else {
+      out << "(not kept in timing_only mode)\n";
     }
   }
 }
@@ -185,11 +187,7 @@ void DebugNodePrinter::printCall() {
   // For Call nodes, the next node will indicate what the called function is
   // (unless the called function is empty).
   if (node->is_call_op()) {
-    ExecNode* called_node = NULL;
-    try {
-      called_node = prog.nodes.at(node->get_node_id() + 1);
-    } catch (const std::out_of_range& e) {
-    }
+    ExecNode* called_node = prog.getNextNode(node->get_node_id());
 
     SrcTypes::Function* curr_func = node->get_static_function();
     out << "  Called function: ";
@@ -377,19 +375,8 @@ int DebugFunctionPrinter::computeFunctionLatency() {
 // DebugCyclePrinter
 //-------------------
 
-std::list<const ExecNode*> DebugCyclePrinter::findNodesExecutedinCycle() {
-  std::list<const ExecNode*> matched_nodes;
-
-  // In many cases, a simple linear traversal through all nodes ends up being
-  // faster than a breadth-first traversal of the graph.
-  for (auto it = prog.nodes.begin(); it != prog.nodes.end(); ++it) {
-    const ExecNode* curr_node = it->second;
-    if (curr_node->get_start_execution_cycle() >= cycle &&
-        curr_node->get_complete_execution_cycle() <= cycle) {
-      matched_nodes.push_back(curr_node);
-    }
-  }
-  return matched_nodes;
+std::vector<const ExecNode*> DebugCyclePrinter::findNodesExecutedinCycle() {
+  return index.findNodesInCycle(cycle);
 }
 
 void DebugCyclePrinter::printAll() {
@@ -401,7 +388,7 @@ void DebugCyclePrinter::printAll() {
     out << "ERROR: No nodes have executed yet.\n";
     return;
   }
-  std::list<const ExecNode*> nodes = findNodesExecutedinCycle();
+  std::vector<const ExecNode*> nodes = findNodesExecutedinCycle();
   out << "Cycle " << cycle << std::endl;
   out << "  Nodes executed at this cycle: ";
   const unsigned kMaxNodesPerRow = 15;
@@ -433,15 +420,7 @@ DebugLoopPrinter::LoopIdentifyStatus DebugLoopPrinter::identifyLoop(
   using namespace SrcTypes;
 
   SrcTypes::Label* label = srcManager.get<SrcTypes::Label>(loop_name);
-  std::vector<UniqueLabel> candidates;
-
-  const std::multimap<unsigned, SrcTypes::UniqueLabel>& labelmap =
-      acc->getProgram().labelmap;
-  for (auto it = labelmap.begin(); it != labelmap.end(); ++it) {
-    const UniqueLabel& unique_label = it->second;
-    if (unique_label.get_label() == label)
-      candidates.push_back(unique_label);
-  }
+  const std::vector<UniqueLabel>& candidates = index.findLoopLabels(label);
 
   if (candidates.size() == 0) {
     selected_label = UniqueLabel();
@@ -536,8 +515,8 @@ void DebugLoopPrinter::printLoop(const std::string &loop_name) {
       << "  Function: " << func->get_name() << "\n"
       << "  Line number: " << selected_label.get_line_number() << "\n";
 
-  std::list<cnode_pair_t> loop_bound_nodes =
-      acc->getProgram().findLoopBoundaries(selected_label);
+  const std::list<cnode_pair_t>& loop_bound_nodes =
+      index.getLoopBoundaries(selected_label);
   out << "  Loop boundaries: ";
   if (loop_bound_nodes.empty()) {
     out << "None.\n";
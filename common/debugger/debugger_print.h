@@ -6,6 +6,7 @@
 #include "../ExecNode.h"
 #include "../ScratchpadDatapath.h"
 #include "../SourceManager.h"
+#include "debugger_index.h"
 
 namespace adb {
 
@@ -20,13 +21,15 @@ class DebugPrinterBase {
  public:
   DebugPrinterBase(ScratchpadDatapath* _acc, std::ostream& _out)
       : acc(_acc), prog(_acc->getProgram()),
-        srcManager(acc->get_source_manager()), out(_out) {}
+        srcManager(acc->get_source_manager()), index(get_debug_index(_acc)),
+        out(_out) {}
   virtual ~DebugPrinterBase() = 0;
 
  protected:
   ScratchpadDatapath* acc;
   const Program& prog;
   SrcTypes::SourceManager& srcManager;
+  DebugIndex& index;
   std::ostream& out;
 };
 
@@ -117,7 +120,7 @@ class DebugFunctionPrinter : public DebugPrinterBase {
                        std::ostream& _out)
       : DebugPrinterBase(_acc, _out) {
     function = srcManager.get<SrcTypes::Function>(_function_name);
-    function_boundaries = acc->getProgram().findFunctionBoundaries(function);
+    function_boundaries = index.getFunctionBoundaries(function);
   }
 
   void printAll();
@@ -141,7 +144,7 @@ class DebugCyclePrinter : public DebugPrinterBase {
       : DebugPrinterBase(_acc, _out), cycle(_cycle), max_nodes(_max_nodes) {}
 
   void printAll();
-  std::list<const ExecNode*> findNodesExecutedinCycle();
+  std::vector<const ExecNode*> findNodesExecutedinCycle();
 
  private:
   int cycle;
@@ -7,6 +7,7 @@
 
 #include "../DDDG.h"
 #include "debugger_commands.h"
+#include "debugger_index.h"
 #include "debugger_prompt.h"
 #include "../file_func.h"
 #include "../Scratchpad.h"
@@ -130,6 +131,8 @@ HandlerRet cmd_unknown(std::string& command) {
 
 HandlerRet adb::interactive_mode(ScratchpadDatapath* acc) {
   std::cout << "Entering Aladdin Debugger...\n";
+  // The program may have been optimized or scheduled since the last prompt.
+  clear_debug_index();
   while (true) {
     std::string command = get_command();
 
@@ -0,0 +1,103 @@
+// Generates a synthetic dynamic trace and a matching configuration file.
+//
+// The trace can be simulated with Aladdin like a trace produced by
+// LLVM-Tracer, which makes it easy to test how Aladdin scales with the size
+// and shape of the workload. See SyntheticTrace.h for the shape of the traced
+// code.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "SyntheticTrace.h"
+
+static std::vector<unsigned> parseTripCounts(const std::string& value) {
+  std::vector<unsigned> trip_counts;
+  std::stringstream stream(value);
+  std::string field;
+  while (std::getline(stream, field, ','))
+    trip_counts.push_back(std::stoul(field));
+  return trip_counts;
+}
+
+static void printUsage() {
+  std::cout << "-------------------------------" << std::endl;
+  std::cout << "gen_trace takes:               " << std::endl;
+  std::cout << "./gen_trace <output prefix> [options]" << std::endl;
+  std::cout << "   Writes <output prefix>-trace.gz and <output prefix>.cfg.\n"
+            << "   --trips=<n,n,...>  Trip counts of the loop nest, outermost\n"
+            << "                      first (default 128).\n"
+            << "   --inputs=<n>       Input arrays (default 2).\n"
+            << "   --elements=<n>     Elements per array (default 128).\n"
+            << "   --word-size=<n>    Bytes per element, 4 or 8 (default 4).\n"
+            << "   --ops=<n>          Arithmetic ops per iteration (default 2).\n"
+            << "   --fp=<fraction>    Fraction of FP ops (default 0).\n"
+            << "   --mem-deps=<fraction>  Fraction of iterations that read the\n"
+            << "                      previous iteration's store (default 0).\n"
+            << "   --dma              Copy the arrays in and out with DMA.\n"
+            << "   --ready-bits       Use ready bits for the DMA loads.\n"
+            << "   --partition=<n>    Cyclic partition factor (default 2).\n"
+            << "   --unroll=<n>       Innermost unroll factor (default 2).\n"
+            << "   --pipelining       Enable loop pipelining.\n"
+            << "   --function=<name>  Name of the traced function.\n"
+            << "   --seed=<n>         Random seed (default 0)." << std::endl;
+  std::cout << "-------------------------------" << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    printUsage();
+    return 0;
+  }
+
+  SyntheticTraceParams params;
+  std::string prefix(argv[1]);
+  for (int i = 2; i < argc; i++) {
+    std::string arg(argv[i]);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.compare(0, 8, "--trips=") == 0) {
+      params.trip_counts = parseTripCounts(value);
+    } else if (arg.compare(0, 9, "--inputs=") == 0) {
+      params.num_inputs = std::stoul(value);
+    } else if (arg.compare(0, 11, "--elements=") == 0) {
+      params.array_elements = std::stoul(value);
+    } else if (arg.compare(0, 12, "--word-size=") == 0) {
+      params.word_size = std::stoul(value);
+    } else if (arg.compare(0, 6, "--ops=") == 0) {
+      params.ops_per_iteration = std::stoul(value);
+    } else if (arg.compare(0, 5, "--fp=") == 0) {
+      params.fp_fraction = std::stof(value);
+    } else if (arg.compare(0, 11, "--mem-deps=") == 0) {
+      params.mem_dep_density = std::stof(value);
+    } else if (arg == "--dma") {
+      params.dma = true;
+    } else if (arg == "--ready-bits") {
+      params.ready_bits = true;
+    } else if (arg.compare(0, 12, "--partition=") == 0) {
+      params.partition_factor = std::stoul(value);
+    } else if (arg.compare(0, 9, "--unroll=") == 0) {
+      params.unroll_factor = std::stoul(value);
+    } else if (arg == "--pipelining") {
+      params.pipelining = true;
+    } else if (arg.compare(0, 11, "--function=") == 0) {
+      params.function = value;
+    } else if (arg.compare(0, 7, "--seed=") == 0) {
+      params.seed = std::stoul(value);
+    } else {
+      std::cerr << "[ERROR]: Unknown option " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+  }
+  if (params.ready_bits && !params.dma) {
+    std::cerr << "[ERROR]: --ready-bits requires --dma." << std::endl;
+    return 1;
+  }
+
+  SyntheticTraceGenerator generator(params);
+  long num_nodes = generator.writeTrace(prefix + "-trace.gz");
+  generator.writeConfig(prefix + ".cfg");
+  std::cout << "Wrote " << num_nodes << " nodes to " << prefix << "-trace.gz"
+            << std::endl;
+  return 0;
+}
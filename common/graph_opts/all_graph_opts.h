@@ -6,14 +6,13 @@
 #include "base_opt.h"
 #include "base_address_init.h"
 #include "consecutive_branch_fusion.h"
+#include "dead_node_removal.h"
 #include "dma_base_address_init.h"
 #include "global_loop_pipelining.h"
-#include "induction_dependence_removal.h"
 #include "load_buffering.h"
 #include "loop_unrolling.h"
 #include "memory_ambiguation.h"
 #include "per_loop_pipelining.h"
-#include "phi_node_removal.h"
 #include "reg_load_store_fusion.h"
 #include "repeated_store_removal.h"
 #include "store_buffering.h"
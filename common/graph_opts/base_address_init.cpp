@@ -12,6 +12,10 @@ std::string BaseAddressInit::getCenteredName(size_t size) {
   return "       Init Base Address       ";
 }
 
+unsigned BaseAddressInit::getConfigFields() const {
+  return 0;
+}
+
 void BaseAddressInit::optimize() {
   EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
 
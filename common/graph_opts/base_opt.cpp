@@ -28,36 +28,24 @@ bool BaseAladdinOpt::doesEdgeExist(ExecNode* from, ExecNode* to) {
 }
 
 bool BaseAladdinOpt::doesEdgeExist(Vertex from, Vertex to) {
-  return edge(from, to, graph).second;
+  return program.edgeExistsV(from, to);
 }
 
-void BaseAladdinOpt::updateGraphWithNewEdges(
-    std::vector<NewEdge>& to_add_edges) {
-  std::cout << "  Adding " << to_add_edges.size() << " new edges.\n";
-  for (auto it = to_add_edges.begin(); it != to_add_edges.end(); ++it) {
-    if (*it->from != *it->to && !doesEdgeExist(it->from, it->to)) {
-      get(boost::edge_name,
-          graph)[add_edge(it->from->get_vertex(), it->to->get_vertex(), graph)
-                     .first] = it->parid;
-    }
-  }
+void BaseAladdinOpt::updateGraph(GraphDelta& delta) {
+  std::cout << "  Removing " << delta.numRemovedEdges() << " edges.\n"
+            << "  Adding " << delta.numAddedEdges() << " new edges.\n";
+  delta.apply(graph, barriers, vertex_to_name);
 }
+
 void BaseAladdinOpt::updateGraphWithIsolatedNodes(
     std::vector<unsigned>& to_remove_nodes) {
   std::cout << "  Removing " << to_remove_nodes.size() << " isolated nodes.\n";
   for (auto it = to_remove_nodes.begin(); it != to_remove_nodes.end(); ++it) {
     clear_vertex(exec_nodes.at(*it)->get_vertex(), graph);
+    barriers.removeNode(*it);
   }
 }
 
-void BaseAladdinOpt::updateGraphWithIsolatedEdges(
-    std::set<Edge>& to_remove_edges) {
-  std::cout << "  Removing " << to_remove_edges.size() << " edges.\n";
-  for (auto it = to_remove_edges.begin(), E = to_remove_edges.end(); it != E;
-       ++it)
-    remove_edge(source(*it, graph), target(*it, graph), graph);
-}
-
 bool BaseAladdinOpt::isPrunableNode(ExecNode* node) const {
   unsigned node_microop = node->get_microop();
   // Certain types of operations modify program state or control flow without
@@ -108,17 +96,15 @@ void BaseAladdinOpt::cleanLeafNodes() {
     num_children_to_be_removed[node_it.first] = 0;
   std::vector<unsigned> to_remove_nodes;
 
-  std::vector<Vertex> topo_nodes;
-  boost::topological_sort(graph, std::back_inserter(topo_nodes));
+  std::vector<Vertex> topo_nodes = program.getReverseTopologicalOrder();
   // bottom nodes first
   for (auto vi = topo_nodes.begin(); vi != topo_nodes.end(); ++vi) {
     Vertex node_vertex = *vi;
-    if (boost::degree(node_vertex, graph) == 0)
-      continue;
     unsigned node_id = vertex_to_name[node_vertex];
     ExecNode* node = exec_nodes.at(node_id);
-    if (num_children_to_be_removed.at(node_id) ==
-            boost::out_degree(node_vertex, graph) &&
+    if (program.getDegree(node) == 0)
+      continue;
+    if (num_children_to_be_removed.at(node_id) == program.getOutDegree(node) &&
         isPrunableNode(node)) {
       to_remove_nodes.push_back(node_id);
       // This node will be removed, so we need to update the counters for all
@@ -130,6 +116,9 @@ void BaseAladdinOpt::cleanLeafNodes() {
         int parent_id = vertex_to_name[source(*in_edge_it, graph)];
         num_children_to_be_removed.at(parent_id)++;
       }
+      barriers.forEachParent(node_id, [&](unsigned parent_id) {
+        num_children_to_be_removed.at(parent_id)++;
+      });
     } else if (node->is_branch_op()) {
       // Increment the counter for every parent of this branch node with a
       // control dependence. A control dependence is an artifically introduced
@@ -146,6 +135,9 @@ void BaseAladdinOpt::cleanLeafNodes() {
           num_children_to_be_removed.at(parent_id)++;
         }
       }
+      barriers.forEachParent(node_id, [&](unsigned parent_id) {
+        num_children_to_be_removed.at(parent_id)++;
+      });
     }
   }
   updateGraphWithIsolatedNodes(to_remove_nodes);
@@ -9,6 +9,7 @@
 #include "../opcode_func.h"
 #include "../typedefs.h"
 #include "../user_config.h"
+#include "graph_delta.h"
 
 class BaseAladdinOpt {
  public:
@@ -23,7 +24,7 @@ class BaseAladdinOpt {
                  const SrcTypes::SourceManager& _src_manager,
                  const UserConfigParams& _user_params)
       : program(_program), exec_nodes(_program.nodes), graph(_program.graph),
-        loop_bounds(_program.loop_bounds),
+        loop_bounds(_program.loop_bounds), barriers(_program.barriers),
         vertex_to_name(_program.vertex_to_name), labelmap(_program.labelmap),
         src_manager(_src_manager), call_argument_map(_program.call_arg_map),
         user_params(_user_params) {}
@@ -32,13 +33,14 @@ class BaseAladdinOpt {
   virtual void optimize() = 0;
   virtual std::string getCenteredName(size_t size) = 0;
 
- protected:
-  struct NewEdge {
-    ExecNode* from;
-    ExecNode* to;
-    int parid;
-  };
+  // The groups of user configuration fields (a bitmask of
+  // UserConfigParams::Field) that this optimization reads, including through
+  // the helpers below: cleanLeafNodes() reads ready_mode and getUnrollFactor()
+  // reads the unrolling factors. Optimized graphs are cached under these
+  // fields, so the list must be complete.
+  virtual unsigned getConfigFields() const = 0;
 
+ protected:
   // XXX: These are accessible from program.
   ExecNode* getNodeFromVertex(Vertex vertex);
   bool doesEdgeExist(ExecNode* from, ExecNode* to);
@@ -50,9 +52,9 @@ class BaseAladdinOpt {
   unrolling_config_t::const_iterator getUnrollFactor(ExecNode* node);
   SrcTypes::UniqueLabel getUniqueLabel(ExecNode* node);
 
-  void updateGraphWithNewEdges(std::vector<NewEdge>& to_add_edges);
+  // Apply and clear all the edge changes recorded in @delta.
+  void updateGraph(GraphDelta& delta);
   void updateGraphWithIsolatedNodes(std::vector<unsigned>& to_remove_nodes);
-  void updateGraphWithIsolatedEdges(std::set<Edge>& to_remove_edges);
   void cleanLeafNodes();
 
   const Program& program;
@@ -61,6 +63,7 @@ class BaseAladdinOpt {
   ExecNodeMap& exec_nodes;
   Graph& graph;
   std::vector<DynLoopBound>& loop_bounds;
+  ControlBarriers& barriers;
 
   // Unmutable graph properties.
   const VertexNameMap& vertex_to_name;
@@ -15,40 +15,40 @@ std::string ConsecutiveBranchFusion::getCenteredName(size_t size) {
   return "   Fuse consecutive branches   ";
 }
 
+unsigned ConsecutiveBranchFusion::getConfigFields() const {
+  return UserConfigParams::ReadyMode;
+}
+
 void ConsecutiveBranchFusion::optimize() {
-  std::set<Edge> to_remove_edges;
-  std::vector<NewEdge> to_add_edges;
+  GraphDelta delta;
 
-  std::list<Vertex> topo_nodes;
-  boost::topological_sort(graph, std::front_inserter(topo_nodes));
+  std::vector<Vertex> topo_nodes = program.getReverseTopologicalOrder();
 
-  for (auto vi = topo_nodes.begin(); vi != topo_nodes.end(); ++vi) {
-    Vertex vertex = *vi;
-    ExecNode* node = getNodeFromVertex(vertex);
+  for (auto vi = topo_nodes.rbegin(); vi != topo_nodes.rend(); ++vi) {
+    ExecNode* node = getNodeFromVertex(*vi);
     if (!(node->is_branch_op() || node->is_call_op()))
       continue;
-    if (boost::out_degree(vertex, graph) != 1)
+    if (program.getOutDegree(node) != 1)
       continue;
 
     std::list<ExecNode*> branch_chain{ node };
-    findBranchChain(node, branch_chain, to_remove_edges);
+    findBranchChain(node, branch_chain, delta);
     if (branch_chain.size() > 1) {
       for (auto it = branch_chain.begin(); it != --branch_chain.end();)
-        to_add_edges.push_back({ *it, *(++it), FUSED_BRANCH_EDGE });
+        delta.addEdge(*it, *(++it), FUSED_BRANCH_EDGE);
     }
   }
 
-  updateGraphWithIsolatedEdges(to_remove_edges);
-  updateGraphWithNewEdges(to_add_edges);
+  updateGraph(delta);
   cleanLeafNodes();
 }
 
 void ConsecutiveBranchFusion::findBranchChain(
     ExecNode* root,
     std::list<ExecNode*>& branch_chain,
-    std::set<Edge>& to_remove_edges) {
+    GraphDelta& delta) {
 
-  if (boost::out_degree(root->get_vertex(), graph) != 1)
+  if (program.getOutDegree(root) != 1)
     return;
   out_edge_iter out_edge_it, out_edge_end;
   for (boost::tie(out_edge_it, out_edge_end) =
@@ -59,9 +59,17 @@ void ConsecutiveBranchFusion::findBranchChain(
     ExecNode* target_node = getNodeFromVertex(target_vertex);
     if (target_node->is_branch_op() || target_node->is_call_op()) {
       branch_chain.push_back(target_node);
-      to_remove_edges.insert(*out_edge_it);
-      findBranchChain(target_node, branch_chain, to_remove_edges);
+      delta.removeEdge(*out_edge_it, graph);
+      findBranchChain(target_node, branch_chain, delta);
     }
   }
+  barriers.forEachChild(root->get_node_id(), [&](unsigned target_id) {
+    ExecNode* target_node = exec_nodes.at(target_id);
+    if (target_node->is_branch_op() || target_node->is_call_op()) {
+      branch_chain.push_back(target_node);
+      delta.removeEdge(root->get_vertex(), target_node->get_vertex());
+      findBranchChain(target_node, branch_chain, delta);
+    }
+  });
 }
 
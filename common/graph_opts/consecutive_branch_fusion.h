@@ -2,7 +2,6 @@
 #define _CONSECUTIVE_BRANCH_FUSION_H_
 
 #include <list>
-#include <set>
 
 #include "base_opt.h"
 
@@ -11,11 +10,12 @@ class ConsecutiveBranchFusion : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 
  protected:
   void findBranchChain(ExecNode* root,
                        std::list<ExecNode*>& branch_chain,
-                       std::set<Edge>& to_remove_edges);
+                       GraphDelta& delta);
 };
 
 #endif
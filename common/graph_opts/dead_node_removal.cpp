@@ -0,0 +1,21 @@
+#include "dead_node_removal.h"
+
+// Dead node removal.
+//
+// Removes all nodes whose results are never used. PHI and convert nodes do not
+// need to be accounted for during simulation, so the DDDG never creates them:
+// their children depend directly on the node that wrote the forwarded
+// register. Any node that only fed a PHI or convert node is then a leaf, and
+// is removed here.
+
+std::string DeadNodeRemoval::getCenteredName(size_t size) {
+  return "      Remove Dead Nodes       ";
+}
+
+unsigned DeadNodeRemoval::getConfigFields() const {
+  return UserConfigParams::ReadyMode;
+}
+
+void DeadNodeRemoval::optimize() {
+  cleanLeafNodes();
+}
@@ -1,13 +1,14 @@
-#ifndef _REMOVE_PHI_NODES_H_
-#define _REMOVE_PHI_NODES_H_
+#ifndef _DEAD_NODE_REMOVAL_H_
+#define _DEAD_NODE_REMOVAL_H_
 
 #include "base_opt.h"
 
-class PhiNodeRemoval : public BaseAladdinOpt {
+class DeadNodeRemoval : public BaseAladdinOpt {
  public:
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 };
 
 #endif
@@ -73,6 +73,10 @@ std::string DmaBaseAddressInit::getCenteredName(size_t size) {
   return "     Init DMA Base Address     ";
 }
 
+unsigned DmaBaseAddressInit::getConfigFields() const {
+  return UserConfigParams::PartitionLayout;
+}
+
 // Set the memory type of this host memory access node.
 void DmaBaseAddressInit::setHostMemoryType(ExecNode* node) {
   HostMemAccess* mem_access = node->get_host_mem_access();
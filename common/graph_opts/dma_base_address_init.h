@@ -8,6 +8,7 @@ class DmaBaseAddressInit : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 
  private:
   // Set the memory type of this host memory access node.
@@ -15,6 +15,11 @@ std::string GlobalLoopPipelining::getCenteredName(size_t size) {
   return "         Loop Pipelining        ";
 }
 
+unsigned GlobalLoopPipelining::getConfigFields() const {
+  return UserConfigParams::GlobalPipelining | UserConfigParams::Unrolling |
+         UserConfigParams::ReadyMode;
+}
+
 void GlobalLoopPipelining::optimize() {
   if (!user_params.global_pipelining) {
     std::cerr << "Global loop pipelining is not ON." << std::endl;
@@ -34,38 +39,29 @@ void GlobalLoopPipelining::optimize() {
   EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
 
   vertex_iter vi, vi_end;
-  std::set<Edge> to_remove_edges;
-  std::vector<NewEdge> to_add_edges;
+  GraphDelta delta;
 
   // first_non_isolated_node stores mappings between a loop boundary and its
   // first non isolated node.
   std::map<unsigned, unsigned> first_non_isolated_node;
-  auto bound_it = loop_bounds.begin();
-  auto node_it = exec_nodes.begin();
-  ExecNode* curr_node = exec_nodes.at(bound_it->node_id);
-  bound_it++;  // skip first region
-  while (node_it != exec_nodes.end()) {
-    assert(exec_nodes.at(bound_it->node_id)->is_branch_op());
-    while (node_it != exec_nodes.end() && node_it->first < bound_it->node_id) {
-      curr_node = node_it->second;
-      if (!curr_node->has_vertex() ||
-          boost::degree(curr_node->get_vertex(), graph) == 0 ||
-          curr_node->is_branch_op()) {
-        ++node_it;
-        continue;
-      } else {
-        first_non_isolated_node[bound_it->node_id] = curr_node->get_node_id();
-        node_it = exec_nodes.find(bound_it->node_id);
-        assert(node_it != exec_nodes.end());
+  const LoopRegions& regions = program.getLoopRegions();
+  // Every bound but the first and the last ends a region.
+  for (unsigned region = 1; region + 1 < regions.size(); region++) {
+    unsigned bound_id = regions.end(region);
+    assert(exec_nodes.at(bound_id)->is_branch_op());
+    // Nodes before the first bound count as part of the first iteration.
+    unsigned begin_id = region == 1 ? regions.begin(0) : regions.begin(region);
+    first_non_isolated_node[bound_id] = bound_id;
+    for (auto node_it = exec_nodes.lower_bound(begin_id);
+         node_it != exec_nodes.end() && node_it->first < bound_id;
+         ++node_it) {
+      ExecNode* curr_node = node_it->second;
+      if (curr_node->has_vertex() && program.getDegree(curr_node) != 0 &&
+          !curr_node->is_branch_op()) {
+        first_non_isolated_node[bound_id] = node_it->first;
         break;
       }
     }
-    if (first_non_isolated_node.find(bound_it->node_id) ==
-        first_non_isolated_node.end())
-      first_non_isolated_node[bound_it->node_id] = bound_it->node_id;
-    bound_it++;
-    if (bound_it == loop_bounds.end() - 1)
-      break;
   }
 
   ExecNode* prev_branch_n = nullptr;
@@ -100,7 +96,7 @@ void GlobalLoopPipelining::optimize() {
     }
     // adding dependence between prev_first and first_id
     if (!doesEdgeExist(prev_first_n, first_node)) {
-      to_add_edges.push_back({ prev_first_n, first_node, CONTROL_EDGE });
+      delta.addEdge(prev_first_n, first_node, CONTROL_EDGE);
     }
     // adding dependence between first_id and prev_branch's children
     assert(prev_branch_n->has_vertex());
@@ -115,10 +111,15 @@ void GlobalLoopPipelining::optimize() {
           edge_to_parid[*out_edge_it] != CONTROL_EDGE)
         continue;
       if (!doesEdgeExist(first_node, child_node)) {
-        to_add_edges.push_back({ first_node, child_node, 1 });
+        delta.addEdge(first_node, child_node, 1);
       }
     }
-    // update first_id's parents, dependence become strict control dependence
+    barriers.forEachChild(prev_branch_n->get_node_id(), [&](unsigned child_id) {
+      ExecNode* child_node = exec_nodes.at(child_id);
+      if (*child_node >= *first_node && !doesEdgeExist(first_node, child_node))
+        delta.addEdge(first_node, child_node, 1);
+    });
+    // remove first_id's dependences on its parents, like PerLoopPipelining
     assert(first_node->has_vertex());
     in_edge_iter in_edge_it, in_edge_end;
     for (boost::tie(in_edge_it, in_edge_end) =
@@ -130,8 +131,7 @@ void GlobalLoopPipelining::optimize() {
       // unsigned parent_id = vertex_to_name[parent_vertex];
       if (parent_node->is_branch_op())
         continue;
-      to_remove_edges.insert(*in_edge_it);
-      to_add_edges.push_back({ parent_node, first_node, CONTROL_EDGE });
+      delta.removeEdge(*in_edge_it, graph);
     }
     // remove control dependence between prev br node to its children
     assert(prev_branch_n->has_vertex());
@@ -143,13 +143,16 @@ void GlobalLoopPipelining::optimize() {
         continue;
       if (edge_to_parid[*out_edge_it] != CONTROL_EDGE)
         continue;
-      to_remove_edges.insert(*out_edge_it);
+      delta.removeEdge(*out_edge_it, graph);
     }
+    barriers.forEachChild(prev_branch_n->get_node_id(), [&](unsigned child_id) {
+      if (!exec_nodes.at(child_id)->is_call_op())
+        delta.removeEdge(program, prev_branch_n->get_node_id(), child_id);
+    });
     prev_branch_n = br_node;
     prev_first_n = first_node;
   }
 
-  updateGraphWithNewEdges(to_add_edges);
-  updateGraphWithIsolatedEdges(to_remove_edges);
+  updateGraph(delta);
   cleanLeafNodes();
 }
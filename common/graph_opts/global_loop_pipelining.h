@@ -8,6 +8,7 @@ class GlobalLoopPipelining : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 };
 
 #endif
@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "graph_delta.h"
+
+void GraphDelta::apply(Graph& graph,
+                       ControlBarriers& barriers,
+                       const VertexNameMap& vertex_to_name) {
+  EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
+
+  std::sort(removed.begin(), removed.end());
+  removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+  // Keep the first parid of every added edge.
+  std::stable_sort(added.begin(), added.end());
+  added.erase(std::unique(added.begin(), added.end()), added.end());
+
+  // Both lists are now sorted, so an edge that is removed and added again
+  // can be found by walking them together.
+  std::vector<bool> applied(added.size(), false);
+  auto add_it = added.begin();
+  for (const Change& change : removed) {
+    while (add_it != added.end() && *add_it < change)
+      ++add_it;
+    bool readded = add_it != added.end() && *add_it == change &&
+                   add_it->from != add_it->to;
+    auto existing = edge(change.from, change.to, graph);
+    if (existing.second) {
+      if (readded) {
+        edge_to_parid[existing.first] = add_it->parid;
+        applied[add_it - added.begin()] = true;
+      } else {
+        remove_edge(change.from, change.to, graph);
+      }
+    } else {
+      barriers.removeEdge(vertex_to_name[change.from],
+                          vertex_to_name[change.to]);
+    }
+  }
+
+  for (unsigned i = 0; i < added.size(); i++) {
+    const Change& change = added[i];
+    if (applied[i] || change.from == change.to)
+      continue;
+    if (barriers.hasEdge(vertex_to_name[change.from],
+                         vertex_to_name[change.to]))
+      continue;
+    auto result = add_edge(change.from, change.to, graph);
+    if (result.second)
+      edge_to_parid[result.first] = change.parid;
+  }
+  clear();
+}
+
+void GraphDelta::clear() {
+  added.clear();
+  removed.clear();
+}
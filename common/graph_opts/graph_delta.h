@@ -0,0 +1,69 @@
+#ifndef _GRAPH_DELTA_H_
+#define _GRAPH_DELTA_H_
+
+#include <vector>
+
+#include "../ExecNode.h"
+#include "../Program.h"
+#include "../typedefs.h"
+
+// A batch of changes to the edges of a program's graph.
+//
+// Graph optimizations walk the graph while they decide what to change, so
+// they record the edges to add and remove here and apply them all at once at
+// the end. The delta sorts and deduplicates the changes so that each vertex's
+// edges are updated together.
+//
+// All removals take effect before any addition. Removing an edge and adding
+// it back with another parid therefore changes the type of the edge, which is
+// done in place. Adding an edge that already exists, including an implicit
+// control edge of the barriers, does nothing; if the same edge is added more
+// than once, the first parid wins. Removing an edge removes either the real
+// edge or the implicit one, whichever exists.
+class GraphDelta {
+ public:
+  void addEdge(const ExecNode* from, const ExecNode* to, int parid) {
+    added.push_back({ from->get_vertex(), to->get_vertex(), parid });
+  }
+  void removeEdge(Vertex from, Vertex to) {
+    removed.push_back({ from, to, 0 });
+  }
+  void removeEdge(const Edge& edge, const Graph& graph) {
+    removeEdge(source(edge, graph), target(edge, graph));
+  }
+  // Remove an edge by the ids of its nodes.
+  void removeEdge(const Program& program, unsigned from, unsigned to) {
+    removeEdge(program.nodes.at(from)->get_vertex(),
+               program.nodes.at(to)->get_vertex());
+  }
+
+  // The number of changes that were requested, including duplicates.
+  unsigned numAddedEdges() const { return added.size(); }
+  unsigned numRemovedEdges() const { return removed.size(); }
+  bool empty() const { return added.empty() && removed.empty(); }
+
+  // Apply all the changes to @graph and @barriers, and clear the delta.
+  void apply(Graph& graph,
+             ControlBarriers& barriers,
+             const VertexNameMap& vertex_to_name);
+  void clear();
+
+ private:
+  struct Change {
+    Vertex from;
+    Vertex to;
+    int parid;
+
+    bool operator<(const Change& other) const {
+      return from < other.from || (from == other.from && to < other.to);
+    }
+    bool operator==(const Change& other) const {
+      return from == other.from && to == other.to;
+    }
+  };
+
+  std::vector<Change> added;
+  std::vector<Change> removed;
+};
+
+#endif
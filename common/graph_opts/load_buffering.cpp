@@ -1,9 +1,15 @@
 #include "load_buffering.h"
 
+#include "../DDDG.h"
+
 std::string LoadBuffering::getCenteredName(size_t size) {
   return "          Load Buffer          ";
 }
 
+unsigned LoadBuffering::getConfigFields() const {
+  return UserConfigParams::Unrolling | UserConfigParams::ReadyMode;
+}
+
 void LoadBuffering::optimize() {
   if (!user_params.unrolling.size() && loop_bounds.size() <= 2)
     return;
@@ -12,23 +18,19 @@ void LoadBuffering::optimize() {
 
   vertex_iter vi, vi_end;
 
-  std::set<Edge> to_remove_edges;
-  std::vector<NewEdge> to_add_edges;
+  GraphDelta delta;
+  std::vector<unsigned> to_remove_barrier_nodes;
 
   int shared_loads = 0;
-  auto bound_it = loop_bounds.begin();
-
-  auto node_it = exec_nodes.begin();
-  while (node_it != exec_nodes.end()) {
+  const LoopRegions& regions = program.getLoopRegions();
+  for (unsigned region = 0; region < regions.size(); region++) {
     std::unordered_map<unsigned, ExecNode*> address_loaded;
-    while (node_it->first < bound_it->node_id && node_it != exec_nodes.end()) {
-      ExecNode* node = node_it->second;
-      if (!node->has_vertex() ||
-          boost::degree(node->get_vertex(), graph) == 0 ||
-          !node->is_memory_op()) {
-        node_it++;
+    for (unsigned node_id :
+         regions.getNodes(region, LoopRegions::MemoryOps)) {
+      ExecNode* node = exec_nodes.at(node_id);
+      if (!node->has_vertex() || program.getDegree(node) == 0 ||
+          !node->is_memory_op())
         continue;
-      }
       Addr node_address = node->get_mem_access()->vaddr;
       auto addr_it = address_loaded.find(node_address);
       if (node->is_store_op() && addr_it != address_loaded.end()) {
@@ -38,10 +40,8 @@ void LoadBuffering::optimize() {
           address_loaded[node_address] = node;
         } else {
           // check whether the current load is dynamic or not.
-          if (node->is_dynamic_mem_op()) {
-            ++node_it;
+          if (node->is_dynamic_mem_op())
             continue;
-          }
           shared_loads++;
           node->set_microop(LLVM_IR_Move);
           ExecNode* prev_load = addr_it->second;
@@ -58,26 +58,28 @@ void LoadBuffering::optimize() {
             Vertex prev_load_vertex = prev_load->get_vertex();
             if (!doesEdgeExist(prev_load_vertex, child_vertex)) {
               ExecNode* child_node = getNodeFromVertex(child_vertex);
-              to_add_edges.push_back(
-                  { prev_load, child_node, edge_to_parid[curr_edge] });
+              delta.addEdge(prev_load, child_node, edge_to_parid[curr_edge]);
             }
-            to_remove_edges.insert(*out_edge_it);
+            delta.removeEdge(curr_edge, graph);
           }
+          barriers.forEachChild(node_id, [&](unsigned child_id) {
+            ExecNode* child_node = exec_nodes.at(child_id);
+            if (!doesEdgeExist(prev_load, child_node))
+              delta.addEdge(prev_load, child_node, CONTROL_EDGE);
+          });
+          to_remove_barrier_nodes.push_back(node_id);
           in_edge_iter in_edge_it, in_edge_end;
           for (boost::tie(in_edge_it, in_edge_end) =
                    in_edges(load_node, graph);
                in_edge_it != in_edge_end;
                ++in_edge_it)
-            to_remove_edges.insert(*in_edge_it);
+            delta.removeEdge(*in_edge_it, graph);
         }
       }
-      node_it++;
     }
-    bound_it++;
-    if (bound_it == loop_bounds.end())
-      break;
   }
-  updateGraphWithNewEdges(to_add_edges);
-  updateGraphWithIsolatedEdges(to_remove_edges);
+  updateGraph(delta);
+  for (unsigned node_id : to_remove_barrier_nodes)
+    barriers.removeNode(node_id);
   cleanLeafNodes();
 }
@@ -20,6 +20,10 @@ std::string LoopUnrolling::getCenteredName(size_t size) {
   return "         Loop Unrolling        ";
 }
 
+unsigned LoopUnrolling::getConfigFields() const {
+  return UserConfigParams::Unrolling | UserConfigParams::ReadyMode;
+}
+
 void LoopUnrolling::optimize() {
   if (!user_params.unrolling.size()) {
     std::cerr << "No loop unrolling configuration options found." << std::endl;
@@ -28,12 +32,13 @@ void LoopUnrolling::optimize() {
   std::stack<LoopBoundDescriptor> loop_nests;
   std::vector<unsigned> to_remove_nodes;
   std::vector<ExecNode*> nodes_between;
-  std::vector<NewEdge> to_add_edges;
 
   bool first = false;
   int iter_counts = 0;
   unsigned curr_call_depth = 0;
   ExecNode* prev_branch = nullptr;
+  // Earlier passes may have added barriers already.
+  unsigned initial_barrier_edges = barriers.numEdges();
 
   for (auto node_it = exec_nodes.begin(); node_it != exec_nodes.end();
        ++node_it) {
@@ -49,13 +54,12 @@ void LoopUnrolling::optimize() {
         loop_nests.pop();
       }
     }
-    Vertex node_vertex = node->get_vertex();
     // We let all the branch nodes proceed to the unrolling handling no matter
     // whether they are isolated or not. Although most of the branch nodes are
     // connected anyway, one exception is unconditional branch that is not
     // dependent on any nodes. The is_branch_op() check can let the
     // unconditional branch proceed.
-    if (boost::degree(node_vertex, graph) == 0 && !node->is_branch_op())
+    if (program.getDegree(node) == 0 && !node->is_branch_op())
       continue;
     if (user_params.ready_mode && node->is_dma_load())
       continue;
@@ -77,8 +81,9 @@ void LoopUnrolling::optimize() {
     assert(prev_branch != nullptr);
     // We should never add control edges to DMA nodes. They should be
     // constrained by memory dependences only.
-    if (prev_branch != node && !node->is_dma_op()) {
-      to_add_edges.push_back({ prev_branch, node, CONTROL_EDGE });
+    if (prev_branch != node && !node->is_dma_op() &&
+        !doesEdgeExist(prev_branch, node)) {
+      barriers.addEntryEdge(prev_branch->get_node_id(), node_id);
     }
     // If the current node is not a branch node, it will not be a boundary node.
     if (!node->is_branch_op()) {
@@ -98,15 +103,16 @@ void LoopUnrolling::optimize() {
           nodes_between.push_back(node);
           continue;
         }
-        if (!doesEdgeExist(prev_branch, node) && !node->is_dma_op()) {
+        if (prev_branch != node && !doesEdgeExist(prev_branch, node) &&
+            !node->is_dma_op()) {
           // Enforce dependences between branch nodes, including call nodes
-          to_add_edges.push_back({ prev_branch, node, CONTROL_EDGE });
+          barriers.addEntryEdge(prev_branch->get_node_id(), node_id);
         }
         for (auto prev_node_it = nodes_between.begin(), E = nodes_between.end();
              prev_node_it != E;
              prev_node_it++) {
           if (!doesEdgeExist(*prev_node_it, node)) {
-            to_add_edges.push_back({ *prev_node_it, node, CONTROL_EDGE });
+            barriers.addExitEdge((*prev_node_it)->get_node_id(), node_id);
           }
         }
         nodes_between.clear();
@@ -176,7 +182,7 @@ void LoopUnrolling::optimize() {
                prev_node_it != E;
                prev_node_it++) {
             if (!doesEdgeExist(*prev_node_it, node)) {
-              to_add_edges.push_back({ *prev_node_it, node, CONTROL_EDGE });
+              barriers.addExitEdge((*prev_node_it)->get_node_id(), node_id);
             }
           }
           nodes_between.clear();
@@ -188,7 +194,9 @@ void LoopUnrolling::optimize() {
       }
     }
   }
-  loop_bounds.push_back(DynLoopBound(exec_nodes.size(), 0));
+  // The last bound is one past the last node.
+  unsigned end_id = exec_nodes.empty() ? 0 : exec_nodes.rbegin()->first + 1;
+  loop_bounds.push_back(DynLoopBound(end_id, 0));
 
   if (iter_counts == 0 && user_params.unrolling.size() != 0) {
     std::cerr << "-------------------------------\n"
@@ -197,7 +205,8 @@ void LoopUnrolling::optimize() {
               << "loop unrolling factor is larger than the loop trip count.\n"
               << "-------------------------------" << std::endl;
   }
-  updateGraphWithNewEdges(to_add_edges);
+  std::cout << "  Adding " << barriers.numEdges() - initial_barrier_edges
+            << " control edges.\n";
   updateGraphWithIsolatedNodes(to_remove_nodes);
   cleanLeafNodes();
 }
@@ -206,6 +215,10 @@ std::string LoopFlattening::getCenteredName(size_t size) {
   return "         Loop Flatten          ";
 }
 
+unsigned LoopFlattening::getConfigFields() const {
+  return UserConfigParams::Unrolling | UserConfigParams::ReadyMode;
+}
+
 void LoopFlattening::optimize() {
   if (!user_params.unrolling.size())
     return;
@@ -53,6 +53,7 @@ class LoopUnrolling : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 };
 
 class LoopFlattening : public BaseAladdinOpt {
@@ -60,6 +61,7 @@ class LoopFlattening : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 
 };
 
@@ -1,4 +1,3 @@
-#include <list>
 #include <vector>
 
 #include "memory_ambiguation.h"
@@ -20,8 +19,15 @@ std::string MemoryAmbiguationOpt::getCenteredName(size_t size) {
   return "      Memory Ambiguation       ";
 }
 
+unsigned MemoryAmbiguationOpt::getConfigFields() const {
+  return 0;
+}
+
 void MemoryAmbiguationOpt::optimize() {
-  std::vector<NewEdge> to_add_edges;
+  GraphDelta delta;
+  source_set_ids.clear();
+  source_sets.clear();
+  node_sources.clear();
   EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
   using gep_store_pair_t = std::pair<ExecNode*, ExecNode*>;
   std::unordered_map<DynamicInstruction, std::vector<gep_store_pair_t>>
@@ -63,30 +69,33 @@ void MemoryAmbiguationOpt::optimize() {
   std::vector<DynamicInstruction> stores_to_serialize;
   for (const auto& kv_pair : possible_dependent_stores) {
     const std::vector<gep_store_pair_t>& store_list = kv_pair.second;
-    std::list<MemoryAddrSources> all_sources;
+    std::vector<unsigned> all_sources;
     for (const gep_store_pair_t& pair : store_list) {
       ExecNode* gep = pair.first;
       all_sources.push_back(findMemoryAddrSources(
           gep, gep->get_static_function(), edge_to_parid));
     }
-    unsigned idx = 0;
-    for (auto it = all_sources.begin(); it != --all_sources.end(); ++idx) {
-      MemoryAddrSources& curr_source = *it;
-      MemoryAddrSources& next_source = *(++it);
+    for (unsigned idx = 0; idx + 1 < all_sources.size(); ++idx) {
+      const MemoryAddrSources& curr_source = getSources(all_sources[idx]);
+      const MemoryAddrSources& next_source = getSources(all_sources[idx + 1]);
       if (!curr_source.is_independent_of(next_source, idx == 0)) {
-        to_add_edges.push_back({ store_list[idx].second,
-                                 store_list[idx + 1].second, MEMORY_EDGE });
+        delta.addEdge(store_list[idx].second, store_list[idx + 1].second,
+                      MEMORY_EDGE);
       }
     }
   }
 
-  updateGraphWithNewEdges(to_add_edges);
+  updateGraph(delta);
 }
 
-MemoryAddrSources MemoryAmbiguationOpt::findMemoryAddrSources(
+unsigned MemoryAmbiguationOpt::findMemoryAddrSources(
     ExecNode* current_node,
     Function* current_func,
     EdgeNameMap& edge_to_parid) {
+  auto memo_it = node_sources.find(current_node->get_node_id());
+  if (memo_it != node_sources.end())
+    return memo_it->second;
+
   in_edge_iter in_edge_it, in_edge_end;
   MemoryAddrSources sources;
   for (boost::tie(in_edge_it, in_edge_end) =
@@ -106,8 +115,8 @@ MemoryAddrSources MemoryAmbiguationOpt::findMemoryAddrSources(
       if (parent_node->get_microop() == LLVM_IR_IndexAdd) {
         sources.add_inductive(parent_node);
       } else if (!parent_node->is_inductive()) {
-        sources.merge(findMemoryAddrSources(
-            parent_node, current_func, edge_to_parid));
+        sources.merge(getSources(
+            findMemoryAddrSources(parent_node, current_func, edge_to_parid)));
       }
     }
   }
@@ -115,6 +124,14 @@ MemoryAddrSources MemoryAmbiguationOpt::findMemoryAddrSources(
       !current_node->is_inductive() &&
       current_node->get_static_function() == current_func)
     sources.add_noninductive(current_node);
-  sources.sort_and_uniquify();
-  return sources;
+  unsigned id = internSources(std::move(sources));
+  node_sources[current_node->get_node_id()] = id;
+  return id;
+}
+
+unsigned MemoryAmbiguationOpt::internSources(MemoryAddrSources&& sources) {
+  auto result = source_set_ids.emplace(std::move(sources), source_sets.size());
+  if (result.second)
+    source_sets.push_back(&result.first->first);
+  return result.first->second;
 }
@@ -1,6 +1,10 @@
 #ifndef _MEMORY_AMBIGUATION_H_
 #define _MEMORY_AMBIGUATION_H_
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+
 #include "base_opt.h"
 
 /* A class to represent the sources of a memory address generation.
@@ -15,24 +19,24 @@
  *     array[base][i] = some value;
  *   }
  *
- * This class wraps the underlying containers to hide the choice of
- * implementation from the user.
+ * Both sets are kept sorted by node id without duplicates, so that different
+ * MemoryAddrSources objects can be compared directly.
  */
 class MemoryAddrSources {
  public:
   MemoryAddrSources() {}
 
   void add_noninductive(ExecNode* node) {
-    noninductive.push_back(node);
+    insert(noninductive, node);
   }
 
   void add_inductive(ExecNode* node) {
-    inductive.push_back(node);
+    insert(inductive, node);
   }
 
-  void merge(MemoryAddrSources&& other) {
-    noninductive.merge(other.noninductive);
-    inductive.merge(other.inductive);
+  void merge(const MemoryAddrSources& other) {
+    merge(noninductive, other.noninductive);
+    merge(inductive, other.inductive);
   }
 
   bool empty() const {
@@ -55,21 +59,10 @@ class MemoryAddrSources {
     std::cout << "]\n";
   }
 
-  // Eliminate any duplicates and sort the nodes by node id, so that we can
-  // then do a direct comparison between different MemoryAddrSources objects.
-  void sort_and_uniquify() {
-    auto compare = [](const ExecNode* n1, const ExecNode* n2) {
-      return n1->get_node_id() < n2->get_node_id();
-    };
-    noninductive.sort(compare);
-    noninductive.unique();
-    inductive.sort(compare);
-    inductive.unique();
-  }
-
   // Returns true if this MemoryAddrSources object is independent of other, as
   // defined above.
-  bool is_independent_of(const MemoryAddrSources& other, bool first=false) {
+  bool is_independent_of(const MemoryAddrSources& other,
+                         bool first = false) const {
     bool is_independent = (noninductive == other.noninductive);
     // The first one may not have an IndexAdd node (since it uses the initial
     // value of the induction variable), so we only need to compare the
@@ -83,9 +76,38 @@ class MemoryAddrSources {
     return is_independent;
   }
 
+  // An arbitrary total order, so that equal sources can be interned.
+  bool operator<(const MemoryAddrSources& other) const {
+    if (noninductive != other.noninductive)
+      return noninductive < other.noninductive;
+    return inductive < other.inductive;
+  }
+
  private:
-  std::list<ExecNode*> noninductive;
-  std::list<ExecNode*> inductive;
+  typedef std::vector<ExecNode*> NodeSet;
+
+  static bool compare(const ExecNode* n1, const ExecNode* n2) {
+    return n1->get_node_id() < n2->get_node_id();
+  }
+
+  static void insert(NodeSet& set, ExecNode* node) {
+    auto it = std::lower_bound(set.begin(), set.end(), node, compare);
+    if (it == set.end() || *it != node)
+      set.insert(it, node);
+  }
+
+  static void merge(NodeSet& set, const NodeSet& other) {
+    if (other.empty())
+      return;
+    NodeSet merged;
+    merged.reserve(set.size() + other.size());
+    std::set_union(set.begin(), set.end(), other.begin(), other.end(),
+                   std::back_inserter(merged), compare);
+    set.swap(merged);
+  }
+
+  NodeSet noninductive;
+  NodeSet inductive;
 };
 
 class MemoryAmbiguationOpt : public BaseAladdinOpt {
@@ -93,18 +115,37 @@ class MemoryAmbiguationOpt : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 
  protected:
   // Locate all sources of a GEP node.
   //
   // Starting from @current_node (which is initially the GEP node), recursively
   // examine each parent. Within the function @current_func, record all parents
-  // that are either loads and index adds and return a MemoryAddrSources object.
-  // If no such parents are found, return the oldest ancestor that is a
-  // non-inductive compute op.
-  MemoryAddrSources findMemoryAddrSources(ExecNode* current_node,
-                                          SrcTypes::Function* current_func,
-                                          EdgeNameMap& edge_to_parid);
+  // that are either loads and index adds and return the id of their
+  // MemoryAddrSources object. If no such parents are found, return the oldest
+  // ancestor that is a non-inductive compute op.
+  //
+  // Address computations are often shared by many memory operations, so the
+  // sources of every node are computed only once per pass. The function of a
+  // node never changes along the way, so the node id is enough of a key.
+  unsigned findMemoryAddrSources(ExecNode* current_node,
+                                 SrcTypes::Function* current_func,
+                                 EdgeNameMap& edge_to_parid);
+
+  // Return the id of the interned copy of @sources.
+  unsigned internSources(MemoryAddrSources&& sources);
+
+  const MemoryAddrSources& getSources(unsigned id) const {
+    return *source_sets[id];
+  }
+
+  // Every distinct MemoryAddrSources found in this pass, and its id.
+  std::map<MemoryAddrSources, unsigned> source_set_ids;
+  // The keys of source_set_ids, by id.
+  std::vector<const MemoryAddrSources*> source_sets;
+  // The sources of each node that has been examined, by node id.
+  std::unordered_map<unsigned, unsigned> node_sources;
 };
 
 #endif
@@ -15,20 +15,23 @@ std::string PerLoopPipelining::getCenteredName(size_t size) {
   return "      Per Loop Pipelining      ";
 }
 
+unsigned PerLoopPipelining::getConfigFields() const {
+  return UserConfigParams::Pipeline | UserConfigParams::GlobalPipelining |
+         UserConfigParams::ReadyMode;
+}
+
 // This does a DFS search of the loop tree to find all the loops to be
 // pipelined. For every loop, it checks if any of its children loops needs to be
 // pipelined and store those in a list, which is passed to the pipelining
 // algorithm. By doing this, we ensure no pipelining occurs across the parent
 // loop's boundaries.
 void PerLoopPipelining::findAndPipelineLoops(
-    LoopIteration* loop,
-    std::set<Edge>& to_remove_edges,
-    std::vector<NewEdge>& to_add_edges) {
+    LoopIteration* loop, GraphDelta& delta) {
   if (loop->children.size() > 0) {
     std::unordered_map<SrcTypes::UniqueLabel, std::list<LoopIteration*>>
         pipelined_loops;
     for (auto& child : loop->children) {
-      findAndPipelineLoops(child, to_remove_edges, to_add_edges);
+      findAndPipelineLoops(child, delta);
       if (user_params.pipeline.find(*child->label) !=
           user_params.pipeline.end()) {
         pipelined_loops[*child->label].push_back(child);
@@ -36,7 +39,7 @@ void PerLoopPipelining::findAndPipelineLoops(
       }
     }
     for (auto& loop_list: pipelined_loops)
-      optimize(loop_list.second, to_remove_edges, to_add_edges);
+      optimize(loop_list.second, delta);
   }
 }
 
@@ -52,20 +55,14 @@ void PerLoopPipelining::optimize() {
     return;
   }
 
-  std::set<Edge> to_remove_edges;
-  std::vector<NewEdge> to_add_edges;
-
-  findAndPipelineLoops(
-      program.loop_info.getRootNode(), to_remove_edges, to_add_edges);
-
-  updateGraphWithNewEdges(to_add_edges);
-  updateGraphWithIsolatedEdges(to_remove_edges);
+  GraphDelta delta;
+  findAndPipelineLoops(program.loop_info.getRootNode(), delta);
+  updateGraph(delta);
   cleanLeafNodes();
 }
 
-void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
-                                 std::set<Edge>& to_remove_edges,
-                                 std::vector<NewEdge>& to_add_edges) {
+void PerLoopPipelining::optimize(
+    std::list<LoopIteration*>& loops, GraphDelta& delta) {
   EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
 
   // Strategy: for every loop I want to pipeline:
@@ -90,7 +87,7 @@ void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
     while (node_id < next_bound_node_id) {
       ExecNode* next_node = it->second;
       is_isolated = (!next_node->has_vertex() ||
-                     boost::degree(next_node->get_vertex(), graph) == 0 ||
+                     program.getDegree(next_node) == 0 ||
                      next_node->is_branch_op());
       if (!is_isolated) {
         // Use the next bound node as the key, not the current boundary node,
@@ -124,7 +121,7 @@ void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
     }
 
     if (!doesEdgeExist(prev_first_node, first_node)) {
-      to_add_edges.push_back({ prev_first_node, first_node, CONTROL_EDGE });
+      delta.addEdge(prev_first_node, first_node, CONTROL_EDGE);
     }
     // Identify all nodes in the body of the previous iteration that succeed
     // the FNIN of that iteration. If any of these nodes have a control
@@ -146,13 +143,22 @@ void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
         // TODO: What is the meaning of EDGE = 1? It gets used in Load/Store
         // Buffer.
         if (!doesEdgeExist(first_node, child_node))
-          to_add_edges.push_back({ first_node, child_node, 1 });
+          delta.addEdge(first_node, child_node, 1);
       }
     }
+    barriers.forEachChild(
+        prev_branch_node->get_node_id(), [&](unsigned child_id) {
+          ExecNode* child_node = exec_nodes.at(child_id);
+          if (*child_node >= *first_node &&
+              !doesEdgeExist(first_node, child_node))
+            delta.addEdge(first_node, child_node, 1);
+        });
 
     // Pipelining causes the first non-isolated nodes to be the real
     // iteration bounds (rather than branch nodes), so any dependences of
-    // FNINs must be converted to control edges.
+    // FNINs are removed. (They were once meant to become control edges, but
+    // those were only ever added while the original edges still existed, so
+    // they never were.)
     assert(first_node->has_vertex());
     in_edge_iter in_edge_it, in_edge_end;
     for (boost::tie(in_edge_it, in_edge_end) =
@@ -164,8 +170,7 @@ void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
       // TODO: Ignore branch nodes since they are typically loop bounds, but
       // what if we have control flow with a loop?
       if (!parent_node->is_branch_op()) {
-        to_remove_edges.insert(*in_edge_it);
-        to_add_edges.push_back({ parent_node, first_node, CONTROL_EDGE });
+        delta.removeEdge(*in_edge_it, graph);
       }
     }
 
@@ -183,8 +188,14 @@ void PerLoopPipelining::optimize(std::list<LoopIteration*>& loops,
         continue;
       if (edge_to_parid[*out_edge_it] != CONTROL_EDGE)
         continue;
-      to_remove_edges.insert(*out_edge_it);
+      delta.removeEdge(*out_edge_it, graph);
     }
+    barriers.forEachChild(
+        prev_branch_node->get_node_id(), [&](unsigned child_id) {
+          if (!exec_nodes.at(child_id)->is_call_op())
+            delta.removeEdge(program, prev_branch_node->get_node_id(),
+                             child_id);
+        });
     prev_branch_node = branch_node;
     prev_first_node = first_node;
   }
@@ -6,14 +6,13 @@
 class PerLoopPipelining : public BaseAladdinOpt {
  public:
   using BaseAladdinOpt::BaseAladdinOpt;
-  void findAndPipelineLoops(LoopIteration* loop,
-                            std::set<Edge>& to_remove_edges,
-                            std::vector<NewEdge>& to_add_edges);
+  void findAndPipelineLoops(
+      LoopIteration* loop, GraphDelta& delta);
   virtual void optimize();
-  void optimize(std::list<LoopIteration*>& loops,
-                std::set<Edge>& to_remove_edges,
-                std::vector<NewEdge>& to_add_edges);
+  void optimize(
+      std::list<LoopIteration*>& loops, GraphDelta& delta);
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 };
 
 #endif
@@ -18,10 +18,13 @@ std::string RegLoadStoreFusion::getCenteredName(size_t size) {
   return "  Fuse register loads/stores   ";
 }
 
+unsigned RegLoadStoreFusion::getConfigFields() const {
+  return UserConfigParams::PartitionLayout | UserConfigParams::ReadyMode;
+}
+
 void RegLoadStoreFusion::optimize() {
 
-  std::vector<NewEdge> to_add_edges;
-  std::set<Edge> to_remove_edges;
+  GraphDelta delta;
   EdgeNameMap edge_to_parid = get(boost::edge_name, graph);
 
   for (auto& node_pair : exec_nodes) {
@@ -48,8 +51,9 @@ void RegLoadStoreFusion::optimize() {
         if (target_node->is_load_op())
           continue;
 
-        to_remove_edges.insert(*out_edge_it);
-        to_add_edges.push_back({ node, target_node, REGISTER_EDGE });
+        // Removing and adding the edge back changes its type.
+        delta.removeEdge(*out_edge_it, graph);
+        delta.addEdge(node, target_node, REGISTER_EDGE);
       }
     } else if (node->is_store_op()) {
       Vertex store_vertex = node->get_vertex();
@@ -66,13 +70,12 @@ void RegLoadStoreFusion::optimize() {
         if (source_node->is_store_op())
           continue;
 
-        to_remove_edges.insert(*in_edge_it);
-        to_add_edges.push_back({ source_node, node, REGISTER_EDGE });
+        delta.removeEdge(*in_edge_it, graph);
+        delta.addEdge(source_node, node, REGISTER_EDGE);
       }
     }
   }
 
-  updateGraphWithIsolatedEdges(to_remove_edges);
-  updateGraphWithNewEdges(to_add_edges);
+  updateGraph(delta);
   cleanLeafNodes();
 }
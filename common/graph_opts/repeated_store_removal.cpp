@@ -6,6 +6,10 @@ std::string RepeatedStoreRemoval::getCenteredName(size_t size) {
   return "    Remove Repeated Stores     ";
 }
 
+unsigned RepeatedStoreRemoval::getConfigFields() const {
+  return UserConfigParams::Unrolling | UserConfigParams::ReadyMode;
+}
+
 void RepeatedStoreRemoval::optimize() {
   if (!user_params.unrolling.size() && loop_bounds.size() <= 2)
     return;
@@ -16,21 +20,18 @@ void RepeatedStoreRemoval::optimize() {
   if (exec_nodes.empty() == 0)
     return;
 
-  int node_id = exec_nodes.size() - 1;
-  auto bound_it = loop_bounds.end();
-  bound_it--;
-  bound_it--;
-  while (node_id >= 0) {
+  // Stores before the first loop bound are never removed.
+  const LoopRegions& regions = program.getLoopRegions();
+  for (unsigned region = regions.size(); region-- > 1;) {
     std::unordered_map<unsigned, int> address_store_map;
-
-    while (node_id >= (int)bound_it->node_id && node_id >= 0) {
+    auto& region_nodes = regions.getNodes(region, LoopRegions::MemoryOps);
+    for (auto id_it = region_nodes.rbegin(); id_it != region_nodes.rend();
+         ++id_it) {
+      unsigned node_id = *id_it;
       ExecNode* node = exec_nodes.at(node_id);
-      if (!node->has_vertex() ||
-          boost::degree(node->get_vertex(), graph) == 0 ||
-          !node->is_store_op()) {
-        --node_id;
+      if (!node->has_vertex() || program.getDegree(node) == 0 ||
+          !node->is_store_op())
         continue;
-      }
       Addr node_address = node->get_mem_access()->vaddr;
       auto addr_it = address_store_map.find(node_address);
 
@@ -40,7 +41,7 @@ void RepeatedStoreRemoval::optimize() {
         // remove this store, unless it is a dynamic store which cannot be
         // statically disambiguated.
         if (!node->is_dynamic_mem_op()) {
-          if (boost::out_degree(node->get_vertex(), graph) == 0) {
+          if (program.getOutDegree(node) == 0) {
             node->set_microop(LLVM_IR_SilentStore);
             removed_stores++;
           } else {
@@ -60,12 +61,7 @@ void RepeatedStoreRemoval::optimize() {
           }
         }
       }
-      --node_id;
     }
-
-    if (bound_it == loop_bounds.begin())
-      break;
-    --bound_it;
   }
   cleanLeafNodes();
 }
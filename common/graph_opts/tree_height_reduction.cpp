@@ -6,6 +6,10 @@ std::string TreeHeightReduction::getCenteredName(size_t size) {
   return "     Tree Height Reduction     ";
 }
 
+unsigned TreeHeightReduction::getConfigFields() const {
+  return UserConfigParams::ReadyMode;
+}
+
 void TreeHeightReduction::optimize() {
   if (loop_bounds.size() <= 2)
     return;
@@ -16,41 +20,38 @@ void TreeHeightReduction::optimize() {
   end_node_id = (--exec_nodes.end())->first + 1;
 
   std::map<unsigned, bool> updated;
-  std::map<unsigned, int> bound_region;
-  for (auto node_pair : exec_nodes) {
+  for (auto node_pair : exec_nodes)
     updated[node_pair.first] = false;
-    bound_region[node_pair.first] = 0;
-  }
 
-  int region_id = 0;
-  auto node_it = exec_nodes.begin();
-  unsigned node_id = node_it->first;
-  auto bound_it = loop_bounds.begin();
-  while (node_id <= bound_it->node_id && node_it != exec_nodes.end()) {
-    bound_region.at(node_id) = region_id;
-    if (node_id == bound_it->node_id) {
-      region_id++;
-      bound_it++;
-      if (bound_it == loop_bounds.end())
-        break;
-    }
-    node_it++;
-    node_id = node_it->first;
-  }
+  // Here a loop bound belongs to the region that it closes rather than the
+  // one that it starts.
+  const LoopRegions& regions = program.getLoopRegions();
+  auto bound_region = [&](unsigned node_id) {
+    unsigned region = regions.getRegion(node_id);
+    if (region == LoopRegions::NONE)
+      return 0;
+    return int(regions.isBound(node_id) ? region - 1 : region);
+  };
 
-  std::set<Edge> to_remove_edges;
-  std::vector<NewEdge> to_add_edges;
+  GraphDelta delta;
 
   // nodes with no outgoing edges to first (bottom nodes first)
-  for (auto node_it = exec_nodes.rbegin(); node_it != exec_nodes.rend();
-       ++node_it) {
-    ExecNode* node = node_it->second;
-    if (!node->has_vertex() || boost::degree(node->get_vertex(), graph) == 0 ||
+  std::vector<unsigned> associative_nodes;
+  for (unsigned region = 0; region < regions.size(); region++) {
+    auto& region_nodes = regions.getNodes(region, LoopRegions::AssociativeOps);
+    associative_nodes.insert(
+        associative_nodes.end(), region_nodes.begin(), region_nodes.end());
+  }
+  for (auto id_it = associative_nodes.rbegin();
+       id_it != associative_nodes.rend();
+       ++id_it) {
+    ExecNode* node = exec_nodes.at(*id_it);
+    if (!node->has_vertex() || program.getDegree(node) == 0 ||
         updated.at(node->get_node_id()) || !node->is_associative())
       continue;
     unsigned node_id = node->get_node_id();
     updated.at(node_id) = 1;
-    int node_region = bound_region.at(node_id);
+    int node_region = bound_region(node_id);
 
     std::list<ExecNode*> nodes;
     std::vector<Edge> tmp_remove_edges;
@@ -87,7 +88,7 @@ void TreeHeightReduction::optimize() {
 
             Edge curr_edge = *in_edge_it;
             tmp_remove_edges.push_back(curr_edge);
-            int parent_region = bound_region.at(parent_id);
+            int parent_region = bound_region(parent_id);
             if (parent_region == node_region) {
               updated.at(parent_id) = 1;
               if (!parent_node->is_associative())
@@ -128,7 +129,7 @@ void TreeHeightReduction::optimize() {
     for (auto it = tmp_remove_edges.begin(), E = tmp_remove_edges.end();
          it != E;
          it++)
-      to_remove_edges.insert(*it);
+      delta.removeEdge(*it, graph);
 
     std::map<ExecNode*, unsigned> rank_map;
     auto leaf_it = leaves.begin();
@@ -155,8 +156,8 @@ void TreeHeightReduction::optimize() {
       // TODO: Is this at all possible...?
       assert((node1->get_node_id() != end_node_id) &&
              (node2->get_node_id() != end_node_id));
-      to_add_edges.push_back({ node1, *new_node_it, 1 });
-      to_add_edges.push_back({ node2, *new_node_it, 1 });
+      delta.addEdge(node1, *new_node_it, 1);
+      delta.addEdge(node2, *new_node_it, 1);
 
       // place the new node in the map, remove the two old nodes
       rank_map[*new_node_it] = std::max(rank_map[node1], rank_map[node2]) + 1;
@@ -165,12 +166,10 @@ void TreeHeightReduction::optimize() {
       ++new_node_it;
     }
   }
-  /*For tree reduction, we always remove edges first, then add edges. The reason
-   * is that it's possible that we are adding the same edges as the edges that
-   * we want to remove. Doing adding edges first then removing edges could lead
-   * to losing dependences.*/
-  updateGraphWithIsolatedEdges(to_remove_edges);
-  updateGraphWithNewEdges(to_add_edges);
+  /*For tree reduction, it's possible that we are adding the same edges as the
+   * edges that we want to remove. The delta applies removals before additions,
+   * so these dependences are kept.*/
+  updateGraph(delta);
   cleanLeafNodes();
 }
 
@@ -8,6 +8,7 @@ class TreeHeightReduction : public BaseAladdinOpt {
   using BaseAladdinOpt::BaseAladdinOpt;
   virtual void optimize();
   virtual std::string getCenteredName(size_t size);
+  virtual unsigned getConfigFields() const;
 
  protected:
   void findMinRankNodes(ExecNode** node1,
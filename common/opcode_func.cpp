@@ -1,6 +1,91 @@
 #include <string>
 #include "opcode_func.h"
 
+namespace {
+
+constexpr uint32_t traits_if(bool condition, uint32_t traits) {
+  return condition ? traits : 0;
+}
+
+// Constexpr functions can only have a single return statement in C++11.
+constexpr uint32_t compute_opcode_traits(unsigned op) {
+  return traits_if(op == LLVM_IR_Load, OPCODE_LOAD | OPCODE_MEMORY) |
+         traits_if(op == LLVM_IR_Store, OPCODE_STORE | OPCODE_MEMORY) |
+         traits_if(op == LLVM_IR_DMALoad || op == LLVM_IR_DMAStore ||
+                       op == LLVM_IR_DMAFence || op == LLVM_IR_SetReadyBits ||
+                       op == LLVM_IR_HostLoad || op == LLVM_IR_HostStore,
+                   OPCODE_HOST_MEMORY) |
+         traits_if(op == LLVM_IR_Add || op == LLVM_IR_Sub,
+                   OPCODE_COMPUTE | OPCODE_INT_ADD | OPCODE_ASSOCIATIVE) |
+         traits_if(op == LLVM_IR_Mul || op == LLVM_IR_UDiv ||
+                       op == LLVM_IR_SDiv || op == LLVM_IR_URem ||
+                       op == LLVM_IR_SRem,
+                   OPCODE_COMPUTE | OPCODE_INT_MUL) |
+         traits_if(op == LLVM_IR_Shl || op == LLVM_IR_LShr ||
+                       op == LLVM_IR_AShr,
+                   OPCODE_COMPUTE | OPCODE_SHIFTER) |
+         traits_if(op == LLVM_IR_And || op == LLVM_IR_Or || op == LLVM_IR_Xor,
+                   OPCODE_COMPUTE | OPCODE_BIT) |
+         traits_if(op == LLVM_IR_IndexAdd, OPCODE_COMPUTE) |
+         traits_if(op == LLVM_IR_FAdd || op == LLVM_IR_FSub,
+                   OPCODE_COMPUTE | OPCODE_FP | OPCODE_FP_ADD |
+                       OPCODE_MULTICYCLE | OPCODE_ASSOCIATIVE) |
+         traits_if(op == LLVM_IR_FMul,
+                   OPCODE_COMPUTE | OPCODE_FP | OPCODE_FP_MUL |
+                       OPCODE_MULTICYCLE) |
+         traits_if(op == LLVM_IR_FDiv,
+                   OPCODE_COMPUTE | OPCODE_FP | OPCODE_FP_MUL | OPCODE_FP_DIV |
+                       OPCODE_MULTICYCLE) |
+         traits_if(op == LLVM_IR_FRem,
+                   OPCODE_COMPUTE | OPCODE_FP | OPCODE_FP_MUL |
+                       OPCODE_MULTICYCLE) |
+         traits_if(op == LLVM_IR_SpecialMathOp,
+                   OPCODE_SPECIAL_MATH | OPCODE_MULTICYCLE) |
+         traits_if(op == LLVM_IR_Call,
+                   OPCODE_CALL | OPCODE_BRANCH | OPCODE_CONTROL) |
+         traits_if(op == LLVM_IR_Br || op == LLVM_IR_Switch,
+                   OPCODE_BRANCH | OPCODE_CONTROL) |
+         traits_if(op == LLVM_IR_PHI, OPCODE_CONTROL) |
+         traits_if(op == LLVM_IR_Trunc || op == LLVM_IR_ZExt ||
+                       op == LLVM_IR_SExt || op == LLVM_IR_FPToUI ||
+                       op == LLVM_IR_FPToSI || op == LLVM_IR_UIToFP ||
+                       op == LLVM_IR_SIToFP || op == LLVM_IR_FPTrunc ||
+                       op == LLVM_IR_FPExt || op == LLVM_IR_PtrToInt ||
+                       op == LLVM_IR_IntToPtr || op == LLVM_IR_BitCast ||
+                       op == LLVM_IR_AddrSpaceCast,
+                   OPCODE_CONVERT);
+}
+
+static_assert(compute_opcode_traits(LLVM_IR_FDiv) & OPCODE_MULTICYCLE,
+              "Floating point divides must take multiple cycles.");
+static_assert(compute_opcode_traits(LLVM_IR_Move) == 0,
+              "Moves must not belong to any class of opcodes.");
+
+}  // namespace
+
+// clang-format off
+#define OPCODE_TRAITS_4(op)                                                    \
+  compute_opcode_traits(op), compute_opcode_traits(op + 1),                    \
+  compute_opcode_traits(op + 2), compute_opcode_traits(op + 3)
+#define OPCODE_TRAITS_16(op)                                                   \
+  OPCODE_TRAITS_4(op), OPCODE_TRAITS_4(op + 4), OPCODE_TRAITS_4(op + 8),       \
+  OPCODE_TRAITS_4(op + 12)
+#define OPCODE_TRAITS_64(op)                                                   \
+  OPCODE_TRAITS_16(op), OPCODE_TRAITS_16(op + 16), OPCODE_TRAITS_16(op + 32),  \
+  OPCODE_TRAITS_16(op + 48)
+
+// Every entry is a constant expression, so the table is filled in at compile
+// time rather than by a static initializer.
+const uint32_t opcode_traits_table[256] = {
+  OPCODE_TRAITS_64(0), OPCODE_TRAITS_64(64), OPCODE_TRAITS_64(128),
+  OPCODE_TRAITS_64(192)
+};
+// clang-format on
+
+#undef OPCODE_TRAITS_64
+#undef OPCODE_TRAITS_16
+#undef OPCODE_TRAITS_4
+
 std::string opcode_name(uint8_t opcode) {
 #define LLVM_IR_OPCODE_TO_NAME(Opcode)                                         \
   case LLVM_IR_##Opcode:                                                       \
@@ -3,6 +3,9 @@
 #ifndef OPCODE_FUNC_H
 #define OPCODE_FUNC_H
 
+#include <cstdint>
+#include <string>
+
 #ifndef LLVM_VERSION
 #error "Must define LLVM_VERSION!"
 #elif LLVM_VERSION == 34
@@ -13,6 +16,47 @@
 #error "Only LLVM-3.4 and LLVM-6.0 are supported!"
 #endif
 
+// Classes of opcodes, as bits of the traits of an opcode.
+enum OpcodeTrait {
+  OPCODE_LOAD = 1 << 0,
+  OPCODE_STORE = 1 << 1,
+  // Loads and stores of local memory.
+  OPCODE_MEMORY = 1 << 2,
+  // DMA, ready bits and host memory accesses.
+  OPCODE_HOST_MEMORY = 1 << 3,
+  // Integer and floating point arithmetic, shifts and bitwise operations.
+  OPCODE_COMPUTE = 1 << 4,
+  OPCODE_INT_ADD = 1 << 5,
+  // Integer multiplies, divides and remainders.
+  OPCODE_INT_MUL = 1 << 6,
+  OPCODE_SHIFTER = 1 << 7,
+  OPCODE_BIT = 1 << 8,
+  OPCODE_FP = 1 << 9,
+  OPCODE_FP_ADD = 1 << 10,
+  // Floating point multiplies, divides and remainders.
+  OPCODE_FP_MUL = 1 << 11,
+  OPCODE_FP_DIV = 1 << 12,
+  OPCODE_SPECIAL_MATH = 1 << 13,
+  // Floating point and special math operations, which take several cycles.
+  OPCODE_MULTICYCLE = 1 << 14,
+  OPCODE_ASSOCIATIVE = 1 << 15,
+  OPCODE_CALL = 1 << 16,
+  // Branches, switches and calls.
+  OPCODE_BRANCH = 1 << 17,
+  // Branches and phis.
+  OPCODE_CONTROL = 1 << 18,
+  OPCODE_CONVERT = 1 << 19,
+};
+
+// The traits of every opcode, generated at compile time from the opcodes of
+// the LLVM version being built.
+extern const uint32_t opcode_traits_table[256];
+
+// Returns the OpcodeTrait bits of the opcode.
+inline uint32_t opcode_traits(uint8_t opcode) {
+  return opcode_traits_table[opcode];
+}
+
 // Returns the name of the opcode.
 std::string opcode_name(uint8_t opcode);
 
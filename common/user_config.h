@@ -3,6 +3,8 @@
 
 #include <iostream>
 
+#include <boost/functional/hash.hpp>
+
 #include "AladdinExceptions.h"
 #include "ExecNode.h"
 #include "MemoryType.h"
@@ -21,11 +23,146 @@ struct PartitionEntry {
   Addr base_addr;
 };
 
+// Parameters of the memory system outside the accelerator, as modeled by
+// standalone Aladdin (see MemorySystemModel). Latencies are in accelerator
+// cycles and sizes in bytes. The defaults complete every DMA transfer in the
+// cycle it is issued, which is how standalone Aladdin has always treated DMA.
+struct MemorySystemParams {
+  MemorySystemParams()
+      : cache_size(16384), cache_line_size(64), cache_assoc(4),
+        cache_hit_latency(1), cache_miss_latency(100), cache_mshrs(16),
+        cache_bandwidth(4), tlb_entries(64), tlb_hit_latency(0),
+        tlb_miss_latency(20), page_size(4096), acp_latency(20),
+        dma_setup_latency(0), dma_bandwidth(0), dma_page_latency(0),
+        cache_line_flush_latency(0), cache_line_invalidate_latency(0) {}
+
+  // Set the parameter called @name to @value. Returns false if there is no
+  // such parameter.
+  bool set(const std::string& name, unsigned value) {
+    std::pair<const char*, unsigned*> params[] = {
+      { "cache_size", &cache_size },
+      { "cache_line_size", &cache_line_size },
+      { "cache_assoc", &cache_assoc },
+      { "cache_hit_latency", &cache_hit_latency },
+      { "cache_miss_latency", &cache_miss_latency },
+      { "cache_mshrs", &cache_mshrs },
+      { "cache_bandwidth", &cache_bandwidth },
+      { "tlb_entries", &tlb_entries },
+      { "tlb_hit_latency", &tlb_hit_latency },
+      { "tlb_miss_latency", &tlb_miss_latency },
+      { "page_size", &page_size },
+      { "acp_latency", &acp_latency },
+      { "dma_setup_latency", &dma_setup_latency },
+      { "dma_bandwidth", &dma_bandwidth },
+      { "dma_page_latency", &dma_page_latency },
+      { "cache_line_flush_latency", &cache_line_flush_latency },
+      { "cache_line_invalidate_latency", &cache_line_invalidate_latency },
+    };
+    for (auto& param : params) {
+      if (name == param.first) {
+        *param.second = value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  unsigned cache_size;
+  unsigned cache_line_size;
+  unsigned cache_assoc;
+  unsigned cache_hit_latency;
+  // Cycles to fill a line from main memory.
+  unsigned cache_miss_latency;
+  unsigned cache_mshrs;
+  // Cache and ACP requests issued per cycle. Zero means unlimited.
+  unsigned cache_bandwidth;
+  // Zero entries means that addresses are not translated.
+  unsigned tlb_entries;
+  unsigned tlb_hit_latency;
+  unsigned tlb_miss_latency;
+  unsigned page_size;
+  // Round trip of an ACP access to the coherent host cache.
+  unsigned acp_latency;
+  // Fixed cost of every DMA transfer.
+  unsigned dma_setup_latency;
+  // Bytes per cycle. Zero means unlimited.
+  unsigned dma_bandwidth;
+  // Cost of each page-sized request that a DMA transfer is split into.
+  unsigned dma_page_latency;
+  // Per cache line of the host buffer: flushed before a DMA load, and
+  // invalidated before a DMA store.
+  unsigned cache_line_flush_latency;
+  unsigned cache_line_invalidate_latency;
+};
+
 class UserConfigParams {
  public:
+  // Groups of configuration fields. Graph optimizations declare which of them
+  // they read as a bitmask of these.
+  enum Field {
+    Unrolling = 1 << 0,
+    Pipeline = 1 << 1,
+    GlobalPipelining = 1 << 2,
+    ReadyMode = 1 << 3,
+    CycleTime = 1 << 4,
+    ScratchpadPorts = 1 << 5,
+    // Everything about the arrays except their partition factors.
+    PartitionLayout = 1 << 6,
+    PartitionFactors = 1 << 7,
+    AllFields = (1 << 8) - 1,
+  };
+
   UserConfigParams()
       : cycle_time(1), ready_mode(false), scratchpad_ports(1),
-        global_pipelining(false) {}
+        global_pipelining(false), parse_threads(1), timing_only(false) {}
+
+  // Hash the values of the groups of fields in the bitmask @fields.
+  //
+  // Two configurations that agree on these fields hash to the same value. The
+  // maps and sets are unordered, so their entries are combined in an order
+  // independent way.
+  size_t hash(unsigned fields) const {
+    size_t seed = fields;
+    if (fields & Unrolling) {
+      size_t entries = 0;
+      for (auto& unroll : unrolling)
+        entries += hashLabel(unroll.first) * 31 + unroll.second;
+      boost::hash_combine(seed, entries);
+    }
+    if (fields & Pipeline) {
+      size_t entries = 0;
+      for (auto& label : pipeline)
+        entries += hashLabel(label);
+      boost::hash_combine(seed, entries);
+    }
+    if (fields & GlobalPipelining)
+      boost::hash_combine(seed, global_pipelining);
+    if (fields & ReadyMode)
+      boost::hash_combine(seed, ready_mode);
+    if (fields & CycleTime)
+      boost::hash_combine(seed, cycle_time);
+    if (fields & ScratchpadPorts)
+      boost::hash_combine(seed, scratchpad_ports);
+    if (fields & (PartitionLayout | PartitionFactors)) {
+      size_t entries = 0;
+      for (auto& part : partition) {
+        size_t entry = boost::hash_value(part.first);
+        const PartitionEntry& config = part.second;
+        if (fields & PartitionLayout) {
+          boost::hash_combine(entry, (int)config.memory_type);
+          boost::hash_combine(entry, (int)config.partition_type);
+          boost::hash_combine(entry, config.array_size);
+          boost::hash_combine(entry, config.wordsize);
+          boost::hash_combine(entry, config.base_addr);
+        }
+        if (fields & PartitionFactors)
+          boost::hash_combine(entry, config.part_factor);
+        entries += entry;
+      }
+      boost::hash_combine(seed, entries);
+    }
+    return seed;
+  }
 
   partition_config_t::const_iterator getArrayConfig(Addr addr) const {
     auto part_it = partition.begin();
@@ -155,8 +292,25 @@ class UserConfigParams {
   bool ready_mode;
   unsigned scratchpad_ports;
   bool global_pipelining;
+  // Number of threads used to split trace lines into fields while building the
+  // DDDG. This does not change the graph, so it is not part of the hash.
+  unsigned parse_threads;
+  // If true, the values loaded and stored by the trace are not kept: memory
+  // nodes only record their address and size, and scratchpad partitions hold
+  // no data. This takes effect when the trace is parsed and does not change
+  // the timing or power, so it is not part of the hash either.
+  bool timing_only;
+  // Only used to schedule nodes, never by the graph optimizations, so this is
+  // not part of the hash.
+  MemorySystemParams mem_system;
 
  protected:
+  static size_t hashLabel(const SrcTypes::UniqueLabel& label) {
+    size_t seed = std::hash<SrcTypes::UniqueLabel>()(label);
+    boost::hash_combine(seed, label.get_line_number());
+    return seed;
+  }
+
   // Returns true if the ranges defined by [base_0, end_0) and [base_1, end_1)
   // overlap.
   bool rangesOverlap(Addr base_0, Addr end_0, Addr base_1, Addr end_1) {
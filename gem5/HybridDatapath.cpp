@@ -75,6 +75,9 @@ HybridDatapath::HybridDatapath(const HybridDatapathParams* params)
 #endif
   float cycle_time = params->cycleTime;
   BaseDatapath::user_params.cycle_time = cycle_time;
+  if (BaseDatapath::user_params.timing_only)
+    fatal("timing_only is only supported by standalone Aladdin, since the "
+          "memory system needs the values loaded and stored by the trace.\n");
   datapath_name = params->acceleratorName;
   cache_queue.initStats(datapath_name + ".cache_queue");
   system->registerAccelerator(accelerator_id, this);
@@ -265,22 +268,22 @@ void HybridDatapath::stepExecutingQueue() {
         fatal(e.what());
       }
       switch (type) {
-        case Register:
+        case MemoryOpType::Register:
           op_satisfied = handleRegisterMemoryOp(node);
           break;
-        case Scratchpad:
+        case MemoryOpType::Scratchpad:
           op_satisfied = handleSpadMemoryOp(node);
           break;
-        case Cache:
+        case MemoryOpType::Cache:
           op_satisfied = handleCacheMemoryOp(node);
           break;
-        case Dma:
+        case MemoryOpType::Dma:
           op_satisfied = handleDmaMemoryOp(node);
           break;
-        case ReadyBits:
+        case MemoryOpType::ReadyBits:
           op_satisfied = handleReadyBitAccess(node);
           break;
-        case ACP:
+        case MemoryOpType::ACP:
           op_satisfied = handleAcpMemoryOp(node);
           break;
         default:
@@ -400,53 +403,6 @@ void HybridDatapath::exitSimulation() {
   // invocation.
 }
 
-MemoryOpType HybridDatapath::getMemoryOpType(const std::string& array_label) {
-  auto it = user_params.partition.find(array_label);
-  if (it != user_params.partition.end()) {
-    PartitionEntry entry = it->second;
-    switch (entry.memory_type) {
-      case spad:
-        return Scratchpad;
-      case reg:
-        return Register;
-      case dma:
-        return Dma;
-      case acp:
-        return ACP;
-      case cache:
-        return Cache;
-      default:
-        throw IllegalHostMemoryAccessException(array_label);
-    }
-  } else {
-    throw UnknownArrayException(array_label);
-  }
-  return NumMemoryOpTypes;
-}
-
-MemoryOpType HybridDatapath::getMemoryOpType(ExecNode* node) {
-  if (node->is_dma_load() || node->is_dma_store() || node->is_dma_fence())
-    return Dma;
-  if (node->is_set_ready_bits())
-    return ReadyBits;
-
-  if (node->is_host_mem_op()) {
-    HostMemAccess* mem_access = node->get_host_mem_access();
-    bool isLoad = node->is_host_load();
-    const std::string& array_label = isLoad ? mem_access->src_var->get_name()
-                                            : mem_access->dst_var->get_name();
-    return getMemoryOpType(array_label);
-  } else if (node->is_memory_op()) {
-    const std::string& array_label = node->get_array_label();
-    auto it = user_params.partition.find(array_label);
-    return getMemoryOpType(array_label);
-  } else {
-    fatal("Unexpected memory op! It should either be a host memory op or a "
-          "local memory op.\n");
-  }
-  return NumMemoryOpTypes;
-}
-
 bool HybridDatapath::handleRegisterMemoryOp(ExecNode* node) {
   markNodeStarted(node);
   std::string reg = node->get_array_label();
@@ -597,7 +553,7 @@ bool HybridDatapath::handleCacheMemoryOp(ExecNode* node) {
             node_id);
     return false;
   } else {
-    entry->type = Cache;
+    entry->type = MemoryOpType::Cache;
   }
 
   // At this point, we have a valid entry.
@@ -681,7 +637,9 @@ MemoryQueueEntry* HybridDatapath::createAndQueueAcpEntry(
   MemoryQueueEntry* entry = cache_queue.findMatch(vaddr, isLoad);
   if (!entry) {
     entry = cache_queue.allocateEntry(vaddr, size, isLoad);
-    entry->type = ACP;
+    if (!entry)
+      return nullptr;
+    entry->type = MemoryOpType::ACP;
     if (use_acp_cache) {
       // If we have the middle cache, we don't need to handle ownership requests
       // ourselves. Just go ahead and issue the read or write.
@@ -815,21 +773,29 @@ bool HybridDatapath::handleAcpMemoryOp(ExecNode* node) {
   // the normal Load/Store.
   if (node->is_host_mem_op()) {
     // This is a chunk-level ACP access.
-    if (inflight_burst_nodes.find(node_id) == inflight_burst_nodes.end()) {
-      // This is a new op. Break up the chunk into cacheline size requests and
-      // insert them into the cache queue.
-      bool isLoad = node->is_host_load();
-      HostMemAccess* mem_access = node->get_host_mem_access();
-      size_t size = mem_access->size;  // In bytes.
-      Addr src_vaddr = mem_access->src_addr;
-      Addr dst_vaddr = mem_access->dst_addr;
-      Addr host_vaddr = isLoad ? src_vaddr : dst_vaddr;
+    // Break up the chunk into cacheline size requests and insert them into
+    // the cache queue, as far as it has room for them.
+    bool isLoad = node->is_host_load();
+    HostMemAccess* mem_access = node->get_host_mem_access();
+    size_t size = mem_access->size;  // In bytes.
+    Addr src_vaddr = mem_access->src_addr;
+    Addr dst_vaddr = mem_access->dst_addr;
+    Addr host_vaddr = isLoad ? src_vaddr : dst_vaddr;
+    size_t& bytes_queued = burst_bytes_queued[node_id];
+    if (bytes_queued < size) {
       const std::string& array_label = isLoad ? mem_access->src_var->get_name()
                                               : mem_access->dst_var->get_name();
-      for (ChunkGenerator gen(host_vaddr, size, cacheLineSize); !gen.done();
-           gen.next()) {
-        inflight_burst_nodes[node_id].push_back(createAndQueueAcpEntry(
-            gen.addr(), gen.size(), isLoad, array_label, node_id));
+      for (ChunkGenerator gen(
+               host_vaddr + bytes_queued, size - bytes_queued, cacheLineSize);
+           !gen.done(); gen.next()) {
+        MemoryQueueEntry* entry = createAndQueueAcpEntry(
+            gen.addr(), gen.size(), isLoad, array_label, node_id);
+        if (!entry)
+          break;
+        // A merged load may find its line already returned.
+        if (entry->status != Returned)
+          inflight_burst_nodes[node_id].push_back(entry);
+        bytes_queued += gen.size();
       }
     }
     if (inflight_burst_nodes[node_id].size() > 0) {
@@ -845,10 +811,17 @@ bool HybridDatapath::handleAcpMemoryOp(ExecNode* node) {
         }
       }
       return false;
+    } else if (bytes_queued < size) {
+      DPRINTF(HybridDatapathVerbose,
+              "Cache queue is full while queuing ACP requests of host node "
+              "%d.\n",
+              node_id);
+      return false;
     } else {
       DPRINTF(
           HybridDatapath, "Host memory op completes for node %d.\n", node_id);
       inflight_burst_nodes.erase(node_id);
+      burst_bytes_queued.erase(node_id);
       // All the requests of this node have completed.
       return true;
     }
@@ -866,6 +839,13 @@ bool HybridDatapath::handleAcpMemoryOp(ExecNode* node) {
     int size = mem_access->size;
     MemoryQueueEntry* entry = createAndQueueAcpEntry(
         vaddr, size, isLoad, node->get_array_label(), node_id);
+    if (!entry) {
+      DPRINTF(HybridDatapathVerbose,
+              "Unable to service new ACP request for node %d: "
+              "cache queue is full.\n",
+              node_id);
+      return false;
+    }
     return updateAcpEntryStatus(entry, node);
   } else {
     fatal("Unexpected ACP access op, node id %d!\n", node_id);
@@ -970,7 +950,8 @@ void HybridDatapath::sendFinishedSignal() {
   MemCmd::Command cmd = MemCmd::WriteReq;
   PacketPtr pkt = new Packet(req, cmd);
   pkt->dataStatic<uint8_t>(data);
-  DatapathSenderState* state = new DatapathSenderState(true, Cache);
+  DatapathSenderState* state =
+      new DatapathSenderState(true, MemoryOpType::Cache);
   pkt->pushSenderState(state);
 
   if (!cachePort.sendTimingReq(pkt)) {
@@ -1086,7 +1067,7 @@ HybridDatapath::IssueResult HybridDatapath::issueCacheRequest(Addr vaddr,
                                                               unsigned node_id,
                                                               uint8_t* data) {
   return issueCacheOrAcpRequest(
-      Cache, vaddr, paddr, size, isLoad, node_id, data);
+      MemoryOpType::Cache, vaddr, paddr, size, isLoad, node_id, data);
 }
 
 HybridDatapath::IssueResult HybridDatapath::issueAcpRequest(Addr vaddr,
@@ -1096,7 +1077,7 @@ HybridDatapath::IssueResult HybridDatapath::issueAcpRequest(Addr vaddr,
                                                             unsigned node_id,
                                                             uint8_t* data) {
   return issueCacheOrAcpRequest(
-      ACP, vaddr, paddr, size, isLoad, node_id, data);
+      MemoryOpType::ACP, vaddr, paddr, size, isLoad, node_id, data);
 }
 
 HybridDatapath::IssueResult HybridDatapath::issueCacheOrAcpRequest(
@@ -1108,15 +1089,16 @@ HybridDatapath::IssueResult HybridDatapath::issueCacheOrAcpRequest(
     unsigned node_id,
     uint8_t* data) {
   using namespace SrcTypes;
-  CachePort& port = op_type == Cache ? cachePort : acpPort;
+  CachePort& port = op_type == MemoryOpType::Cache ? cachePort : acpPort;
 
   if (port.inRetry()) {
     DPRINTF(HybridDatapathVerbose, "%s: %s port in retry.\n",
-            op_type == Cache ? "Cache" : "ACP", __func__);
+            op_type == MemoryOpType::Cache ? "Cache" : "ACP", __func__);
     return DidNotAttempt;
   }
 
-  MasterID id = op_type == Cache ? getCacheMasterId() : getAcpMasterId();
+  MasterID id = op_type == MemoryOpType::Cache ? getCacheMasterId()
+                                                : getAcpMasterId();
 
   Request::Flags flags = 0;
   /* To use strided prefetching, we need to include a "PC" so the prefetcher
@@ -1144,7 +1126,7 @@ HybridDatapath::IssueResult HybridDatapath::issueCacheOrAcpRequest(
     assert(data_pkt->isRequest());
     port.setRetryPkt(data_pkt);
     DPRINTF(HybridDatapathVerbose, "%s port is blocked. Will retry node %d.\n",
-            op_type == Cache ? "Cache" : "ACP", node_id);
+            op_type == MemoryOpType::Cache ? "Cache" : "ACP", node_id);
     return WillRetry;
   }
   return Accepted;
@@ -1180,7 +1162,8 @@ HybridDatapath::IssueResult HybridDatapath::issueOwnershipRequest(
   MemCmd command = MemCmd::ReadExReq;
 
   PacketPtr data_pkt = new Packet(req, command);
-  DatapathSenderState* state = new DatapathSenderState(node_id, vaddr, ACP);
+  DatapathSenderState* state =
+      new DatapathSenderState(node_id, vaddr, MemoryOpType::ACP);
   data_pkt->pushSenderState(state);
   uint8_t* data = new uint8_t[size];
   data_pkt->dataDynamic<uint8_t>(data);
@@ -1210,7 +1193,7 @@ void HybridDatapath::updateCacheRequestStatusOnResp(
   MemoryQueueEntry* entry = cache_queue.findMatch(vaddr, isLoad);
   panic_if(!entry, "Did not find a cache queue entry for vaddr %#x\n", vaddr);
   if (entry->status == WaitingFromCache) {
-    entry->status = Returned;
+    cache_queue.markReturned(entry);
     Tick elapsed = curTick() - entry->when_issued;
     ExecNode* node = getProgram().nodes.at(node_id);
     if (node->is_host_mem_op()) {
@@ -1241,11 +1224,11 @@ void HybridDatapath::updateCacheRequestStatusOnResp(
     Stats::Scalar* mem_stat_count;
     Stats::Histogram* mem_stat_latency;
     switch (entry->type) {
-      case Cache:
+      case MemoryOpType::Cache:
         mem_stat_count = isLoad ? &dcache_loads : &dcache_stores;
         mem_stat_latency = &dcache_latency;
         break;
-      case ACP:
+      case MemoryOpType::ACP:
         mem_stat_count = isLoad ? &acp_loads : &acp_stores;
         mem_stat_latency = &acp_latency;
         break;
@@ -1272,7 +1255,7 @@ void HybridDatapath::updateCacheRequestStatusOnRetry(PacketPtr pkt) {
       HybridDatapath,
       "node:%d, vaddr = 0x%x, paddr = 0x%x, %s request retried successfully.\n",
       state->node_id, vaddr, pkt->getAddr(),
-      mem_type == Cache ? "Cache" : "ACP");
+      mem_type == MemoryOpType::Cache ? "Cache" : "ACP");
 
   // If we receive a ReadExReq or ReadExReq, that means that the trace vaddr
   // associated with the request was for a STORE, and stores do not (currently)
@@ -195,14 +195,6 @@ class HybridDatapath : public ScratchpadDatapath, public Gem5Datapath {
    */
   Addr translateAtomic(Addr vaddr, int size) override;
 
-  /* Returns the memory op type for this node (or array label).
-   *
-   * The memory op type depends on the datapath's particular configuration,
-   * so this must be determined by the datapath.
-   */
-  MemoryOpType getMemoryOpType(ExecNode* node);
-  MemoryOpType getMemoryOpType(const std::string& array_label);
-
   /* Handle a register memory operation and return true if success.
    *
    * Registers currently have no bandwidth limits, so this will always
@@ -258,7 +250,8 @@ class HybridDatapath : public ScratchpadDatapath, public Gem5Datapath {
   bool handleAcpMemoryOp(ExecNode* node);
 
   // If the specified vaddr doesn't match any entry in the cache queue, create
-  // an entry for it and insert it to the cache queue.
+  // an entry for it and insert it to the cache queue. Returns nullptr if the
+  // cache queue is full.
   MemoryQueueEntry* createAndQueueAcpEntry(Addr vaddr,
                                            int size,
                                            bool isLoad,
@@ -405,6 +398,10 @@ class HybridDatapath : public ScratchpadDatapath, public Gem5Datapath {
   // TODO: Refactor the host ACP/cache accesses into the ACP/Cache ports, so we
   // don't need to track them here.
   std::map<unsigned, std::list<MemoryQueueEntry*>> inflight_burst_nodes;
+  // The number of bytes of each bursty node that have been queued so far. A
+  // burst can be larger than the cache queue, so it is queued as entries free
+  // up.
+  std::map<unsigned, size_t> burst_bytes_queued;
 
   /* Hash table to track DMA accesses. Indexed by the base address of DMA
    * accesses, and mapped to the corresponding node id for that DMA request. */
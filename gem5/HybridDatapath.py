@@ -75,7 +75,8 @@ class HybridDatapath(ClockedObject):
   numOutStandingWalks = Param.Int(4, "num of outstanding page walks")
   tlbBandwidth = Param.Int(
       1, "Number of translations that can be requested per cycle.")
-  cacheQueueSize = Param.Int(32, "Maximum outstanding cache requests.")
+  cacheQueueSize = Param.Int(
+      32, "Maximum outstanding cache requests, or 0 for no limit.")
   cacheBandwidth = Param.Int(4, "Maximum cache requests per cycle.")
 
   # ACP cache latency parameters
@@ -1,12 +1,17 @@
 #ifndef __MEMORY_QUEUE_H__
 #define __MEMORY_QUEUE_H__
 
+#include <deque>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/statistics.hh"
 #include "sim/core.hh"
 
+#include "aladdin/common/MemoryType.h"
+
 #define MIN_CACTI_SIZE 64
 
 // Current status of a memory access. Used for caches and DMA requests.
@@ -24,17 +29,6 @@ enum MemAccessStatus {
   Returned
 };
 
-/* All possible types of memory operations supported by Aladdin. */
-enum MemoryOpType {
-  Register,
-  Scratchpad,
-  Cache,
-  Dma,
-  ACP,
-  ReadyBits,
-  NumMemoryOpTypes,
-};
-
 class MemoryQueueEntry {
  public:
   MemoryQueueEntry() {
@@ -42,7 +36,7 @@ class MemoryQueueEntry {
     vaddr = 0x0;
     paddr = 0x0;
     size = 0;
-    type = NumMemoryOpTypes;
+    type = MemoryOpType::NumMemoryOpTypes;
     when_allocated = curTick();
     when_issued = 0;
   }
@@ -57,6 +51,16 @@ class MemoryQueueEntry {
   bool isLoad;
 };
 
+/* The outstanding cache and ACP requests of the datapath, like a set of MSHRs.
+ *
+ * Entries come from a pool of @size entries that is allocated once, and are
+ * indexed by address (the cache line address for loads, which are merged).
+ * When the pool is empty, no more requests can be allocated until returned
+ * entries are retired. A size of zero lets the pool grow without bound.
+ *
+ * Requests must be completed with markReturned(), which queues the entry to be
+ * retired at the end of the cycle.
+ */
 class MemoryQueue {
  public:
   MemoryQueue(int _size,
@@ -65,7 +69,14 @@ class MemoryQueue {
               std::string _cacti_config)
       : issuedThisCycle(0), size(_size), bandwidth(_bandwidth),
         cache_line_size(_cache_line_size), cacti_config(_cacti_config),
-        readEnergy(0), writeEnergy(0), leakagePower(0), area(0) {}
+        readEnergy(0), writeEnergy(0), leakagePower(0), area(0) {
+    // Entries in a deque keep their addresses as the pool grows.
+    pool.resize(size);
+    free_entries.reserve(size);
+    for (auto it = pool.rbegin(); it != pool.rend(); ++it)
+      free_entries.push_back(&*it);
+    ops.reserve(size);
+  }
 
   void initStats(std::string _name) {
     name = _name;
@@ -75,28 +86,22 @@ class MemoryQueue {
     writeStats.name("system." + name + "_writes")
         .desc("Number of writes to the " + name)
         .flags(Stats::total | Stats::nonan);
+    fullStats.name("system." + name + "_full")
+        .desc("Number of requests refused because the " + name + " was full")
+        .flags(Stats::total | Stats::nonan);
   }
 
   bool canIssue() { return bandwidth == 0 ? true : (issuedThisCycle < bandwidth); }
 
-  bool isFull() {
-    if (ops.size() >= size) {
-      warn("The memory queue becomes full. Capacity: %d, current size: %d.\n",
-           size,
-           ops.size());
-    }
-    return false;
-  }
+  bool isFull() { return size != 0 && free_entries.empty(); }
 
   /* Returns true if the ops already contains an entry for this address. */
   bool contains(Addr vaddr) { return (ops.find(vaddr) != ops.end()); }
 
   bool insert(Addr vaddr) {
-    if (!isFull() && !contains(vaddr)) {
-      ops[vaddr] = new MemoryQueueEntry();
-      return true;
-    }
-    return false;
+    if (contains(vaddr))
+      return false;
+    return allocateEntry(vaddr, 0, false) != nullptr;
   }
 
   MemoryQueueEntry* findMatch(Addr vaddr, bool merge) {
@@ -104,17 +109,25 @@ class MemoryQueue {
     return findMatch(vaddr);
   }
 
+  /* Returns nullptr if the queue is full. */
   MemoryQueueEntry* allocateEntry(Addr vaddr, int size, bool merge) {
-    if (!isFull()) {
-      vaddr = merge ? toCacheLineAddr(vaddr) : vaddr;
-      MemoryQueueEntry* entry = new MemoryQueueEntry();
-      entry->vaddr = vaddr;
-      entry->size = size;
-      entry->isLoad = merge;
-      ops[vaddr] = entry;
-      return entry;
+    if (isFull()) {
+      fullStats++;
+      return nullptr;
+    }
+    if (free_entries.empty()) {
+      pool.emplace_back();
+      free_entries.push_back(&pool.back());
     }
-    return nullptr;
+    MemoryQueueEntry* entry = free_entries.back();
+    free_entries.pop_back();
+    *entry = MemoryQueueEntry();
+    vaddr = merge ? toCacheLineAddr(vaddr) : vaddr;
+    entry->vaddr = vaddr;
+    entry->size = size;
+    entry->isLoad = merge;
+    ops[vaddr] = entry;
+    return entry;
   }
 
   void deallocateEntry(Addr vaddr, bool merge) {
@@ -123,8 +136,20 @@ class MemoryQueue {
   }
 
   void remove(Addr vaddr) {
-    delete ops[vaddr];
-    ops.erase(vaddr);
+    auto it = ops.find(vaddr);
+    if (it == ops.end())
+      return;
+    MemoryQueueEntry* entry = it->second;
+    ops.erase(it);
+    // A returned entry is freed when it is retired.
+    if (entry->status != Returned)
+      free_entries.push_back(entry);
+  }
+
+  /* Completes the request of this entry. */
+  void markReturned(MemoryQueueEntry* entry) {
+    entry->status = Returned;
+    returned.push_back(entry);
   }
 
   void incrementIssuedThisCycle() {
@@ -140,15 +165,13 @@ class MemoryQueue {
    * This is done at the end of every cycle to free space for new requests.
    */
   void retireReturnedEntries() {
-    for (auto it = ops.begin(); it != ops.end(); /* no increment */) {
-      MemoryQueueEntry* entry = it->second;
-      if (entry->status == Returned) {
-        ops.erase(it++);  // Must be post-increment!
-        delete entry;
-      } else {
-        ++it;
-      }
+    for (MemoryQueueEntry* entry : returned) {
+      auto it = ops.find(entry->vaddr);
+      if (it != ops.end() && it->second == entry)
+        ops.erase(it);
+      free_entries.push_back(entry);
     }
+    returned.clear();
   }
 
   void computeCactiResults() {
@@ -199,9 +222,8 @@ class MemoryQueue {
 
  protected:
   MemoryQueueEntry* findMatch(Addr vaddr) {
-    if (ops.find(vaddr) != ops.end())
-      return ops[vaddr];
-    return nullptr;
+    auto it = ops.find(vaddr);
+    return it == ops.end() ? nullptr : it->second;
   }
 
   Addr toCacheLineAddr(Addr addr) {
@@ -222,10 +244,16 @@ class MemoryQueue {
 
   Stats::Scalar readStats;
   Stats::Scalar writeStats;
+  Stats::Scalar fullStats;
   size_t issuedThisCycle;  // Requests issued in the current cycle.
 
+  // Storage for all entries, and the ones that are not in use.
+  std::deque<MemoryQueueEntry> pool;
+  std::vector<MemoryQueueEntry*> free_entries;
   // Maps address to the associated memory operation status.
-  std::map<Addr, MemoryQueueEntry*> ops;
+  std::unordered_map<Addr, MemoryQueueEntry*> ops;
+  // Entries that have returned this cycle and wait to be retired.
+  std::vector<MemoryQueueEntry*> returned;
 };
 
 #endif
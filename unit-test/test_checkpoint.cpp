@@ -0,0 +1,171 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+#include "SyntheticTrace.h"
+
+// Read @file_name, without the lines naming the benchmark.
+std::string readStats(const std::string& file_name) {
+  std::ifstream in(file_name);
+  std::stringstream stats;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 9, "Running :") != 0)
+      stats << line << "\n";
+  }
+  return stats.str();
+}
+
+void removeStats(const std::string& bench) {
+  for (const char* suffix :
+       { "_summary", "_spad_stats.txt", "_mem_system_stats.txt" })
+    remove((bench + suffix).c_str());
+}
+
+// Run the invocations of @acc the way aladdin does, recording the schedule of
+// every node. If @stop_invocation is not -1, stop as if the simulation was
+// killed once that invocation reaches @stop_cycle, and return false.
+bool runInvocations(ScratchpadDatapath* acc,
+                    std::vector<std::pair<int, int>>& schedule,
+                    int stop_invocation = -1,
+                    unsigned stop_cycle = 0) {
+  int invocation = 0;
+  while (acc->buildDddg()) {
+    acc->globalOptimizationPass();
+    if (acc->isReplayingInvocation()) {
+      acc->clearDatapath();
+      invocation++;
+      continue;
+    }
+    acc->prepareForScheduling();
+    while (!acc->step()) {
+      if (invocation == stop_invocation && acc->getCurrentCycle() >= stop_cycle)
+        return false;
+    }
+    acc->dumpStats();
+    for (auto& node_pair : acc->getProgram().nodes) {
+      schedule.push_back(
+          std::make_pair(node_pair.second->get_start_execution_cycle(),
+                         node_pair.second->get_complete_execution_cycle()));
+    }
+    acc->clearDatapath();
+    invocation++;
+  }
+  return true;
+}
+
+SCENARIO("Test resuming from a checkpoint", "[checkpoint]") {
+  GIVEN("Triad with a single invocation") {
+    mkdir("outputs", 0755);
+    std::string bench("outputs/checkpoint-triad");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+    std::string checkpoint_file(bench + ".ckpt");
+    remove(checkpoint_file.c_str());
+
+    std::vector<std::pair<int, int>> reference;
+    ScratchpadDatapath* acc =
+        new ScratchpadDatapath(bench, trace_file, config_file);
+    REQUIRE(runInvocations(acc, reference));
+    delete acc;
+    std::string summary = readStats(bench + "_summary");
+
+    WHEN("The simulation is killed after a few checkpoints.") {
+      std::vector<std::pair<int, int>> schedule;
+      acc = new ScratchpadDatapath(bench, trace_file, config_file);
+      acc->setCheckpointFile(checkpoint_file, 10);
+      REQUIRE(!runInvocations(acc, schedule, 0, 25));
+      delete acc;
+      REQUIRE(fileExists(checkpoint_file));
+
+      THEN("Resuming it gives the same schedule and stats.") {
+        acc = new ScratchpadDatapath(bench, trace_file, config_file);
+        acc->setCheckpointFile(checkpoint_file, 10);
+        REQUIRE(acc->resumeFromCheckpoint());
+        REQUIRE(runInvocations(acc, schedule));
+        delete acc;
+        REQUIRE(schedule == reference);
+        REQUIRE(readStats(bench + "_summary") == summary);
+      }
+    }
+    WHEN("There is no checkpoint yet.") {
+      acc = new ScratchpadDatapath(bench, trace_file, config_file);
+      acc->setCheckpointFile(checkpoint_file, 10);
+      THEN("The simulation starts from the beginning.") {
+        REQUIRE(!acc->resumeFromCheckpoint());
+        std::vector<std::pair<int, int>> schedule;
+        REQUIRE(runInvocations(acc, schedule));
+        REQUIRE(schedule == reference);
+      }
+      delete acc;
+    }
+  }
+  GIVEN("A synthetic trace with three invocations") {
+    mkdir("outputs", 0755);
+    SyntheticTraceParams params;
+    params.trip_counts = { 8, 16 };
+    params.dma = true;
+    params.fp_fraction = 0.3;
+    params.mem_dep_density = 0.3;
+    SyntheticTraceGenerator generator(params);
+    generator.writeConfig("outputs/checkpoint.cfg");
+    generator.writeTrace("outputs/checkpoint-invocation-trace.gz");
+    // Concatenated gzip files decompress to the concatenated traces.
+    {
+      std::ifstream invocation("outputs/checkpoint-invocation-trace.gz",
+                               std::ios::binary);
+      std::stringstream bytes;
+      bytes << invocation.rdbuf();
+      std::ofstream trace("outputs/checkpoint-trace.gz", std::ios::binary);
+      for (int i = 0; i < 3; i++)
+        trace << bytes.str();
+    }
+    std::string trace_file("outputs/checkpoint-trace.gz");
+    std::string config_file("outputs/checkpoint.cfg");
+    std::string ref_bench("outputs/checkpoint-seq");
+    std::string bench("outputs/checkpoint-resumed");
+    std::string checkpoint_file(bench + ".ckpt");
+    removeStats(ref_bench);
+    removeStats(bench);
+    remove(checkpoint_file.c_str());
+
+    std::vector<std::pair<int, int>> reference;
+    ScratchpadDatapath* acc =
+        new ScratchpadDatapath(ref_bench, trace_file, config_file);
+    REQUIRE(runInvocations(acc, reference));
+    delete acc;
+
+    WHEN("The simulation is killed in the second invocation.") {
+      std::vector<std::pair<int, int>> schedule;
+      acc = new ScratchpadDatapath(bench, trace_file, config_file);
+      acc->setCheckpointFile(checkpoint_file, 16);
+      REQUIRE(!runInvocations(acc, schedule, 1, 40));
+      delete acc;
+
+      THEN("Resuming it replays the first invocation and finishes the rest "
+           "with the same stats.") {
+        // Only the invocations scheduled after resuming are recorded.
+        schedule.clear();
+        acc = new ScratchpadDatapath(bench, trace_file, config_file);
+        acc->setCheckpointFile(checkpoint_file, 16);
+        REQUIRE(acc->resumeFromCheckpoint());
+        REQUIRE(runInvocations(acc, schedule));
+        delete acc;
+        std::vector<std::pair<int, int>> resumed_reference(
+            reference.end() - schedule.size(), reference.end());
+        REQUIRE(schedule.size() == reference.size() * 2 / 3);
+        REQUIRE(schedule == resumed_reference);
+        REQUIRE(readStats(bench + "_summary") ==
+                readStats(ref_bench + "_summary"));
+        REQUIRE(readStats(bench + "_spad_stats.txt") ==
+                readStats(ref_bench + "_spad_stats.txt"));
+      }
+    }
+  }
+}
@@ -0,0 +1,169 @@
+#include <fstream>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "DesignSpaceExplorer.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+SCENARIO("Test reconfiguring a datapath w/ Triad", "[dse]") {
+  GIVEN("Test Triad w/ Input Size 128, cyclic partition with a factor of 2, "
+        "loop unrolling with a factor of 2, enable loop pipelining") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->buildDddg();
+    Program program;
+    program.copyFrom(acc->getProgram());
+    UserConfigParams params = acc->getUserParams();
+    ProgramInfo info = acc->getProgramInfo();
+    REQUIRE(program.getNumNodes() == acc->getProgram().getNumNodes());
+    REQUIRE(program.getNumEdges() == acc->getProgram().getNumEdges());
+
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    unsigned cycles = acc->getCurrentCycle();
+    WHEN("The copied program is scheduled again.") {
+      acc->reconfigure(program, params, info);
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      THEN("It takes as many cycles as the original.") {
+        REQUIRE(acc->getCurrentCycle() == cycles);
+      }
+    }
+    WHEN("The copied program is scheduled twice with the graph cache.") {
+      acc->setGraphCacheCapacity(32);
+      acc->reconfigure(program, params, info);
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      unsigned misses = acc->getGraphCache().getMisses();
+      unsigned cached_cycles = acc->getCurrentCycle();
+      acc->reconfigure(program, params, info);
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      THEN("The second run reuses the optimized program.") {
+        REQUIRE(acc->getGraphCache().getHits() > 0);
+        REQUIRE(acc->getGraphCache().getMisses() == misses);
+      }
+      THEN("Both runs take as many cycles as the original.") {
+        REQUIRE(cached_cycles == cycles);
+        REQUIRE(acc->getCurrentCycle() == cycles);
+      }
+    }
+    WHEN("The copied program is scheduled with more memory bandwidth.") {
+      for (auto& part : params.partition) {
+        if (part.second.memory_type == spad)
+          part.second.part_factor = 4;
+      }
+      acc->reconfigure(program, params, info);
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      THEN("It does not get slower.") {
+        REQUIRE(acc->getCurrentCycle() <= cycles);
+      }
+    }
+    program.clear();
+    delete acc;
+  }
+}
+
+SCENARIO("Test design space exploration w/ Triad", "[dse]") {
+  GIVEN("Test Triad w/ Input Size 128, sweeping the unrolling factor and the "
+        "partitioning of a and b") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+    std::string sweep_file("inputs/sweep-triad");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    DesignSpaceExplorer explorer(acc, sweep_file);
+    explorer.explore();
+    THEN("Only the report is written.") {
+      REQUIRE(fileExists(bench + "_frontier"));
+      REQUIRE(!fileExists(bench + "_estimate"));
+      REQUIRE(!fileExists(bench + "_summary"));
+    }
+    WHEN("The exploration is complete.") {
+      auto& points = explorer.getDesignPoints();
+      std::vector<const DesignPoint*> frontier;
+      for (auto& point : points) {
+        if (point.second.on_frontier)
+          frontier.push_back(&point.second);
+      }
+      THEN("Every dimension of the sweep was parsed.") {
+        REQUIRE(explorer.getDimensions().size() == 3);
+      }
+      THEN("Some points were pruned, and the frontier is not empty.") {
+        REQUIRE(points.size() <= 27);
+        REQUIRE(frontier.size() > 0);
+      }
+      THEN("Every scheduled point off the frontier is dominated by a frontier "
+           "point.") {
+        for (auto& point : points) {
+          if (point.second.status != DesignPoint::Scheduled ||
+              point.second.on_frontier)
+            continue;
+          bool dominated = false;
+          for (const DesignPoint* f : frontier) {
+            if (f->getTime() <= point.second.getTime() &&
+                f->result.avg_power <= point.second.result.avg_power)
+              dominated = true;
+          }
+          REQUIRE(dominated);
+        }
+      }
+    }
+    delete acc;
+  }
+}
+
+SCENARIO("Test design space exploration w/ multiple invocations", "[dse]") {
+  GIVEN("A trace with two invocations and sampled loops") {
+    std::string bench("outputs/dse-multiple-invoc");
+    std::string trace_file("inputs/loop-sampling-multiple-invoc-trace.gz");
+    std::string config_file("inputs/config-loop-sampling");
+    std::string sweep_file("outputs/sweep-multiple-invoc");
+    {
+      std::ofstream sweep(sweep_file);
+      sweep << "cycle_time,1\n";
+    }
+
+    ScratchpadDatapath* acc =
+        new ScratchpadDatapath(bench, trace_file, config_file);
+    int num_invocations = 0;
+    int cycles = 0;
+    while (acc->buildDddg()) {
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      acc->dumpStats();
+      cycles += acc->getSummary().num_cycles;
+      acc->clearDatapath();
+      num_invocations++;
+    }
+    delete acc;
+    REQUIRE(num_invocations == 2);
+
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    DesignSpaceExplorer explorer(acc, sweep_file);
+    explorer.explore();
+    THEN("The only design point covers every invocation.") {
+      auto& points = explorer.getDesignPoints();
+      REQUIRE(points.size() == 1);
+      const DesignPoint& point = points.begin()->second;
+      REQUIRE(point.status == DesignPoint::Scheduled);
+      REQUIRE(point.result.num_cycles == cycles);
+    }
+    delete acc;
+  }
+}
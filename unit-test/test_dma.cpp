@@ -23,8 +23,7 @@ SCENARIO("Test DMA Dependence w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     const Program& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     WHEN("Test DMA dependence before loop unrolling.") {
@@ -87,8 +86,7 @@ SCENARIO("Test double buffering memcpy", "[double-buffering]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     const Program& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
 
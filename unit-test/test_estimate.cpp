@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+// Schedule triad as @bench, computing the estimates first if @estimate is
+// set, and return its summary and scratchpad stats.
+static std::string scheduleTriad(const std::string& bench, bool estimate) {
+  remove((bench + "_summary").c_str());
+  remove((bench + "_spad_stats.txt").c_str());
+  ScratchpadDatapath* acc =
+      new ScratchpadDatapath(bench, "inputs/triad-128-trace.gz",
+                             "inputs/config-triad-p2-u2-P1");
+  acc->buildDddg();
+  acc->globalOptimizationPass();
+  acc->prepareForScheduling();
+  if (estimate) {
+    acc->computeMemoryBoundCycles();
+    acc->computeMemoryDynamicEnergy();
+  }
+  while (!acc->step()) {}
+  acc->dumpStats();
+  delete acc;
+
+  std::stringstream stats;
+  for (const char* suffix : { "_summary", "_spad_stats.txt" }) {
+    std::ifstream in(bench + suffix);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.compare(0, 9, "Running :") != 0)
+        stats << line << "\n";
+    }
+  }
+  return stats.str();
+}
+
+SCENARIO("Test analytical estimation w/ Triad", "[estimate]") {
+  GIVEN("Test Triad w/ Input Size 128, cyclic partition with a factor of 2, "
+        "loop unrolling with a factor of 2, enable loop pipelining") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    WHEN("Estimating before scheduling.") {
+      int critical_path_cycles = acc->computeCriticalPathCycles();
+      int memory_bound_cycles = acc->computeMemoryBoundCycles();
+      THEN("Each partition of a, b and c is accessed 64 times through a "
+           "single port.") {
+        REQUIRE(memory_bound_cycles == 64);
+      }
+      THEN("Neither bound exceeds the scheduled cycle count.") {
+        while (!acc->step()) {}
+        REQUIRE(critical_path_cycles > 0);
+        REQUIRE(critical_path_cycles <= acc->getCurrentCycle());
+        REQUIRE(memory_bound_cycles <= acc->getCurrentCycle());
+      }
+    }
+    delete acc;
+  }
+}
+
+SCENARIO("Test analytical estimation w/ Reduction", "[estimate]") {
+  GIVEN("Test Reduction w/ Input Size 128, cyclic partition with a factor of "
+        "4, loop unrolling with a factor of 4, enable loop pipelining") {
+    std::string bench("outputs/reduction-128");
+    std::string trace_file("inputs/reduction-128-trace.gz");
+    std::string config_file("inputs/config-reduction-p4-u4-P1");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    WHEN("Estimating before scheduling.") {
+      int critical_path_cycles = acc->computeCriticalPathCycles();
+      int memory_bound_cycles = acc->computeMemoryBoundCycles();
+      THEN("The chain of additions dominates the memory bandwidth bound.") {
+        REQUIRE(memory_bound_cycles == 32);
+        REQUIRE(critical_path_cycles > memory_bound_cycles);
+      }
+      THEN("Neither bound exceeds the scheduled cycle count.") {
+        while (!acc->step()) {}
+        REQUIRE(critical_path_cycles <= acc->getCurrentCycle());
+        REQUIRE(memory_bound_cycles <= acc->getCurrentCycle());
+      }
+    }
+    delete acc;
+  }
+}
+
+SCENARIO("Test that estimating does not change the stats", "[estimate]") {
+  GIVEN("Triad scheduled with and without computing the estimates first") {
+    std::string plain = scheduleTriad("outputs/triad-no-estimate", false);
+    std::string estimated = scheduleTriad("outputs/triad-estimate", true);
+    THEN("The summary and scratchpad stats are identical.") {
+      REQUIRE(!plain.empty());
+      REQUIRE(estimated == plain);
+    }
+  }
+  GIVEN("Triad estimated without scheduling") {
+    ScratchpadDatapath* acc =
+        new ScratchpadDatapath("outputs/triad-estimate",
+                               "inputs/triad-128-trace.gz",
+                               "inputs/config-triad-p2-u2-P1");
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    acc->setQuiet(true);
+    acc->estimateStats();
+    THEN("The memory accesses still count towards the memory power.") {
+      REQUIRE(acc->computeMemoryDynamicEnergy() > 0);
+      REQUIRE(acc->getSummary().avg_mem_dynamic_power > 0);
+    }
+    delete acc;
+  }
+}
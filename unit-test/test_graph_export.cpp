@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <set>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "GraphExporter.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+// Count the edges of @program between nodes that are both in @nodes.
+unsigned countEdges(const Program& program, const std::set<unsigned>& nodes) {
+  unsigned num_edges = 0;
+  for (unsigned node_id : nodes) {
+    for (unsigned child : program.getChildNodes(node_id)) {
+      if (nodes.count(child))
+        num_edges++;
+    }
+  }
+  return num_edges;
+}
+
+// Return the number of edges in @csv and check that their endpoints are all in
+// @nodes.
+unsigned checkCsv(const std::string& csv, const std::set<unsigned>& nodes) {
+  std::istringstream in(csv);
+  std::string line;
+  std::getline(in, line);
+  REQUIRE(line == "from,to,parid");
+  unsigned num_edges = 0;
+  while (std::getline(in, line)) {
+    unsigned from, to;
+    int parid;
+    REQUIRE(sscanf(line.c_str(), "%u,%u,%d", &from, &to, &parid) == 3);
+    REQUIRE(nodes.count(from) == 1);
+    REQUIRE(nodes.count(to) == 1);
+    num_edges++;
+  }
+  return num_edges;
+}
+
+SCENARIO("Test graph export w/ Triad", "[graph_export]") {
+  GIVEN("Test Triad w/ Input Size 128, cyclic partition with a factor of 2, "
+        "loop unrolling with a factor of 2, enable loop pipelining") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    const Program& program = acc->getProgram();
+    std::set<unsigned> all_nodes;
+    for (auto& node_pair : program.nodes)
+      all_nodes.insert(node_pair.first);
+
+    WHEN("Nothing is selected.") {
+      GraphExporter exporter(program);
+      std::ostringstream out;
+      unsigned num_nodes = exporter.write(out, GraphExporter::Csv);
+      THEN("The whole graph is written, including the barrier edges.") {
+        REQUIRE(num_nodes == program.nodes.size());
+        REQUIRE(checkCsv(out.str(), all_nodes) == program.getNumEdges());
+      }
+    }
+    WHEN("A range of node ids is selected.") {
+      GraphExporter exporter(program);
+      exporter.selectNodes(100, 300);
+      std::ostringstream out;
+      unsigned num_nodes = exporter.write(out, GraphExporter::Csv);
+      THEN("Only the edges within the range are written.") {
+        std::set<unsigned> nodes(all_nodes.lower_bound(100),
+                                 all_nodes.upper_bound(300));
+        REQUIRE(num_nodes == nodes.size());
+        REQUIRE(checkCsv(out.str(), nodes) == countEdges(program, nodes));
+      }
+    }
+    WHEN("The neighborhood of a node is selected.") {
+      unsigned root = 20;
+      GraphExporter exporter(program);
+      exporter.selectNeighborhood(root, 1, 300, -1, true);
+      std::ostringstream out;
+      unsigned num_nodes = exporter.write(out, GraphExporter::Binary);
+      THEN("The binary header counts the root, its children and their "
+           "edges.") {
+        std::vector<unsigned> children = program.getChildNodes(root);
+        std::set<unsigned> nodes(children.begin(), children.end());
+        nodes.insert(root);
+        REQUIRE(num_nodes == nodes.size());
+
+        std::string data = out.str();
+        REQUIRE(data.compare(0, 8, "ALADGRPH") == 0);
+        uint32_t header[2];
+        memcpy(header, data.data() + 8, sizeof(header));
+        REQUIRE(header[0] == nodes.size());
+        REQUIRE(header[1] == countEdges(program, nodes));
+        REQUIRE(data.size() ==
+                8 + sizeof(header) + (header[0] * 4 + header[1] * 3) * 4);
+      }
+    }
+    WHEN("The neighborhood is limited in size.") {
+      unsigned root = 0;
+      for (auto& node_pair : program.nodes) {
+        if (program.getChildNodes(node_pair.first).size() > 10) {
+          root = node_pair.first;
+          break;
+        }
+      }
+      GraphExporter exporter(program);
+      exporter.selectNeighborhood(root, 1000, 10, -1, true);
+      std::ostringstream out;
+      THEN("No more than that many nodes are written.") {
+        REQUIRE(exporter.write(out, GraphExporter::Graphviz) == 10);
+      }
+    }
+    WHEN("The function triad is selected.") {
+      GraphExporter exporter(program);
+      SrcTypes::Function* triad =
+          acc->get_source_manager().get<SrcTypes::Function>("triad");
+      THEN("Only its one invocation exists.") {
+        REQUIRE(exporter.selectFunction(triad, 0));
+        REQUIRE(!exporter.selectFunction(triad, 1));
+      }
+    }
+    delete acc;
+  }
+}
@@ -15,8 +15,7 @@ SCENARIO("Test initBaseAddress w/ c[i]=a[i] case", "[equal]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     WHEN("Test initBaseAddress()") {
       acc->initBaseAddress();
       THEN("The baseAddress of memory operations should be either "
@@ -43,8 +42,7 @@ SCENARIO("Test initBaseAddress w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     WHEN("Test initBaseAddress()") {
       acc->initBaseAddress();
       THEN("The baseAddress of memory operations should be either "
@@ -70,8 +68,7 @@ SCENARIO("Test initBaseAddress w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     WHEN("Test initBaseAddress()") {
       acc->initBaseAddress();
       THEN("The baseAddress of memory operations should be 'in' for "
@@ -94,8 +91,7 @@ SCENARIO("Test initBaseAddress w/ Pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     WHEN("Test initBaseAddress()") {
       acc->initBaseAddress();
       THEN("The baseAddress of memory operations should be 'bucket' or 'sum' "
@@ -0,0 +1,130 @@
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "InvocationPipeline.h"
+#include "Profiler.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+#include "SyntheticTrace.h"
+
+// Read the summary of @bench, without the lines naming the benchmark.
+std::string readSummary(const std::string& bench) {
+  std::ifstream in(bench + "_summary");
+  std::stringstream summary;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 9, "Running :") != 0)
+      summary << line << "\n";
+  }
+  return summary.str();
+}
+
+// Simulate every invocation of @trace_file one after the other, as aladdin
+// does without --pipeline.
+void runSequential(const std::string& bench,
+                   const std::string& trace_file,
+                   const std::string& config_file) {
+  ScratchpadDatapath* acc =
+      new ScratchpadDatapath(bench, trace_file, config_file);
+  while (acc->buildDddg()) {
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    acc->dumpStats();
+    acc->clearDatapath();
+  }
+  delete acc;
+}
+
+void runPipelined(const std::string& bench,
+                  const std::string& trace_file,
+                  const std::string& config_file,
+                  bool overlapped) {
+  ScratchpadDatapath* acc =
+      new ScratchpadDatapath(bench, trace_file, config_file);
+  InvocationPipeline invocations(acc, bench, trace_file, config_file);
+  invocations.setOverlapped(overlapped);
+  invocations.run();
+  delete acc;
+}
+
+SCENARIO("Test pipelining the invocations of a trace", "[pipeline]") {
+  GIVEN("A synthetic trace with three invocations") {
+    mkdir("outputs", 0755);
+    SyntheticTraceParams params;
+    params.trip_counts = { 8, 16 };
+    params.dma = true;
+    params.fp_fraction = 0.3;
+    params.mem_dep_density = 0.3;
+    SyntheticTraceGenerator generator(params);
+    generator.writeConfig("outputs/pipeline.cfg");
+    generator.writeTrace("outputs/pipeline-invocation-trace.gz");
+    // Concatenated gzip files decompress to the concatenated traces.
+    {
+      std::ifstream invocation("outputs/pipeline-invocation-trace.gz",
+                               std::ios::binary);
+      std::stringstream bytes;
+      bytes << invocation.rdbuf();
+      std::ofstream trace("outputs/pipeline-trace.gz", std::ios::binary);
+      for (int i = 0; i < 3; i++)
+        trace << bytes.str();
+    }
+    std::string trace_file("outputs/pipeline-trace.gz");
+    std::string config_file("outputs/pipeline.cfg");
+    runSequential("outputs/pipeline-seq", trace_file, config_file);
+    std::string sequential = readSummary("outputs/pipeline-seq");
+
+    WHEN("The stages overlap.") {
+      runPipelined("outputs/pipeline-par", trace_file, config_file, true);
+      THEN("Every invocation has the same results as without the pipeline.") {
+        REQUIRE(!sequential.empty());
+        REQUIRE(readSummary("outputs/pipeline-par") == sequential);
+      }
+    }
+    WHEN("The stages take turns.") {
+      runPipelined("outputs/pipeline-ser", trace_file, config_file, false);
+      THEN("Every invocation has the same results as without the pipeline.") {
+        REQUIRE(readSummary("outputs/pipeline-ser") == sequential);
+      }
+    }
+    WHEN("Profiling is enabled.") {
+      std::string bench("outputs/pipeline-prof");
+      ScratchpadDatapath* acc =
+          new ScratchpadDatapath(bench, trace_file, config_file);
+      acc->getProfiler().setEnabled(true);
+      InvocationPipeline invocations(acc, bench, trace_file, config_file);
+      invocations.setOverlapped(true);
+      invocations.run();
+      auto& records = acc->getProfiler().getRecords();
+      THEN("Both stages are recorded, in order of invocation.") {
+        std::vector<std::string> build_and_schedule;
+        for (auto& record : records) {
+          if (record.name == "buildDddg" || record.name == "schedule")
+            build_and_schedule.push_back(record.name +
+                                         std::to_string(record.invocation));
+        }
+        std::vector<std::string> expected = {
+          "buildDddg0", "schedule0", "buildDddg1",
+          "schedule1",  "buildDddg2", "schedule2"
+        };
+        REQUIRE(build_and_schedule == expected);
+      }
+      delete acc;
+    }
+  }
+  GIVEN("A trace with two invocations and sampled loops") {
+    std::string trace_file("inputs/loop-sampling-multiple-invoc-trace.gz");
+    std::string config_file("inputs/config-loop-sampling");
+    runSequential("outputs/pipeline-ls-seq", trace_file, config_file);
+    runPipelined("outputs/pipeline-ls-par", trace_file, config_file, true);
+    THEN("Both invocations have the same results as without the pipeline.") {
+      std::string sequential = readSummary("outputs/pipeline-ls-seq");
+      REQUIRE(!sequential.empty());
+      REQUIRE(readSummary("outputs/pipeline-ls-par") == sequential);
+    }
+  }
+}
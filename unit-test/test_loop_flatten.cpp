@@ -16,8 +16,7 @@ SCENARIO("Test loopFlatten w/ pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     const Program& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     WHEN("Test loopFlatten()") {
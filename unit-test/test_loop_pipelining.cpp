@@ -16,8 +16,7 @@ SCENARIO("Test loopPipelining w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     acc->loopUnrolling();
@@ -63,8 +62,7 @@ SCENARIO("Test loopPipelining w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     acc->loopUnrolling();
@@ -88,6 +86,9 @@ SCENARIO("Test loopPipelining w/ Reduction", "[reduction]") {
         REQUIRE(prog.edgeExists(35, 37) == 0);
         REQUIRE(prog.edgeExists(35, 45) == 0);
         REQUIRE(prog.edgeExists(995, 1021) == 0);
+        REQUIRE(prog.edgeExists(35, 39) == 0);
+        REQUIRE(prog.edgeExists(35, 47) == 0);
+        REQUIRE(prog.edgeExists(995, 1023) == 0);
       }
     }
   }
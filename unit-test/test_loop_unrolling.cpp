@@ -16,8 +16,7 @@ SCENARIO("Test loopUnrolling w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     WHEN("Test loopUnrolling()") {
@@ -53,6 +52,34 @@ SCENARIO("Test loopUnrolling w/ Triad", "[triad]") {
         REQUIRE(prog.edgeExists(510, 520));
         REQUIRE(prog.edgeExists(1518, 1528));
       }
+      THEN("Branch edges are implied by the control barriers, not stored in "
+           "the graph.") {
+        Vertex v30 = prog.nodes.at(30)->get_vertex();
+        Vertex v40 = prog.nodes.at(40)->get_vertex();
+        REQUIRE(!edge(v30, v40, prog.graph).second);
+        REQUIRE(prog.barriers.hasEdge(30, 40));
+        REQUIRE(prog.barriers.hasEdge(40, 54));
+        REQUIRE(prog.getEdgeWeight(30, 40) == CONTROL_EDGE);
+        REQUIRE(prog.getNumEdges() ==
+                (int)(boost::num_edges(prog.graph) + prog.barriers.numEdges()));
+      }
+      THEN("Every node maps to the region between its loop bounds.") {
+        const LoopRegions& regions = prog.getLoopRegions();
+        REQUIRE(regions.size() == prog.loop_bounds.size());
+        REQUIRE(regions.getRegion(30) == 2);
+        REQUIRE(regions.getRegion(40) == 2);
+        REQUIRE(regions.getRegion(54) == 3);
+        REQUIRE(regions.begin(2) == 30);
+        REQUIRE(regions.end(2) == 54);
+        REQUIRE(regions.isBound(30));
+        REQUIRE(!regions.isBound(40));
+        for (unsigned node_id :
+             regions.getNodes(2, LoopRegions::MemoryOps)) {
+          REQUIRE(node_id >= 30);
+          REQUIRE(node_id < 54);
+          REQUIRE(prog.nodes.at(node_id)->is_memory_op());
+        }
+      }
     }
   }
 }
@@ -69,8 +96,7 @@ SCENARIO("Test loopUnrolling w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     WHEN("Test loopUnrolling()") {
@@ -118,8 +144,7 @@ SCENARIO("Test loopUnrolling w/ pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     acc->loopFlatten();
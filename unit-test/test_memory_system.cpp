@@ -0,0 +1,250 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "MemorySystemModel.h"
+#include "ScratchpadDatapath.h"
+
+// Write a config file called @name to outputs/ and return its path.
+static std::string writeConfig(const std::string& name,
+                               const std::string& contents) {
+  mkdir("outputs", 0755);
+  std::string path = "outputs/" + name;
+  std::ofstream out(path);
+  out << contents;
+  return path;
+}
+
+// Simulate every invocation of @trace_file and return the total cycles.
+static int simulate(const std::string& bench,
+                    const std::string& trace_file,
+                    const std::string& config_file) {
+  // Stats are appended to, so start from a clean file.
+  std::remove((bench + "_mem_system_stats.txt").c_str());
+  ScratchpadDatapath* acc =
+      new ScratchpadDatapath(bench, trace_file, config_file);
+  int cycles = 0;
+  while (acc->buildDddg()) {
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    cycles += acc->getCurrentCycle();
+    acc->dumpStats();
+    acc->clearDatapath();
+  }
+  delete acc;
+  return cycles;
+}
+
+// Return the value of @stat in the memory system stats read from @in.
+static unsigned findStat(std::istream& in, const std::string& stat) {
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, stat.size() + 1, stat + ",") == 0)
+      return std::stoul(line.substr(stat.size() + 1));
+  }
+  return 0;
+}
+
+// Return the value of @stat in the memory system stats of @bench.
+static unsigned readMemStat(const std::string& bench, const std::string& stat) {
+  std::ifstream in(bench + "_mem_system_stats.txt");
+  return findStat(in, stat);
+}
+
+// Return the value of @stat in the current stats of @memory.
+static unsigned readMemStat(MemorySystemModel& memory,
+                            const std::string& stat) {
+  std::stringstream stats;
+  memory.dumpStats(stats);
+  return findStat(stats, stat);
+}
+
+SCENARIO("Test the memory system model", "[memory_system]") {
+  MemorySystemParams params;
+  params.cache_size = 1024;
+  params.cache_line_size = 64;
+  params.cache_assoc = 2;
+  params.cache_hit_latency = 1;
+  params.cache_miss_latency = 50;
+  params.cache_mshrs = 2;
+  params.tlb_entries = 2;
+  params.tlb_hit_latency = 0;
+  params.tlb_miss_latency = 10;
+  params.page_size = 4096;
+
+  GIVEN("A cache with two MSHRs") {
+    CacheModel cache(params);
+    WHEN("Three lines miss in the same cycle.") {
+      int first = cache.access(0x0, 0);
+      int merged = cache.access(0x8, 0);
+      int second = cache.access(0x40, 0);
+      int third = cache.access(0x80, 0);
+      THEN("The first two are filled after the miss latency, accesses to a "
+           "line being filled merge, and the third is refused.") {
+        REQUIRE(first == 50);
+        REQUIRE(merged == 50);
+        REQUIRE(second == 50);
+        REQUIRE(third == -1);
+        REQUIRE(cache.misses == 2);
+        REQUIRE(cache.merged_misses == 1);
+        REQUIRE(cache.mshr_stalls == 1);
+      }
+      AND_WHEN("The lines have been filled.") {
+        cache.retire(50);
+        THEN("They hit, and the MSHRs are free again.") {
+          REQUIRE(cache.access(0x10, 50) == 51);
+          REQUIRE(cache.access(0x80, 50) == 100);
+          REQUIRE(cache.hits == 1);
+        }
+      }
+    }
+    WHEN("An access spans two lines but only one MSHR is free.") {
+      cache.access(0x100, 0);
+      int spanning = cache.access(0x3c, 8, 0);
+      THEN("It is refused without allocating either line.") {
+        REQUIRE(spanning == -1);
+        REQUIRE(cache.misses == 1);
+        REQUIRE(cache.mshr_stalls == 1);
+      }
+      AND_WHEN("The MSHR is free again.") {
+        cache.retire(50);
+        THEN("Both lines miss.") {
+          REQUIRE(cache.access(0x3c, 8, 50) == 100);
+          REQUIRE(cache.misses == 3);
+        }
+      }
+    }
+    WHEN("More lines map to a set than it has ways.") {
+      // 1024 bytes, 2 ways of 64 byte lines: 8 sets, 512 bytes apart.
+      cache.access(0x0, 0);
+      cache.access(0x200, 0);
+      cache.retire(50);
+      cache.access(0x0, 50);
+      cache.access(0x400, 50);
+      cache.retire(100);
+      THEN("The least recently used line is evicted.") {
+        REQUIRE(cache.access(0x0, 100) == 101);
+        REQUIRE(cache.access(0x200, 100) == 150);
+      }
+    }
+  }
+  GIVEN("A TLB with two entries") {
+    TlbModel tlb(params);
+    THEN("Only the two most recently used pages hit.") {
+      REQUIRE(tlb.translate(0x0) == 10);
+      REQUIRE(tlb.translate(0x1000) == 10);
+      REQUIRE(tlb.translate(0x10) == 0);
+      REQUIRE(tlb.translate(0x2000) == 10);
+      REQUIRE(tlb.translate(0x1000) == 10);
+      REQUIRE(tlb.hits == 1);
+      REQUIRE(tlb.misses == 4);
+    }
+  }
+  GIVEN("A DMA engine") {
+    params.dma_setup_latency = 5;
+    params.dma_page_latency = 10;
+    params.dma_bandwidth = 16;
+    params.cache_line_flush_latency = 2;
+    DmaEngineModel dma(params);
+    WHEN("A load crosses a page boundary.") {
+      int done = dma.transfer(0x0ff0, 256, true, 0);
+      THEN("It costs the flush and setup plus two page requests.") {
+        // 4 lines flushed, then 16 and 240 bytes in two requests.
+        REQUIRE(done == 5 + 4 * 2 + (10 + 1) + (10 + 15));
+        REQUIRE(dma.requests == 2);
+      }
+      AND_WHEN("Another transfer is issued right away.") {
+        int next = dma.transfer(0x4000, 16, false, 1);
+        THEN("It waits for the first one to finish.") {
+          REQUIRE(next == done + 10 + 1);
+        }
+      }
+    }
+  }
+  GIVEN("A memory system that accepts one cache request per cycle") {
+    params.cache_bandwidth = 1;
+    MemorySystemModel memory(params);
+    THEN("The second request in a cycle is refused until the next cycle.") {
+      REQUIRE(memory.issueCacheAccess(0x0, 4, true, 0) == 60);
+      REQUIRE(memory.issueCacheAccess(0x4, 4, true, 0) == -1);
+      memory.step(1);
+      REQUIRE(memory.issueCacheAccess(0x4, 4, true, 1) == 60);
+      REQUIRE(memory.hasAccesses());
+    }
+  }
+  GIVEN("A memory system with one MSHR") {
+    params.cache_mshrs = 1;
+    MemorySystemModel memory(params);
+    WHEN("An access that spans two lines is retried until it issues.") {
+      REQUIRE(memory.issueCacheAccess(0x100, 4, true, 0) == 60);
+      REQUIRE(memory.issueCacheAccess(0x3c, 8, true, 0) == -1);
+      memory.step(1);
+      REQUIRE(memory.issueCacheAccess(0x3c, 8, true, 1) == -1);
+      memory.step(60);
+      int done = memory.issueCacheAccess(0x3c, 8, true, 60);
+      THEN("It issues once every MSHR is free, and only the attempt that "
+           "issues is counted.") {
+        REQUIRE(done == 110);
+        REQUIRE(readMemStat(memory, "cache_loads") == 2);
+        REQUIRE(readMemStat(memory, "cache_misses") == 3);
+        REQUIRE(readMemStat(memory, "cache_mshr_stalls") == 2);
+        REQUIRE(readMemStat(memory, "tlb_hits") == 1);
+        REQUIRE(readMemStat(memory, "tlb_misses") == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Test simulating cache and DMA arrays without gem5",
+         "[memory_system]") {
+  GIVEN("Triad with its arrays in a cache") {
+    std::string spad_config = writeConfig("config-triad-spad",
+                                          "cycle_time,1\n"
+                                          "partition,cyclic,a_acc,512,4,2\n"
+                                          "partition,cyclic,b_acc,512,4,2\n"
+                                          "partition,cyclic,c_acc,512,4,2\n"
+                                          "unrolling,triad,triad,2\n");
+    std::string cache_config = writeConfig("config-triad-cache",
+                                           "cycle_time,1\n"
+                                           "cache,a_acc,512\n"
+                                           "cache,b_acc,512\n"
+                                           "cache,c_acc,512\n"
+                                           "unrolling,triad,triad,2\n"
+                                           "cache_miss_latency,40\n");
+    int spad_cycles = simulate("outputs/triad-spad",
+                               "inputs/triad-128-trace.gz", spad_config);
+    int cache_cycles = simulate("outputs/triad-cache",
+                                "inputs/triad-128-trace.gz", cache_config);
+    THEN("The cache misses make it slower than with scratchpads.") {
+      REQUIRE(cache_cycles > spad_cycles + 40);
+      REQUIRE(readMemStat("outputs/triad-cache", "cache_loads") == 256);
+      REQUIRE(readMemStat("outputs/triad-cache", "cache_stores") == 128);
+      REQUIRE(readMemStat("outputs/triad-cache", "cache_misses") > 0);
+    }
+  }
+  GIVEN("Triad with DMA") {
+    std::ifstream in("inputs/config-triad-dma-p2-u2-P1");
+    std::stringstream base;
+    base << in.rdbuf();
+    std::string dma_config =
+        writeConfig("config-triad-dma-slow",
+                    base.str() + "dma_setup_latency,100\n"
+                                 "dma_bandwidth,8\n"
+                                 "dma_page_latency,20\n");
+    int default_cycles = simulate("outputs/triad-dma-default",
+                                  "inputs/triad-dma-trace.gz",
+                                  "inputs/config-triad-dma-p2-u2-P1");
+    int slow_cycles = simulate(
+        "outputs/triad-dma-slow", "inputs/triad-dma-trace.gz", dma_config);
+    THEN("Transfers are free by default, and cost cycles once the DMA engine "
+         "is configured.") {
+      // Each of the three 8kB arrays takes 1024 cycles at 8 bytes per cycle.
+      REQUIRE(slow_cycles >= default_cycles + 3 * 1024);
+      REQUIRE(readMemStat("outputs/triad-dma-slow", "dma_transfers") == 3);
+      REQUIRE(readMemStat("outputs/triad-dma-slow", "dma_requests") >= 6);
+    }
+  }
+}
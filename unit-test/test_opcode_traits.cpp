@@ -0,0 +1,66 @@
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+SCENARIO("Test the traits of opcodes", "[opcode_traits]") {
+  GIVEN("Nodes of different classes of opcodes") {
+    ExecNode load(0, LLVM_IR_Load);
+    ExecNode fdiv(1, LLVM_IR_FDiv);
+    ExecNode call(2, LLVM_IR_Call);
+    ExecNode dma_fence(3, LLVM_IR_DMAFence);
+    ExecNode move(4, LLVM_IR_Move);
+    THEN("Each one belongs to the classes of its opcode.") {
+      REQUIRE(load.is_memory_op());
+      REQUIRE(load.is_load_op());
+      REQUIRE(!load.is_store_op());
+      REQUIRE(!load.is_compute_op());
+
+      REQUIRE(fdiv.is_fp_op());
+      REQUIRE(fdiv.is_fp_div_op());
+      REQUIRE(fdiv.is_fp_mul_op());
+      REQUIRE(!fdiv.is_fp_add_op());
+      REQUIRE(fdiv.is_multicycle_op());
+      REQUIRE(fdiv.is_compute_op());
+
+      REQUIRE(call.is_call_op());
+      REQUIRE(call.is_branch_op());
+      REQUIRE(call.is_control_op());
+
+      REQUIRE(dma_fence.is_host_mem_op());
+      REQUIRE(dma_fence.is_dma_op());
+      REQUIRE(!dma_fence.is_memory_op());
+
+      REQUIRE(opcode_traits(LLVM_IR_Move) == 0);
+      REQUIRE(!move.is_compute_op());
+    }
+    WHEN("The opcode of a node changes.") {
+      move.set_microop(LLVM_IR_Add);
+      THEN("So do its traits.") {
+        REQUIRE(move.is_int_add_op());
+        REQUIRE(move.is_associative());
+        REQUIRE(move.is_compute_op());
+      }
+    }
+  }
+  GIVEN("Triad prepared for scheduling") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+    ScratchpadDatapath* acc =
+        new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    THEN("Every node has cached its latency at the configured cycle time.") {
+      float cycle_time = acc->getUserParams().cycle_time;
+      for (auto& node_pair : acc->getProgram().nodes) {
+        const ExecNode* node = node_pair.second;
+        REQUIRE(node->get_fu_node_latency() ==
+                node->fu_node_latency(cycle_time));
+      }
+    }
+    delete acc;
+  }
+}
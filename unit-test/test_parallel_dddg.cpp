@@ -0,0 +1,131 @@
+#include <fstream>
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+#include "SyntheticTrace.h"
+
+// Copy @config_file to outputs/ with parse_threads set to @num_threads and
+// return the name of the copy.
+std::string withParseThreads(const std::string& config_file,
+                             unsigned num_threads) {
+  mkdir("outputs", 0755);
+  std::string name = config_file.substr(config_file.rfind('/') + 1);
+  std::string copy =
+      "outputs/" + name + "-threads-" + std::to_string(num_threads);
+  std::ifstream in(config_file);
+  std::ofstream out(copy);
+  out << in.rdbuf() << "parse_threads," << num_threads << std::endl;
+  return copy;
+}
+
+// Everything the DDDG records about a node, in node id order, and every edge,
+// in the order the graph stores them.
+std::vector<std::string> describeGraph(const Program& prog) {
+  std::vector<std::string> description;
+  for (auto& node_it : prog.nodes) {
+    ExecNode* node = node_it.second;
+    std::stringstream str;
+    str << node->get_node_id() << " " << (int)node->get_microop() << " "
+        << node->get_line_num() << " " << node->get_loop_depth() << " "
+        << node->get_dynamic_invocation() << " "
+        << node->get_static_function()->get_name() << " "
+        << node->get_basic_block()->get_name();
+    if (node->get_array_label() != "")
+      str << " " << node->get_array_label();
+    if (node->is_memory_op())
+      str << " " << node->get_mem_access()->vaddr;
+    description.push_back(str.str());
+  }
+  auto edge_to_parid = get(boost::edge_name, prog.graph);
+  edge_iter edge_it, edge_end;
+  for (boost::tie(edge_it, edge_end) = edges(prog.graph); edge_it != edge_end;
+       ++edge_it) {
+    std::stringstream str;
+    str << prog.atVertex(source(*edge_it, prog.graph)) << " -> "
+        << prog.atVertex(target(*edge_it, prog.graph)) << " "
+        << (int)edge_to_parid[*edge_it];
+    description.push_back(str.str());
+  }
+  return description;
+}
+
+// Build the DDDG of @trace_file with @num_threads parse threads, schedule it,
+// and return the description of the graph. @cycles is set to the number of
+// cycles.
+std::vector<std::string> buildAndSchedule(const std::string& bench,
+                                          const std::string& trace_file,
+                                          const std::string& config_file,
+                                          unsigned num_threads,
+                                          unsigned& cycles) {
+  ScratchpadDatapath* acc = new ScratchpadDatapath(
+      bench, trace_file, withParseThreads(config_file, num_threads));
+  acc->buildDddg();
+  REQUIRE(acc->getNumParseThreads() == num_threads);
+  std::vector<std::string> description = describeGraph(acc->getProgram());
+  acc->globalOptimizationPass();
+  acc->prepareForScheduling();
+  while (!acc->step()) {}
+  cycles = acc->getCurrentCycle();
+  delete acc;
+  return description;
+}
+
+SCENARIO("Test parsing traces with several threads", "[parallel_dddg]") {
+  struct Case {
+    std::string bench;
+    std::string trace_file;
+    std::string config_file;
+  };
+  std::vector<Case> cases = {
+    { "outputs/triad-128", "inputs/triad-128-trace.gz",
+      "inputs/config-triad-p2-u2-P1" },
+    { "outputs/triad-dma", "inputs/triad-dma-trace.gz",
+      "inputs/config-triad-dma-p2-u2-P1" },
+    { "outputs/aes-aes", "inputs/aes-aes-trace.gz", "inputs/config-aes-aes" },
+    { "outputs/special-math-op", "inputs/special-math-op-trace.gz",
+      "inputs/config-special-math-op" },
+  };
+  for (auto& test : cases) {
+    GIVEN("The trace " + test.trace_file) {
+      unsigned sequential_cycles, parallel_cycles;
+      auto sequential = buildAndSchedule(test.bench, test.trace_file,
+                                         test.config_file, 1, sequential_cycles);
+      auto parallel = buildAndSchedule(test.bench, test.trace_file,
+                                       test.config_file, 4, parallel_cycles);
+      THEN("The graph is the same with four threads as with one.") {
+        REQUIRE(parallel.size() == sequential.size());
+        REQUIRE(parallel == sequential);
+      }
+      THEN("The schedule is the same.") {
+        REQUIRE(parallel_cycles == sequential_cycles);
+      }
+    }
+  }
+  GIVEN("A trace that is split in several batches") {
+    SyntheticTraceParams params;
+    params.trip_counts = { 32, 64 };
+    params.array_elements = 256;
+    params.fp_fraction = 0.5;
+    params.mem_dep_density = 0.5;
+    params.dma = true;
+    mkdir("outputs", 0755);
+    SyntheticTraceGenerator generator(params);
+    generator.writeConfig("outputs/synthetic-parallel.cfg");
+    generator.writeTrace("outputs/synthetic-parallel-trace.gz");
+    unsigned sequential_cycles, parallel_cycles;
+    auto sequential = buildAndSchedule(
+        "outputs/synthetic-parallel", "outputs/synthetic-parallel-trace.gz",
+        "outputs/synthetic-parallel.cfg", 1, sequential_cycles);
+    auto parallel = buildAndSchedule(
+        "outputs/synthetic-parallel", "outputs/synthetic-parallel-trace.gz",
+        "outputs/synthetic-parallel.cfg", 3, parallel_cycles);
+    THEN("The graph and schedule are the same with three threads as with one.") {
+      REQUIRE(parallel == sequential);
+      REQUIRE(parallel_cycles == sequential_cycles);
+    }
+  }
+}
@@ -1,98 +1,479 @@
-#include <sys/time.h>
+/* Host performance benchmarks.
+ *
+ * Runs Aladdin from trace parsing through dumpStats() on a set of benchmarks,
+ * each several times with profiling enabled, and reports the median, variance
+ * and fastest wall time of each phase:
+ *
+ *   parse      buildDddg()
+ *   optimize   globalOptimizationPass()
+ *   prepare    prepareForScheduling()
+ *   schedule   the step() loop
+ *   stats      dumpStats()
+ *   total      the sum of the above
+ *   calibrate  a fixed workload that does not run any Aladdin code, timed
+ *              before each repetition
+ *
+ * Each repetition runs in a new process. The speed of some phases depends on
+ * the memory layout of the process by tens of percent, so repetitions that
+ * shared one would all be fast or all be slow together. The repetitions of
+ * all benchmarks run round-robin, so that a period of system load is spread
+ * over every benchmark.
+ *
+ * Only the fastest repetitions are compared, since other processes can slow
+ * a repetition down but never speed it up. They are compared relative to the
+ * fastest calibration workload of the same benchmark, so that a baseline
+ * written on one machine, or under one system load, still applies on another.
+ * A benchmark whose phase grows by more than the threshold is marked SLOWER.
+ * Even its fastest repetition can be tens of percent off on a shared host, so
+ * only the geometric mean of the changes of a phase over all benchmarks is
+ * gated on: if that grows by more than the threshold, the phase is reported
+ * as a regression and the program exits with a nonzero status. Phases that
+ * take less than 5 milliseconds are left out, since their time is mostly
+ * noise.
+ *
+ * Usage:
+ *   ./test_performance [--reps=<n>] [--cases=<file>] [--filter=<name>]
+ *                      [--baseline=<file>] [--threshold=<fraction>]
+ *                      [--write-baseline=<file>]
+ *
+ *   --reps            Repetitions of each benchmark (default 5).
+ *   --cases           Run the benchmarks listed in this file instead of the
+ *                     bundled and synthetic traces. Each line is
+ *                     <name>,<trace>,<config>.
+ *   --filter          Only run benchmarks whose name contains this string.
+ *   --baseline        Compare against this baseline (default
+ *                     inputs/perf-baseline).
+ *   --threshold       Allowed slowdown of a phase (default 0.25 = 25%).
+ *   --write-baseline  Write the measured relative times as a new baseline
+ *                     file.
+ *
+ * By default, every trace in inputs/ is run, with the names and configurations
+ * listed in inputs/perf-cases. A trace missing from that file is an error.
+ * Besides the bundled traces, a few larger synthetic traces are generated into
+ * outputs/ before the benchmarks run (see SyntheticTrace.h).
+ *
+ * Baseline files have one line per phase:
+ *   <benchmark>,<phase>,<fastest time / fastest calibration workload>
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <set>
 #include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
 
 #include "DDDG.h"
+#include "Profiler.h"
 #include "Scratchpad.h"
 #include "ScratchpadDatapath.h"
+#include "SyntheticTrace.h"
 #include "file_func.h"
 
-#define RUN_TEST(TEST_NAME) \
-  run_test(#TEST_NAME, TEST_NAME)
+struct Benchmark {
+  std::string name;
+  std::string trace_file;
+  std::string config_file;
+};
 
-typedef int (*test_function)(void);
+// The phases of a run, in order, and the profiler phases they cover.
+const std::vector<std::pair<std::string, std::string>> phases = {
+  { "parse", "buildDddg" },
+  { "optimize", "globalOptimizationPass" },
+  { "prepare", "prepareForScheduling" },
+  { "schedule", "schedule" },
+  { "stats", "dumpStats" },
+};
 
-long run(test_function test) {
-  struct timeval start, end;
+// Phases that only take a few milliseconds are too noisy to compare, mostly
+// because of the time spent in file I/O.
+const double min_compared_time = 5e-3;
 
-  std::streambuf* old = std::cout.rdbuf();
-  std::stringstream redirect;
-  std::cout.rdbuf(redirect.rdbuf());
+const std::string inputs_dir("inputs");
+const std::string bundled_cases_file("inputs/perf-cases");
 
-  gettimeofday(&start, NULL);
-  test();
-  gettimeofday(&end, NULL);
+typedef std::vector<std::pair<std::string, SyntheticTraceParams>>
+    synthetic_benchmarks_t;
 
-  std::cout.rdbuf(old);
+// Synthetic benchmarks, generated when the suite starts.
+synthetic_benchmarks_t synthetic_benchmarks() {
+  synthetic_benchmarks_t benchmarks;
+  SyntheticTraceParams nest;
+  nest.trip_counts = { 8, 256 };
+  nest.array_elements = 1024;
+  nest.unroll_factor = 8;
+  nest.partition_factor = 8;
+  benchmarks.push_back({ "synthetic_nest", nest });
+  SyntheticTraceParams fp_deps;
+  fp_deps.trip_counts = { 2048 };
+  fp_deps.array_elements = 2048;
+  fp_deps.ops_per_iteration = 4;
+  fp_deps.fp_fraction = 0.5;
+  fp_deps.mem_dep_density = 0.25;
+  fp_deps.dma = true;
+  fp_deps.unroll_factor = 4;
+  fp_deps.partition_factor = 4;
+  fp_deps.pipelining = true;
+  benchmarks.push_back({ "synthetic_fp_deps_dma", fp_deps });
+  return benchmarks;
+}
 
-  long diff = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_usec - start.tv_usec);
-  return diff;
+std::vector<std::string> splitCsv(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ','))
+    fields.push_back(field);
+  return fields;
 }
 
-void run_test(const char* name, test_function test) {
+std::vector<Benchmark> readBenchmarks(const std::string& file_name) {
+  std::vector<Benchmark> benchmarks;
+  std::ifstream file(file_name);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::vector<std::string> fields = splitCsv(line);
+    if (fields.size() != 3) {
+      std::cerr << "[WARNING]: Ignoring benchmark line: " << line << std::endl;
+      continue;
+    }
+    benchmarks.push_back({ fields[0], fields[1], fields[2] });
+  }
+  return benchmarks;
+}
 
-  std::cout << name << " :\t";
-  long elapsed = run(test);
-  std::cout << elapsed << " usec.\n";
+// Return the traces in inputs/ that no benchmark in @benchmarks runs.
+std::vector<std::string> findMissingTraces(
+    const std::vector<Benchmark>& benchmarks) {
+  std::vector<std::string> missing;
+  DIR* dir = opendir(inputs_dir.c_str());
+  if (!dir)
+    return missing;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name.size() < 3 || name.compare(name.size() - 3, 3, ".gz") != 0)
+      continue;
+    std::string trace_file = inputs_dir + "/" + name;
+    bool found = false;
+    for (auto& benchmark : benchmarks)
+      found |= benchmark.trace_file == trace_file;
+    if (!found)
+      missing.push_back(trace_file);
+  }
+  closedir(dir);
+  std::sort(missing.begin(), missing.end());
+  return missing;
 }
 
+typedef std::map<std::pair<std::string, std::string>, double> baseline_t;
 
-void execute(ScratchpadDatapath* acc) {
-  acc->buildDddg();
-  acc->globalOptimizationPass();
-  acc->prepareForScheduling();
+baseline_t readBaseline(const std::string& file_name) {
+  baseline_t baseline;
+  std::ifstream file(file_name);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::vector<std::string> fields = splitCsv(line);
+    if (fields.size() == 3)
+      baseline[std::make_pair(fields[0], fields[1])] = std::stod(fields[2]);
+  }
+  return baseline;
 }
 
-int triad_dma() {
-  std::string bench("outputs/triad-dma");
-  std::string trace_file("inputs/triad-dma-trace.gz");
-  std::string config_file("inputs/config-triad-dma-p2-u2-P1");
+// Run @benchmark once and return the wall time of each phase, summed over all
+// invocations of the accelerator.
+std::map<std::string, double> runOnce(const Benchmark& benchmark) {
+  std::string bench("outputs/" + benchmark.name);
+  std::string trace_file(benchmark.trace_file);
+  std::string config_file(benchmark.config_file);
+
+  // Keep the output of the simulation out of the report.
+  std::streambuf* old_out = std::cout.rdbuf();
+  std::streambuf* old_err = std::cerr.rdbuf();
+  std::stringstream redirect;
+  std::cout.rdbuf(redirect.rdbuf());
+  std::cerr.rdbuf(redirect.rdbuf());
 
   ScratchpadDatapath* acc =
       new ScratchpadDatapath(bench, trace_file, config_file);
-  execute(acc);
+  acc->getProfiler().setEnabled(true);
+  while (acc->buildDddg()) {
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    acc->dumpStats();
+    acc->clearDatapath();
+  }
+
+  std::map<std::string, double> times;
+  for (auto& record : acc->getProfiler().getRecords()) {
+    for (auto& phase : phases) {
+      if (record.name == phase.second) {
+        times[phase.first] += record.wall_time;
+        times["total"] += record.wall_time;
+      }
+    }
+  }
   delete acc;
+
+  std::cout.rdbuf(old_out);
+  std::cerr.rdbuf(old_err);
+  return times;
 }
 
-int reduction() {
-  std::string bench("outputs/reduction-128");
-  std::string trace_file("inputs/reduction-128-trace.gz");
-  std::string config_file("inputs/config-reduction-p4-u4-P1");
+// Time a fixed workload that runs none of Aladdin's code, so it only measures
+// how fast the host is at the moment. Like the DDDG and its passes, it is
+// dominated by allocating and walking node-based containers.
+double runCalibration() {
+  auto start = std::chrono::steady_clock::now();
+  unsigned seed = 1;
+  std::map<unsigned, std::set<unsigned>> edges;
+  for (unsigned i = 0; i < (1 << 18); i++) {
+    seed = seed * 1103515245 + 12345;
+    edges[seed % 65536].insert(seed);
+  }
+  unsigned long sum = 0;
+  for (auto& node : edges) {
+    for (unsigned edge : node.second)
+      sum += edges.count(edge % 65536);
+  }
+  volatile unsigned long result = sum;
+  (void)result;
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
 
-  ScratchpadDatapath* acc =
-      new ScratchpadDatapath(bench, trace_file, config_file);
-  execute(acc);
-  delete acc;
+// Run @benchmark once in a new process started from @self, and return the
+// wall time of each phase, or nothing if the run failed.
+std::map<std::string, double> runInNewProcess(const std::string& self,
+                                              const Benchmark& benchmark) {
+  std::map<std::string, double> times;
+  std::string command = self + " --run-once=" + benchmark.name + "," +
+                        benchmark.trace_file + "," + benchmark.config_file;
+  FILE* pipe = popen(command.c_str(), "r");
+  if (!pipe)
+    return times;
+  char line[256];
+  while (fgets(line, sizeof(line), pipe)) {
+    std::vector<std::string> fields = splitCsv(line);
+    if (fields.size() == 2)
+      times[fields[0]] = std::stod(fields[1]);
+  }
+  if (pclose(pipe) != 0)
+    times.clear();
+  return times;
 }
 
-int pp_scan() {
-  std::string bench("outputs/pp_scan-128");
-  std::string trace_file("inputs/pp_scan-128-trace.gz");
-  std::string config_file("inputs/config-pp_scan-p4-u4-P1");
+double median(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  if (n % 2)
+    return samples[n / 2];
+  return (samples[n / 2 - 1] + samples[n / 2]) / 2;
+}
 
-  ScratchpadDatapath* acc =
-      new ScratchpadDatapath(bench, trace_file, config_file);
-  execute(acc);
-  delete acc;
+double variance(const std::vector<double>& samples) {
+  double mean = 0;
+  for (double sample : samples)
+    mean += sample;
+  mean /= samples.size();
+  double sum = 0;
+  for (double sample : samples)
+    sum += (sample - mean) * (sample - mean);
+  return sum / samples.size();
 }
 
-int aes() {
-  std::string bench("outputs/aes-aes");
-  std::string trace_file("inputs/aes-aes-trace.gz");
-  std::string config_file("inputs/config-aes-aes");
+int main(int argc, const char* argv[]) {
+  unsigned reps = 5;
+  float threshold = 0.25;
+  std::string cases_file(bundled_cases_file);
+  std::string filter;
+  std::string baseline_file("inputs/perf-baseline");
+  std::string new_baseline_file;
+  std::string run_once;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.compare(0, 7, "--reps=") == 0) {
+      reps = std::max(1, std::stoi(value));
+    } else if (arg.compare(0, 8, "--cases=") == 0) {
+      cases_file = value;
+    } else if (arg.compare(0, 9, "--filter=") == 0) {
+      filter = value;
+    } else if (arg.compare(0, 11, "--baseline=") == 0) {
+      baseline_file = value;
+    } else if (arg.compare(0, 12, "--threshold=") == 0) {
+      threshold = std::stof(value);
+    } else if (arg.compare(0, 17, "--write-baseline=") == 0) {
+      new_baseline_file = value;
+    } else if (arg.compare(0, 11, "--run-once=") == 0) {
+      // Used by runInNewProcess(): run one repetition of one benchmark and
+      // print the time of each phase.
+      run_once = value;
+    } else {
+      std::cerr << "[ERROR]: Unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
 
-  ScratchpadDatapath* acc =
-      new ScratchpadDatapath(bench, trace_file, config_file);
-  execute(acc);
-  delete acc;
-}
+  mkdir("outputs", 0755);
+  if (!run_once.empty()) {
+    std::vector<std::string> fields = splitCsv(run_once);
+    if (fields.size() != 3)
+      return 1;
+    std::cout << std::setprecision(9);
+    for (auto& time : runOnce({ fields[0], fields[1], fields[2] }))
+      std::cout << time.first << "," << time.second << std::endl;
+    return 0;
+  }
+  std::vector<Benchmark> benchmarks = readBenchmarks(cases_file);
+  if (cases_file == bundled_cases_file) {
+    std::vector<std::string> missing = findMissingTraces(benchmarks);
+    for (auto& trace_file : missing) {
+      std::cerr << "[ERROR]: " << trace_file << " is not listed in "
+                << bundled_cases_file << "." << std::endl;
+    }
+    if (!missing.empty())
+      return 1;
+    for (auto& synthetic : synthetic_benchmarks()) {
+      if (synthetic.first.find(filter) == std::string::npos)
+        continue;
+      Benchmark benchmark = { synthetic.first,
+                              "outputs/" + synthetic.first + "-trace.gz",
+                              "outputs/" + synthetic.first + ".cfg" };
+      SyntheticTraceGenerator generator(synthetic.second);
+      generator.writeTrace(benchmark.trace_file);
+      generator.writeConfig(benchmark.config_file);
+      benchmarks.push_back(benchmark);
+    }
+  }
+  baseline_t baseline = readBaseline(baseline_file);
+  baseline_t new_baseline;
 
-int main() {
-  RUN_TEST(aes);
-  RUN_TEST(pp_scan);
-  RUN_TEST(reduction);
-  RUN_TEST(triad_dma);
+  std::cout << std::left << std::setw(36) << "benchmark" << std::setw(10)
+            << "phase" << std::right << std::setw(13) << "median (ms)"
+            << std::setw(15) << "var (ms^2)" << std::setw(14)
+            << "fastest (ms)" << std::setw(15)
+            << "baseline (ms)" << std::setw(10) << "change" << std::endl;
+  std::cout << std::fixed;
 
-  return 0;
+  std::vector<Benchmark> selected;
+  for (auto& benchmark : benchmarks) {
+    if (benchmark.name.find(filter) != std::string::npos)
+      selected.push_back(benchmark);
+  }
+  // Run the repetitions round-robin, so that a period of system load slows
+  // one repetition of every benchmark rather than all of the repetitions of
+  // a few.
+  std::map<std::string, std::map<std::string, std::vector<double>>> results;
+  for (unsigned rep = 0; rep < reps; rep++) {
+    for (auto& benchmark : selected) {
+      auto& samples = results[benchmark.name];
+      samples["calibrate"].push_back(runCalibration());
+      std::map<std::string, double> times = runInNewProcess(argv[0], benchmark);
+      if (times.empty()) {
+        std::cerr << "[ERROR]: Benchmark " << benchmark.name << " failed."
+                  << std::endl;
+        return 1;
+      }
+      for (auto& time : times)
+        samples[time.first].push_back(time.second);
+    }
+  }
+
+  std::vector<std::string> report_phases;
+  for (auto& phase : phases)
+    report_phases.push_back(phase.first);
+  report_phases.push_back("total");
+  report_phases.push_back("calibrate");
+  // The sum of the logs of the relative changes of each phase, and the
+  // number of benchmarks they were measured on.
+  std::map<std::string, std::pair<double, unsigned>> changes;
+  for (auto& benchmark : selected) {
+    auto& samples = results[benchmark.name];
+    const std::vector<double>& calibrations = samples["calibrate"];
+    double calibration =
+        *std::min_element(calibrations.begin(), calibrations.end());
+
+    for (auto& phase : report_phases) {
+      if (samples[phase].empty())
+        continue;
+      double med = median(samples[phase]);
+      double fastest =
+          *std::min_element(samples[phase].begin(), samples[phase].end());
+      std::cout << std::left << std::setw(36) << benchmark.name
+                << std::setw(10) << phase << std::right << std::setw(13)
+                << std::setprecision(3) << med * 1e3 << std::setw(15)
+                << std::setprecision(5) << variance(samples[phase]) * 1e6
+                << std::setw(14) << std::setprecision(3) << fastest * 1e3;
+      if (phase == "calibrate") {
+        std::cout << std::endl;
+        continue;
+      }
+      new_baseline[std::make_pair(benchmark.name, phase)] =
+          fastest / calibration;
 
+      auto base_it = baseline.find(std::make_pair(benchmark.name, phase));
+      if (base_it == baseline.end()) {
+        std::cout << std::setw(15) << "-" << std::endl;
+        continue;
+      }
+      // The baseline time at the current speed of the host.
+      double base = base_it->second * calibration;
+      std::cout << std::setw(15) << std::setprecision(3) << base * 1e3
+                << std::setw(9) << std::setprecision(1) << std::showpos
+                << (fastest / base - 1) * 100 << "%" << std::noshowpos;
+      if (base > min_compared_time) {
+        changes[phase].first += std::log(fastest / base);
+        changes[phase].second++;
+        if (fastest > base * (1 + threshold))
+          std::cout << "  SLOWER";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  if (!new_baseline_file.empty()) {
+    std::ofstream out(new_baseline_file);
+    out << std::setprecision(9);
+    for (auto& entry : new_baseline) {
+      out << entry.first.first << "," << entry.first.second << ","
+          << entry.second << std::endl;
+    }
+  }
+
+  std::cout << std::endl << std::left << std::setw(10) << "phase"
+            << std::right << std::setw(12) << "benchmarks" << std::setw(14)
+            << "mean change" << std::endl;
+  unsigned regressions = 0;
+  for (auto& phase : report_phases) {
+    auto change_it = changes.find(phase);
+    if (change_it == changes.end())
+      continue;
+    double change =
+        std::exp(change_it->second.first / change_it->second.second) - 1;
+    std::cout << std::left << std::setw(10) << phase << std::right
+              << std::setw(12) << change_it->second.second << std::setw(13)
+              << std::setprecision(1) << std::showpos << change * 100 << "%"
+              << std::noshowpos;
+    if (change > threshold) {
+      std::cout << "  REGRESSION";
+      regressions++;
+    }
+    std::cout << std::endl;
+  }
+  if (regressions) {
+    std::cout << regressions << " phases regressed by more than "
+              << std::setprecision(1) << threshold * 100 << "%." << std::endl;
+    return 1;
+  }
+  return 0;
 }
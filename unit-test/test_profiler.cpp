@@ -0,0 +1,94 @@
+#include <sstream>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Profiler.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+// Find the record of the phase named @name, or nullptr.
+const Profiler::PhaseRecord* findPhase(const Profiler& profiler,
+                                       const std::string& name) {
+  for (auto& record : profiler.getRecords()) {
+    if (record.name == name)
+      return &record;
+  }
+  return nullptr;
+}
+
+SCENARIO("Test profiling the phases of a simulation w/ Triad", "[profile]") {
+  GIVEN("Test Triad w/ Input Size 128, cyclic partition with a factor of 2, "
+        "loop unrolling with a factor of 2, enable loop pipelining") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    Profiler& profiler = acc->getProfiler();
+    WHEN("Profiling is disabled.") {
+      acc->buildDddg();
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      acc->dumpStats();
+      THEN("Nothing is recorded.") {
+        REQUIRE(profiler.getRecords().empty());
+      }
+    }
+    WHEN("Profiling is enabled.") {
+      profiler.setEnabled(true);
+      acc->buildDddg();
+      acc->globalOptimizationPass();
+      acc->prepareForScheduling();
+      while (!acc->step()) {}
+      acc->dumpStats();
+      THEN("Parsing reports the size of the graph.") {
+        const Profiler::PhaseRecord* parse = findPhase(profiler, "buildDddg");
+        REQUIRE(parse != nullptr);
+        REQUIRE(parse->nodes == acc->getProgram().getNumNodes());
+        REQUIRE(parse->wall_time > 0);
+        REQUIRE(parse->peak_rss > 0);
+      }
+      THEN("Each graph optimization is nested under the optimization pass.") {
+        REQUIRE(findPhase(profiler, "globalOptimizationPass") != nullptr);
+        REQUIRE(findPhase(profiler, "globalOptimizationPass/LoopUnrolling") !=
+                nullptr);
+        REQUIRE(findPhase(profiler,
+                          "globalOptimizationPass/TreeHeightReduction") !=
+                nullptr);
+      }
+      THEN("The step loop reports the number of cycles.") {
+        const Profiler::PhaseRecord* schedule = findPhase(profiler, "schedule");
+        REQUIRE(schedule != nullptr);
+        REQUIRE(findPhase(profiler, "prepareForScheduling") != nullptr);
+        REQUIRE(schedule->cycles == acc->getCurrentCycle());
+      }
+      THEN("Each step of dumpStats is recorded.") {
+        REQUIRE(findPhase(profiler, "dumpStats/computeRegStats") != nullptr);
+        REQUIRE(findPhase(profiler, "dumpStats/writePerCycleActivity") !=
+                nullptr);
+      }
+      THEN("Every phase is written to the JSON output.") {
+        std::stringstream json;
+        profiler.writeJson(json);
+        REQUIRE(json.str().find("\"benchmark\": \"outputs/triad-128\"") !=
+                std::string::npos);
+        REQUIRE(json.str().find("\"name\": \"schedule\"") != std::string::npos);
+        REQUIRE(json.str().find("\"cycles_per_s\"") != std::string::npos);
+      }
+    }
+    WHEN("A second invocation finds the end of the trace.") {
+      profiler.setEnabled(true);
+      acc->buildDddg();
+      acc->clearDatapath();
+      size_t num_records = profiler.getRecords().size();
+      REQUIRE(!acc->buildDddg());
+      THEN("No phase is recorded for it.") {
+        REQUIRE(profiler.getRecords().size() == num_records);
+      }
+    }
+    delete acc;
+  }
+}
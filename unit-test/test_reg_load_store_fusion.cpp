@@ -16,8 +16,7 @@ SCENARIO("Test register load/store fusion", "[reg_ls_fusion]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removePhiNodes();
-    acc->removeInductionDependence();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->completePartition();
     acc->scratchpadPartition();
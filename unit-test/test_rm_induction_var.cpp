@@ -4,7 +4,7 @@
 #include "Scratchpad.h"
 #include "ScratchpadDatapath.h"
 
-SCENARIO("Test removeInductionVariable w/ Triad", "[triad]") {
+SCENARIO("Test induction marking w/ Triad", "[triad]") {
   GIVEN("Test Triad w/ Input Size 128") {
     std::string bench("outputs/triad-128");
     std::string trace_file("inputs/triad-128-trace.gz");
@@ -15,8 +15,7 @@ SCENARIO("Test removeInductionVariable w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    WHEN("Test removeInductionDependence()") {
-      acc->removeInductionDependence();
+    WHEN("The DDDG is built") {
       THEN("Addition w/ Induction Variable should be converted to "
            "LLVM_IR_IndexAdd.") {
         REQUIRE(prog.nodes.at(16)->get_microop() == LLVM_IR_IndexAdd);
@@ -26,7 +25,7 @@ SCENARIO("Test removeInductionVariable w/ Triad", "[triad]") {
     }
   }
 }
-SCENARIO("Test removeInductionVariable w/ Reduction", "[reduction]") {
+SCENARIO("Test induction marking w/ Reduction", "[reduction]") {
   GIVEN("Test Reduction w/ Input Size 128") {
     std::string bench("outputs/reduction-128");
     std::string trace_file("inputs/reduction-128-trace.gz");
@@ -37,8 +36,7 @@ SCENARIO("Test removeInductionVariable w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    WHEN("Test removeInductionDependence()") {
-      acc->removeInductionDependence();
+    WHEN("The DDDG is built") {
       THEN("Addition w/ Induction Variable should be converted to "
            "LLVM_IR_IndexAdd.") {
         REQUIRE(prog.nodes.at(9)->get_microop() == LLVM_IR_IndexAdd);
@@ -48,7 +46,7 @@ SCENARIO("Test removeInductionVariable w/ Reduction", "[reduction]") {
     }
   }
 }
-SCENARIO("Test removeInductionVariable w/ Pp_scan", "[pp_scan]") {
+SCENARIO("Test induction marking w/ Pp_scan", "[pp_scan]") {
   GIVEN("Test Pp_scan w/ Input Size 128") {
     std::string bench("outputs/pp_scan-128");
     std::string trace_file("inputs/pp_scan-128-trace.gz");
@@ -59,8 +57,7 @@ SCENARIO("Test removeInductionVariable w/ Pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    WHEN("Test removeInductionDependence()") {
-      acc->removeInductionDependence();
+    WHEN("The DDDG is built") {
       THEN("Addition w/ Induction Variable should be converted to "
            "LLVM_IR_IndexAdd.") {
         REQUIRE(prog.nodes.at(18)->get_microop() == LLVM_IR_IndexAdd);
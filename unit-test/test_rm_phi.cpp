@@ -4,7 +4,7 @@
 #include "Scratchpad.h"
 #include "ScratchpadDatapath.h"
 
-SCENARIO("Test removePhiNodes w/ Triad", "[triad]") {
+SCENARIO("Test PHI node elision w/ Triad", "[triad]") {
   GIVEN("Test Triad w/ Input Size 128") {
     std::string bench("outputs/triad-128");
     std::string trace_file("inputs/triad-128-trace.gz");
@@ -15,18 +15,16 @@ SCENARIO("Test removePhiNodes w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    WHEN("Test removePhiNodes()") {
-      acc->removePhiNodes();
-      THEN("Phi Nodes in the DDDG should be isolated.") {
-        REQUIRE(prog.getNumConnectedNodes(19) == 0);
-        REQUIRE(prog.getNumConnectedNodes(31) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1531) == 0);
+    WHEN("The DDDG is built") {
+      THEN("Phi nodes should not be added to the DDDG.") {
+        REQUIRE(prog.nodes.find(19) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(31) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1531) == prog.nodes.end());
       }
     }
   }
 }
-SCENARIO("Test removePhiNodes w/ Reduction", "[reduction]") {
+SCENARIO("Test PHI node elision w/ Reduction", "[reduction]") {
   GIVEN("Test Reduction w/ Input Size 128") {
     std::string bench("outputs/reduction-128");
     std::string trace_file("inputs/reduction-128-trace.gz");
@@ -37,19 +35,17 @@ SCENARIO("Test removePhiNodes w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    WHEN("Test removePhiNodes()") {
-      acc->removePhiNodes();
-      THEN("Phi Nodes in the DDDG should be isolated.") {
-        REQUIRE(prog.getNumConnectedNodes(4) == 0);
-        REQUIRE(prog.getNumConnectedNodes(13) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1012) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1021) == 0);
+    WHEN("The DDDG is built") {
+      THEN("Phi nodes should not be added to the DDDG.") {
+        REQUIRE(prog.nodes.find(4) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(13) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1012) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1021) == prog.nodes.end());
       }
     }
   }
 }
-SCENARIO("Test removePhiNodes w/ Pp_scan", "[pp_scan]") {
+SCENARIO("Test PHI node elision w/ Pp_scan", "[pp_scan]") {
   GIVEN("Test Pp_scan w/ Input Size 128") {
     std::string bench("outputs/pp_scan-128");
     std::string trace_file("inputs/pp_scan-128-trace.gz");
@@ -60,16 +56,14 @@ SCENARIO("Test removePhiNodes w/ Pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    WHEN("Test removePhiNodes()") {
-      acc->removePhiNodes();
-      THEN("Phi Nodes in the DDDG should be isolated.") {
-        REQUIRE(prog.getNumConnectedNodes(5) == 0);
-        REQUIRE(prog.getNumConnectedNodes(22) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1482) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1504) == 0);
-        REQUIRE(prog.getNumConnectedNodes(1749) == 0);
-        REQUIRE(prog.getNumConnectedNodes(2818) == 0);
+    WHEN("The DDDG is built") {
+      THEN("Phi nodes should not be added to the DDDG.") {
+        REQUIRE(prog.nodes.find(5) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(22) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1482) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1504) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(1749) == prog.nodes.end());
+        REQUIRE(prog.nodes.find(2818) == prog.nodes.end());
       }
     }
   }
@@ -0,0 +1,135 @@
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+// Check that @restored has the same nodes, edges and schedule as @original.
+void requireSameProgram(const Program& original, const Program& restored) {
+  REQUIRE(restored.nodes.size() == original.nodes.size());
+  REQUIRE(restored.getNumEdges() == original.getNumEdges());
+  for (auto& node_pair : original.nodes) {
+    const ExecNode* node = node_pair.second;
+    const ExecNode* copy = restored.nodes.at(node_pair.first);
+    REQUIRE(copy->get_microop() == node->get_microop());
+    REQUIRE(copy->get_start_execution_cycle() ==
+            node->get_start_execution_cycle());
+    REQUIRE(copy->get_complete_execution_cycle() ==
+            node->get_complete_execution_cycle());
+    REQUIRE(copy->get_line_num() == node->get_line_num());
+    REQUIRE(copy->get_array_label() == node->get_array_label());
+    REQUIRE(copy->get_partition_index() == node->get_partition_index());
+    REQUIRE(copy->is_inductive() == node->is_inductive());
+    if (node->get_static_function()) {
+      REQUIRE(copy->get_static_function()->get_name() ==
+              node->get_static_function()->get_name());
+    }
+    if (node->get_mem_access()) {
+      REQUIRE(copy->get_mem_access()->vaddr == node->get_mem_access()->vaddr);
+      REQUIRE(copy->get_mem_access()->size == node->get_mem_access()->size);
+    }
+    if (node->is_dma_op() && node->get_host_mem_access()) {
+      REQUIRE(copy->get_host_mem_access()->src_addr ==
+              node->get_host_mem_access()->src_addr);
+      REQUIRE(copy->get_host_mem_access()->src_var->get_name() ==
+              node->get_host_mem_access()->src_var->get_name());
+    }
+
+    std::vector<unsigned> children = original.getChildNodes(node_pair.first);
+    REQUIRE(restored.getChildNodes(node_pair.first).size() == children.size());
+    for (unsigned child : children) {
+      REQUIRE(restored.getEdgeWeight(node_pair.first, child) ==
+              original.getEdgeWeight(node_pair.first, child));
+    }
+  }
+  REQUIRE(restored.loop_bounds.size() == original.loop_bounds.size());
+  for (unsigned i = 0; i < original.loop_bounds.size(); i++) {
+    REQUIRE(restored.loop_bounds[i].node_id ==
+            original.loop_bounds[i].node_id);
+    REQUIRE(restored.loop_bounds[i].target_loop_depth ==
+            original.loop_bounds[i].target_loop_depth);
+  }
+  REQUIRE(restored.labelmap.size() == original.labelmap.size());
+}
+
+SCENARIO("Test schedule snapshots w/ Triad", "[snapshot]") {
+  GIVEN("Test Triad w/ Input Size 128, cyclic partition with a factor of 2, "
+        "loop unrolling with a factor of 2, enable loop pipelining") {
+    std::string bench("outputs/triad-128");
+    std::string trace_file("inputs/triad-128-trace.gz");
+    std::string config_file("inputs/config-triad-p2-u2-P1");
+    std::string snapshot_file("outputs/triad-128_snapshot");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->setSnapshotFile(snapshot_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    acc->dumpStats();
+    WHEN("The snapshot is loaded into a datapath without a trace.") {
+      std::string no_trace;
+      ScratchpadDatapath* restored =
+          new ScratchpadDatapath(bench, no_trace, config_file);
+      restored->loadSnapshot(snapshot_file);
+      THEN("The scheduled program is the same.") {
+        REQUIRE(restored->getCurrentCycle() == acc->getCurrentCycle());
+        requireSameProgram(acc->getProgram(), restored->getProgram());
+      }
+      THEN("Loops and functions are found in the restored program.") {
+        const Program& original = acc->getProgram();
+        const Program& prog = restored->getProgram();
+        auto label_it = original.labelmap.begin();
+        auto restored_it = prog.labelmap.begin();
+        for (; label_it != original.labelmap.end();
+             ++label_it, ++restored_it) {
+          REQUIRE(restored_it->second.get_label()->get_name() ==
+                  label_it->second.get_label()->get_name());
+          auto bounds = original.findLoopBoundaries(label_it->second);
+          auto restored_bounds = prog.findLoopBoundaries(restored_it->second);
+          REQUIRE(restored_bounds.size() == bounds.size());
+          if (!bounds.empty()) {
+            REQUIRE(restored_bounds.front().first->get_node_id() ==
+                    bounds.front().first->get_node_id());
+          }
+        }
+        auto& srcManager = restored->get_source_manager();
+        REQUIRE(prog.findFunctionBoundaries(
+                        srcManager.get<SrcTypes::Function>("triad")).size() ==
+                1);
+      }
+      delete restored;
+    }
+    delete acc;
+  }
+}
+
+SCENARIO("Test schedule snapshots w/ DMA", "[snapshot]") {
+  GIVEN("Test Triad with DMA loads and stores") {
+    std::string bench("outputs/triad-dma");
+    std::string trace_file("inputs/triad-dma-trace.gz");
+    std::string config_file("inputs/config-triad-dma-p2-u2-P1");
+    std::string snapshot_file("outputs/triad-dma_snapshot");
+
+    ScratchpadDatapath* acc;
+    acc = new ScratchpadDatapath(bench, trace_file, config_file);
+    acc->setSnapshotFile(snapshot_file);
+    acc->buildDddg();
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    acc->dumpStats();
+    WHEN("The snapshot is loaded into a datapath without a trace.") {
+      std::string no_trace;
+      ScratchpadDatapath* restored =
+          new ScratchpadDatapath(bench, no_trace, config_file);
+      restored->loadSnapshot(snapshot_file);
+      THEN("The DMA nodes keep their host memory accesses.") {
+        requireSameProgram(acc->getProgram(), restored->getProgram());
+      }
+      delete restored;
+    }
+    delete acc;
+  }
+}
@@ -0,0 +1,195 @@
+#include <vector>
+
+#include "catch.hpp"
+#include "Scratchpad.h"
+
+// The value of word @i of the test data.
+static uint32_t wordValue(unsigned i) { return 0x1000 + i * 7; }
+
+SCENARIO("Test reading and writing scratchpad data", "[scratchpad_data]") {
+  const Addr base_addr = 0x10000;
+  const unsigned word_size = 4;
+  const unsigned num_words = 30;
+  std::vector<uint32_t> words(num_words);
+  for (unsigned i = 0; i < num_words; i++)
+    words[i] = wordValue(i);
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(words.data());
+
+  for (PartitionType type : { cyclic, block }) {
+    for (unsigned factor : { 1, 4 }) {
+      GIVEN("A " + std::string(type == cyclic ? "cyclic" : "block") +
+            " partitioned array with " + std::to_string(factor) +
+            " partitions and an uneven number of words") {
+        Scratchpad spad(1, 1, false);
+        spad.setScratchpad(
+            "array", base_addr, type, factor, num_words * word_size, word_size);
+        WHEN("The whole array is written at once.") {
+          spad.writeData("array", base_addr, bytes, num_words * word_size);
+          THEN("Every word reads back on its own.") {
+            for (unsigned i = 0; i < num_words; i++) {
+              uint32_t word = 0;
+              spad.readData("array", base_addr + i * word_size, word_size,
+                            reinterpret_cast<uint8_t*>(&word));
+              REQUIRE(word == wordValue(i));
+            }
+          }
+          THEN("A range that crosses partitions reads back at once.") {
+            std::vector<uint32_t> range(num_words - 5, 0);
+            spad.readData("array", base_addr + 3 * word_size,
+                          range.size() * word_size,
+                          reinterpret_cast<uint8_t*>(range.data()));
+            for (unsigned i = 0; i < range.size(); i++)
+              REQUIRE(range[i] == wordValue(i + 3));
+          }
+        }
+        WHEN("An access runs past the end of the array.") {
+          THEN("It is rejected.") {
+            REQUIRE_THROWS_AS(spad.writeData("array",
+                                             base_addr + word_size,
+                                             bytes,
+                                             num_words * word_size),
+                              ArrayAccessException);
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A cyclic partitioned array in ready mode") {
+    Scratchpad spad(1, 1, true);
+    spad.setScratchpad(
+        "array", base_addr, cyclic, 2, num_words * word_size, word_size);
+    WHEN("The first half of the array is written.") {
+      spad.resetReadyBitRange("array", base_addr, num_words * word_size);
+      spad.writeData("array", base_addr, bytes, num_words / 2 * word_size);
+      THEN("Only the written words are ready.") {
+        for (unsigned i = 0; i < num_words; i++) {
+          Addr addr = base_addr + i * word_size;
+          unsigned part = spad.getPartitionIndex("array", addr);
+          REQUIRE(spad.canServicePartition("array", part, addr, true) ==
+                  (i < num_words / 2));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test setting and resetting ranges of ready bits",
+         "[scratchpad_data]") {
+  const Addr base_addr = 0x20000;
+  const unsigned word_size = 8;
+  // Enough words that every partition spans several 64-bit bitmap words.
+  const unsigned num_words = 603;
+  const unsigned first = 37;
+  const unsigned count = 401;
+
+  for (PartitionType type : { cyclic, block }) {
+    for (unsigned factor : { 1, 4 }) {
+      GIVEN("A " + std::string(type == cyclic ? "cyclic" : "block") +
+            " partitioned array with " + std::to_string(factor) +
+            " partitions in ready mode") {
+        Scratchpad spad(1, 1, true);
+        spad.setScratchpad(
+            "array", base_addr, type, factor, num_words * word_size, word_size);
+        auto ready = [&](unsigned i) {
+          Addr addr = base_addr + i * word_size;
+          unsigned part = spad.getPartitionIndex("array", addr);
+          return spad.canServicePartition("array", part, addr, true);
+        };
+        WHEN("All ready bits are reset and then a range is set.") {
+          spad.resetReadyBits("array");
+          spad.setReadyBitRange(
+              "array", base_addr + first * word_size, count * word_size);
+          THEN("Exactly the words in the range are ready.") {
+            for (unsigned i = 0; i < num_words; i++)
+              REQUIRE(ready(i) == (i >= first && i < first + count));
+          }
+          AND_WHEN("A range inside it is reset.") {
+            spad.resetReadyBitRange(
+                "array", base_addr + (first + 70) * word_size, 130 * word_size);
+            THEN("Only the rest of the range is still ready.") {
+              for (unsigned i = 0; i < num_words; i++) {
+                bool in_range = i >= first && i < first + count;
+                bool in_hole = i >= first + 70 && i < first + 200;
+                REQUIRE(ready(i) == (in_range && !in_hole));
+              }
+            }
+          }
+        }
+        WHEN("All ready bits are set.") {
+          spad.setReadyBits("array");
+          THEN("The whole array is ready.") {
+            for (unsigned i = 0; i < num_words; i++)
+              REQUIRE(ready(i));
+          }
+        }
+        WHEN("A range runs past the end of the array.") {
+          THEN("It is rejected.") {
+            REQUIRE_THROWS_AS(spad.setReadyBitRange("array",
+                                                    base_addr + word_size,
+                                                    num_words * word_size),
+                              ArrayAccessException);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test decoding scratchpad accesses", "[scratchpad_data]") {
+  const Addr base_addr = 0x30000;
+  const unsigned num_words = 103;
+
+  for (PartitionType type : { cyclic, block }) {
+    for (unsigned factor : { 1, 3, 4 }) {
+      for (unsigned word_size : { 4, 12 }) {
+        GIVEN("A " + std::string(type == cyclic ? "cyclic" : "block") +
+              " partitioned array with " + std::to_string(factor) +
+              " partitions and " + std::to_string(word_size) + " byte words") {
+          Scratchpad spad(1, 1, false);
+          spad.setScratchpad("other", 0x1000, cyclic, 2, 64, 4);
+          spad.setScratchpad("array", base_addr, type, factor,
+                             num_words * word_size, word_size);
+          WHEN("Every word is decoded.") {
+            THEN("It lands in the same partition and block as a linear "
+                 "walk over the partitions.") {
+              // Block partitions hold num_words / factor words each, and the
+              // remainder goes to the first partitions.
+              unsigned part = 0, blk = 0;
+              for (unsigned i = 0; i < num_words; i++) {
+                Addr addr = base_addr + i * word_size + word_size - 1;
+                SpadAccessDescriptor access = spad.decodeAccess("array", addr);
+                if (type == cyclic) {
+                  part = i % factor;
+                  blk = i / factor;
+                } else {
+                  unsigned part_words =
+                      num_words / factor + (part < num_words % factor);
+                  if (blk == part_words) {
+                    part++;
+                    blk = 0;
+                  }
+                }
+                REQUIRE(access.part_index == part);
+                REQUIRE(access.blk_index == blk);
+                REQUIRE(spad.getPartitionIndex("array", addr) == part);
+                if (type == block)
+                  blk++;
+              }
+            }
+          }
+          WHEN("An address outside the array is decoded.") {
+            THEN("It is rejected.") {
+              REQUIRE_THROWS_AS(
+                  spad.decodeAccess("array", base_addr + num_words * word_size),
+                  ArrayAccessException);
+              REQUIRE_THROWS_AS(spad.decodeAccess("array", base_addr - 1),
+                                ArrayAccessException);
+              REQUIRE_THROWS_AS(spad.decodeAccess("missing", base_addr),
+                                UnknownArrayException);
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -16,8 +16,7 @@ SCENARIO("Test scratchpadPartition w/ Triad", "[triad]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     WHEN("Test scratchpadPartition()") {
       acc->scratchpadPartition();
@@ -61,8 +60,7 @@ SCENARIO("Test scratchpadPartition w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     WHEN("Test scratchpadPartition()") {
       acc->scratchpadPartition();
@@ -92,8 +90,7 @@ SCENARIO("Test scratchpadPartition w/ pp_scan", "[pp_scan]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     WHEN("Test scratchpadPartition()") {
       acc->scratchpadPartition();
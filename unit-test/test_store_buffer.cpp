@@ -14,8 +14,7 @@ SCENARIO("Test store buffering", "[sb]") {
   acc = new ScratchpadDatapath(bench, trace_file, config_file);
   auto& prog = acc->getProgram();
   acc->buildDddg();
-  acc->removeInductionDependence();
-  acc->removePhiNodes();
+  acc->removeDeadNodes();
   acc->initBaseAddress();
   acc->scratchpadPartition();
   acc->loopFlatten();
@@ -0,0 +1,156 @@
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+#include "SyntheticTrace.h"
+
+// Generate a trace and config named after @name from @params, and return the
+// number of nodes in the trace.
+long generate(const std::string& name,
+              const SyntheticTraceParams& params,
+              const std::string& trace_ext = "-trace.gz") {
+  mkdir("outputs", 0755);
+  SyntheticTraceGenerator generator(params);
+  generator.writeConfig("outputs/" + name + ".cfg");
+  return generator.writeTrace("outputs/" + name + trace_ext);
+}
+
+// Simulate a trace generated by generate() and return the number of cycles.
+unsigned simulate(const std::string& name,
+                  const std::string& trace_ext = "-trace.gz") {
+  ScratchpadDatapath* acc = new ScratchpadDatapath(
+      "outputs/" + name, "outputs/" + name + trace_ext,
+      "outputs/" + name + ".cfg");
+  acc->buildDddg();
+  acc->globalOptimizationPass();
+  acc->prepareForScheduling();
+  while (!acc->step()) {}
+  unsigned cycles = acc->getCurrentCycle();
+  delete acc;
+  return cycles;
+}
+
+SCENARIO("Test synthetic traces", "[synthetic]") {
+  GIVEN("A two level loop nest over two inputs") {
+    SyntheticTraceParams params;
+    params.trip_counts = { 4, 16 };
+    params.array_elements = 64;
+    WHEN("The trace is parsed.") {
+      long num_nodes = generate("synthetic-nest", params);
+      ScratchpadDatapath* acc = new ScratchpadDatapath(
+          "outputs/synthetic-nest", "outputs/synthetic-nest-trace.gz",
+          "outputs/synthetic-nest.cfg");
+      acc->buildDddg();
+      auto& prog = acc->getProgram();
+      THEN("Every generated node but the PHIs is in the graph.") {
+        // Each iteration of both loops starts with a PHI for its induction
+        // variable.
+        REQUIRE(prog.getNumNodes() == num_nodes - (4 + 4 * 16));
+      }
+      THEN("Every loop is in the label map.") {
+        REQUIRE(prog.labelmap.size() == 2);
+      }
+      THEN("Each iteration's store depends on its loads.") {
+        // Nodes 6-14 are the body of the first inner iteration: the index, two
+        // GEPs and loads, the add and mul, and the output GEP and store.
+        REQUIRE(prog.nodes.at(8)->is_load_op());
+        REQUIRE(prog.nodes.at(14)->is_store_op());
+        REQUIRE(prog.edgeExists(8, 11));
+        REQUIRE(prog.edgeExists(12, 14));
+        REQUIRE(prog.edgeExists(13, 14));
+      }
+      delete acc;
+    }
+    WHEN("The trace is written without compression.") {
+      long compressed = generate("synthetic-nest", params);
+      long plain = generate("synthetic-nest", params, "-trace");
+      THEN("It has the same nodes and schedule as the gzipped trace.") {
+        REQUIRE(plain == compressed);
+        REQUIRE(simulate("synthetic-nest", "-trace") ==
+                simulate("synthetic-nest"));
+      }
+    }
+    WHEN("The innermost loop is unrolled further.") {
+      params.unroll_factor = 1;
+      generate("synthetic-u1", params);
+      unsigned rolled = simulate("synthetic-u1");
+      params.unroll_factor = 4;
+      params.partition_factor = 4;
+      generate("synthetic-u4", params);
+      unsigned unrolled = simulate("synthetic-u4");
+      THEN("The schedule is shorter.") {
+        REQUIRE(unrolled < rolled);
+      }
+    }
+    WHEN("Iterations depend on the previous iteration's store.") {
+      params.unroll_factor = 4;
+      params.partition_factor = 4;
+      generate("synthetic-nodeps", params);
+      unsigned independent = simulate("synthetic-nodeps");
+      params.mem_dep_density = 1;
+      generate("synthetic-deps", params);
+      unsigned dependent = simulate("synthetic-deps");
+      THEN("The iterations are serialized.") {
+        REQUIRE(dependent > independent);
+      }
+    }
+    WHEN("The same seed is used twice.") {
+      params.fp_fraction = 0.5;
+      params.mem_dep_density = 0.5;
+      long first = generate("synthetic-seed", params);
+      long second = generate("synthetic-seed", params);
+      THEN("The same trace is generated.") {
+        REQUIRE(first == second);
+      }
+    }
+  }
+  GIVEN("A single loop with DMA") {
+    SyntheticTraceParams params;
+    params.trip_counts = { 32 };
+    params.array_elements = 32;
+    params.dma = true;
+    WHEN("The inputs are copied in with DMA.") {
+      generate("synthetic-dma", params);
+      ScratchpadDatapath* acc = new ScratchpadDatapath(
+          "outputs/synthetic-dma", "outputs/synthetic-dma-trace.gz",
+          "outputs/synthetic-dma.cfg");
+      acc->buildDddg();
+      auto& prog = acc->getProgram();
+      THEN("The trace starts with a dmaLoad per input and a fence.") {
+        REQUIRE(prog.nodes.at(0)->is_dma_load());
+        REQUIRE(prog.nodes.at(1)->is_dma_load());
+        REQUIRE(prog.nodes.at(2)->is_dma_fence());
+      }
+      THEN("The fence waits for every dmaLoad.") {
+        REQUIRE(prog.edgeExists(0, 2));
+        REQUIRE(prog.edgeExists(1, 2));
+      }
+      delete acc;
+      THEN("The trace can be scheduled.") {
+        REQUIRE(simulate("synthetic-dma") > 0);
+      }
+    }
+    WHEN("The ready bits are reset before the DMA.") {
+      params.ready_bits = true;
+      generate("synthetic-ready", params);
+      ScratchpadDatapath* acc = new ScratchpadDatapath(
+          "outputs/synthetic-ready", "outputs/synthetic-ready-trace.gz",
+          "outputs/synthetic-ready.cfg");
+      acc->buildDddg();
+      auto& prog = acc->getProgram();
+      THEN("Each dmaLoad follows a setReadyBits on the same array.") {
+        REQUIRE(prog.nodes.at(0)->is_set_ready_bits());
+        REQUIRE(prog.nodes.at(1)->is_dma_load());
+        REQUIRE(prog.nodes.at(2)->is_set_ready_bits());
+        REQUIRE(prog.nodes.at(3)->is_dma_load());
+      }
+      delete acc;
+      THEN("The trace can be scheduled.") {
+        REQUIRE(simulate("synthetic-ready") > 0);
+      }
+    }
+  }
+}
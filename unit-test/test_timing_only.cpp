@@ -0,0 +1,129 @@
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "catch.hpp"
+#include "DDDG.h"
+#include "file_func.h"
+#include "Scratchpad.h"
+#include "ScratchpadDatapath.h"
+
+// Copy @config_file to outputs/ with timing_only enabled and return the name
+// of the copy.
+std::string withTimingOnly(const std::string& config_file) {
+  mkdir("outputs", 0755);
+  std::string name = config_file.substr(config_file.rfind('/') + 1);
+  std::string copy = "outputs/" + name + "-timing-only";
+  std::ifstream in(config_file);
+  std::ofstream out(copy);
+  out << in.rdbuf() << "timing_only,1" << std::endl;
+  return copy;
+}
+
+// Read the summary of @bench, without the lines naming the benchmark.
+std::string readTimingSummary(const std::string& bench) {
+  std::ifstream in(bench + "_summary");
+  std::stringstream summary;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 9, "Running :") != 0)
+      summary << line << "\n";
+  }
+  return summary.str();
+}
+
+// Simulate every invocation of @trace_file and return the number of memory
+// nodes of the first invocation that kept their values.
+unsigned simulate(const std::string& bench,
+                  const std::string& trace_file,
+                  const std::string& config_file) {
+  ScratchpadDatapath* acc =
+      new ScratchpadDatapath(bench, trace_file, config_file);
+  unsigned num_with_values = 0;
+  bool first = true;
+  while (acc->buildDddg()) {
+    if (first) {
+      for (auto& node_it : acc->getProgram().nodes) {
+        ExecNode* node = node_it.second;
+        if (node->is_memory_op() &&
+            !dynamic_cast<TimingMemAccess*>(node->get_mem_access()))
+          num_with_values++;
+      }
+      first = false;
+    }
+    acc->globalOptimizationPass();
+    acc->prepareForScheduling();
+    while (!acc->step()) {}
+    acc->dumpStats();
+    acc->clearDatapath();
+  }
+  delete acc;
+  return num_with_values;
+}
+
+SCENARIO("Test simulating traces without their data values",
+         "[timing_only]") {
+  struct Case {
+    std::string bench;
+    std::string trace_file;
+    std::string config_file;
+  };
+  std::vector<Case> cases = {
+    { "triad", "inputs/triad-128-trace.gz", "inputs/config-triad-p2-u2-P1" },
+    { "aes", "inputs/aes-aes-trace.gz", "inputs/config-aes-aes" },
+    { "store_buffer", "inputs/store_buffer.gz", "inputs/config-store-buffer" },
+    { "loop_sampling", "inputs/loop-sampling-multiple-invoc-trace.gz",
+      "inputs/config-loop-sampling" },
+  };
+  for (auto& test : cases) {
+    GIVEN("The " + test.bench + " trace") {
+      std::string full_bench = "outputs/" + test.bench + "-with-values";
+      std::string timing_bench = "outputs/" + test.bench + "-timing-only";
+      unsigned full_values =
+          simulate(full_bench, test.trace_file, test.config_file);
+      unsigned timing_values = simulate(
+          timing_bench, test.trace_file, withTimingOnly(test.config_file));
+      THEN("No memory node keeps its value in timing only mode.") {
+        REQUIRE(full_values > 0);
+        REQUIRE(timing_values == 0);
+      }
+      THEN("The cycles and power are the same as with the values.") {
+        std::string summary = readTimingSummary(full_bench);
+        REQUIRE(!summary.empty());
+        REQUIRE(readTimingSummary(timing_bench) == summary);
+      }
+    }
+  }
+  GIVEN("A vector value") {
+    char hex[] = "0x000102030405060708090a0b0c0d0e0f";
+    WHEN("It is parsed in timing only mode.") {
+      Value value(hex, 128, false, false);
+      THEN("Only its size is recorded.") {
+        REQUIRE(value.getType() == Value::Vector);
+        REQUIRE(value.getSize() == 16);
+        REQUIRE(value.getVector() == nullptr);
+      }
+    }
+  }
+  GIVEN("A scratchpad in timing only mode") {
+    Scratchpad spad(1, 1, true, true);
+    spad.setScratchpad("array", 0x1000, cyclic, 2, 64, 4);
+    WHEN("Data is written to it.") {
+      std::vector<uint32_t> words(16, 0xdeadbeef);
+      spad.resetReadyBits("array");
+      spad.writeData(
+          "array", 0x1000, reinterpret_cast<uint8_t*>(words.data()), 64);
+      THEN("The words become ready, but read back as zeros.") {
+        for (Addr addr = 0x1000; addr < 0x1040; addr += 4) {
+          unsigned part = spad.getPartitionIndex("array", addr);
+          REQUIRE(spad.canServicePartition("array", part, addr, true));
+        }
+        std::vector<uint32_t> read(16, 1);
+        spad.readData(
+            "array", 0x1000, 64, reinterpret_cast<uint8_t*>(read.data()));
+        for (uint32_t word : read)
+          REQUIRE(word == 0);
+      }
+    }
+  }
+}
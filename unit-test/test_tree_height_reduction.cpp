@@ -15,8 +15,7 @@ SCENARIO("Test treeHeightReduction w/ Reduction", "[reduction]") {
     acc = new ScratchpadDatapath(bench, trace_file, config_file);
     auto& prog = acc->getProgram();
     acc->buildDddg();
-    acc->removeInductionDependence();
-    acc->removePhiNodes();
+    acc->removeDeadNodes();
     acc->initBaseAddress();
     acc->scratchpadPartition();
     acc->loopUnrolling();